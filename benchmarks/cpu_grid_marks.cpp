@@ -0,0 +1,69 @@
+// cpu_grid_marks.cpp
+// Compare point-by-point and grid mode latlong->tmerc
+
+#include "transform.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+template<typename Callable>
+void time_this(const std::string& name, Callable c) {
+	using transform::util::timeit;
+
+	c(); // warmup
+	c(); // warmup
+	long long ms = timeit(c);
+
+	std::cout << name << " : " << ms << "ms" << std::endl;
+}
+
+int main() {
+	const size_t cols = 8192, rows = 4096;
+
+	std::cout << "Maximum concurrency: " <<
+		transform::utility::scheduler<>::concurrency() << std::endl;
+	std::cout << "Grid: " << cols << "x" << rows << std::endl;
+	std::cout << "Preping data..." << std::endl;
+
+	std::vector<double> lon(cols), lat(rows);
+	for (size_t c = 0 ; c < cols ; c ++)
+		lon.at(c) = -45.0 + 90.0 * c / cols;
+	for (size_t r = 0 ; r < rows ; r ++)
+		lat.at(r) = 80.0 - 160.0 * r / rows;
+
+	std::vector<double> x(cols * rows), y(cols * rows);
+	for (size_t r = 0 ; r < rows ; r ++) {
+		for (size_t c = 0 ; c < cols ; c ++) {
+			x.at(r * cols + c) = lon.at(c);
+			y.at(r * cols + c) = lat.at(r);
+		}
+	}
+
+	std::vector<double> out_x(cols * rows), out_y(cols * rows);
+
+	using namespace transform::backends;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	transform::transformer<full_concurrency_multi_cpu> mcpu;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	projection_to;
+
+	projection<projection_from, projection_to> p(
+			projection_from(),
+			projection_to(projection_to::offset_t(0.0, 0.0)));
+
+	std::cout << "Running tests..." << std::endl;
+
+	time_this("mcpu points", [&]() {
+		mcpu.run(p, x, y, out_x, out_y);
+	});
+
+	time_this("mcpu grid  ", [&]() {
+		mcpu.run_grid(p, lon, lat, out_x, out_y);
+	});
+
+	return 0;
+}
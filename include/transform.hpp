@@ -6,17 +6,74 @@
 
 #include "transform/backends/multi_cpu.hpp"
 #include "transform/backends/opencl.hpp"
+#include "transform/backends/multi_opencl.hpp"
 
 #if HAVE_PROJ4
 #include "transform/backends/proj.hpp"
 #endif
 
 #include "transform/transforms/basic.hpp"
+#include "transform/transforms/composite.hpp"
+#include "transform/transforms/polynomial.hpp"
+#include "transform/transforms/thin_plate_spline.hpp"
 #include "transform/transforms/cartographic.hpp"
+#include "transform/transforms/datum.hpp"
+#include "transform/transforms/grid_shift.hpp"
 #include "transform/utility.hpp"
+#include "transform/span.hpp"
+#include "transform/approximate.hpp"
+#include "transform/accuracy.hpp"
+#include "transform/warp.hpp"
+#include "transform/utm.hpp"
+
+#include <boost/range.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 namespace transform {
+	namespace detail {
+		// backends without native grid support get the grid expanded into point arrays
+		template<
+			typename TBackend,
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void run_grid(TBackend& b, const TTransform& transform,
+				const ForwardIterableInputRange& lon_axis, const ForwardIterableInputRange& lat_axis,
+				ForwardIterableOutputRange& xOut, ForwardIterableOutputRange& yOut) {
+			typedef typename boost::range_value<ForwardIterableInputRange>::type value_type;
+
+			size_t cols = boost::size(lon_axis), rows = boost::size(lat_axis);
+			std::vector<value_type> x(rows * cols), y(rows * cols);
+
+			auto px = x.begin(), py = y.begin();
+			for (auto lat = boost::begin(lat_axis) ; lat != boost::end(lat_axis) ; ++lat) {
+				for (auto lon = boost::begin(lon_axis) ; lon != boost::end(lon_axis) ; ++lon) {
+					*px++ = *lon;
+					*py++ = *lat;
+				}
+			}
+
+			b.run(transform, x, y, xOut, yOut);
+		}
+
+		template<
+			unsigned MaxConcurrency,
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void run_grid(backends::multi_cpu<MaxConcurrency>& b, const TTransform& transform,
+				const ForwardIterableInputRange& lon_axis, const ForwardIterableInputRange& lat_axis,
+				ForwardIterableOutputRange& xOut, ForwardIterableOutputRange& yOut) {
+			b.run_grid(transform, lon_axis, lat_axis, xOut, yOut);
+		}
+	}
+
 	template<
 		typename TBackend
 	>
@@ -24,6 +81,19 @@ namespace transform {
 		public:
 		transformer(): b_() { }
 
+		// arguments go to the backend's constructor, e.g. opencl_options
+		template<
+			typename TArg,
+			typename... TArgs,
+			typename = typename std::enable_if<
+				!std::is_same<typename std::decay<TArg>::type, transformer>::value>::type
+		>
+		explicit transformer(TArg&& arg, TArgs&&... args):
+			b_(std::forward<TArg>(arg), std::forward<TArgs>(args)...) { }
+
+		TBackend& backend() { return b_; }
+		const TBackend& backend() const { return b_; }
+
 		template<
 			typename TTransform,
 			typename ForwardIterableInputRange,
@@ -35,6 +105,61 @@ namespace transform {
 			b_.run(transform, x, y, xOut, yOut);
 		}
 
+		// 3D version of the above, z is usually a height in meters.  Transforms which only
+		// work in 2D pass z through unchanged.
+		template<
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void run(const TTransform& transform,
+				const ForwardIterableInputRange& x, const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& xOut, ForwardIterableOutputRange& yOut,
+				ForwardIterableOutputRange& zOut) {
+			b_.run(transform, x, y, z, xOut, yOut, zOut);
+		}
+
+		// pointer and length versions of the above, e.g. for buffers from C APIs
+		template<
+			typename TTransform,
+			typename TValue,
+			typename TOutput
+		>
+		void run(const TTransform& transform, const TValue *x, const TValue *y, size_t count,
+				TOutput *xOut, TOutput *yOut) {
+			span<const TValue> sx(x, count), sy(y, count);
+			span<TOutput> ox(xOut, count), oy(yOut, count);
+
+			b_.run(transform, sx, sy, ox, oy);
+		}
+
+		template<
+			typename TTransform,
+			typename TValue,
+			typename TOutput
+		>
+		void run(const TTransform& transform, const TValue *x, const TValue *y, const TValue *z,
+				size_t count, TOutput *xOut, TOutput *yOut, TOutput *zOut) {
+			span<const TValue> sx(x, count), sy(y, count), sz(z, count);
+			span<TOutput> ox(xOut, count), oy(yOut, count), oz(zOut, count);
+
+			b_.run(transform, sx, sy, sz, ox, oy, oz);
+		}
+
+		// transform a regular grid made of every (lon_axis[c], lat_axis[r]) pair, output is
+		// row major with lat_axis.size() rows of lon_axis.size() columns
+		template<
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void run_grid(const TTransform& transform,
+				const ForwardIterableInputRange& lon_axis, const ForwardIterableInputRange& lat_axis,
+				ForwardIterableOutputRange& xOut, ForwardIterableOutputRange& yOut) {
+			detail::run_grid(b_, transform, lon_axis, lat_axis, xOut, yOut);
+		}
+
 		private:
 		TBackend b_;
 	};
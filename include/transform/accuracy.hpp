@@ -0,0 +1,99 @@
+// accuracy.hpp
+// Measuring a backend's results against the CPU backend
+//
+
+#ifndef __transform_accuracy_hpp__
+#define __transform_accuracy_hpp__
+
+#include "backends/multi_cpu.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace transform {
+	struct accuracy_report {
+		// points compared, points the CPU can't transform (infinite or NaN) are skipped
+		size_t points;
+
+		// largest and root mean square error along any axis, in output units
+		double max_error;
+		double rms_error;
+
+		// largest error in units in the last place of the CPU result
+		double max_ulps;
+
+		// points the CPU can't transform which the backend gave a finite result for, e.g.
+		// a fast math device dropping the HUGE_VAL outside a projection's domain
+		size_t mask_mismatches;
+	};
+
+	namespace detail {
+		inline double ulps(double expected, double actual) {
+			if (!std::isfinite(actual))
+				return std::numeric_limits<double>::infinity();
+
+			double e = std::fabs(expected);
+			double ulp = std::nextafter(e, std::numeric_limits<double>::infinity()) - e;
+
+			return std::fabs(actual - expected) / ulp;
+		}
+	}
+
+	// run t over x, y on backend b and on the double precision CPU backend and compare,
+	// e.g. to see what an opencl_precision costs on a device.  A backend result which
+	// isn't finite where the CPU one is counts as an infinite error, a finite one where
+	// the CPU's isn't as a mask mismatch.
+	template<
+		typename TBackend,
+		typename TTransform,
+		typename ForwardIterableInputRange
+	>
+	accuracy_report measure_accuracy(const TBackend& b, const TTransform& t,
+			const ForwardIterableInputRange& x, const ForwardIterableInputRange& y) {
+		size_t n = boost::size(x);
+		assert(n == boost::size(y));
+
+		std::vector<double> ex(n), ey(n), ox(n), oy(n);
+
+		backends::cpu c;
+		c.run(t, x, y, ex, ey);
+		b.run(t, x, y, ox, oy);
+
+		accuracy_report r = { 0, 0., 0., 0., 0 };
+		double sum = 0.;
+
+		for (size_t i = 0 ; i < n ; i ++) {
+			if (!std::isfinite(ex[i]) || !std::isfinite(ey[i])) {
+				if ((!std::isfinite(ex[i]) && std::isfinite(ox[i])) ||
+						(!std::isfinite(ey[i]) && std::isfinite(oy[i])))
+					r.mask_mismatches ++;
+
+				continue;
+			}
+
+			const double expected[2] = { ex[i], ey[i] }, actual[2] = { ox[i], oy[i] };
+			for (int k = 0 ; k < 2 ; k ++) {
+				double e = std::isfinite(actual[k]) ?
+					std::fabs(actual[k] - expected[k]) : std::numeric_limits<double>::infinity();
+
+				r.max_error = std::max(r.max_error, e);
+				r.max_ulps = std::max(r.max_ulps, detail::ulps(expected[k], actual[k]));
+				sum += e * e;
+			}
+
+			r.points ++;
+		}
+
+		if (r.points > 0)
+			r.rms_error = std::sqrt(sum / (2 * r.points));
+
+		return r;
+	}
+}
+
+#endif // __transform_accuracy_hpp__
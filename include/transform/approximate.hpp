@@ -0,0 +1,171 @@
+// approximate.hpp
+// Approximate transformer, trades a bounded error for far fewer exact transforms
+//
+
+#ifndef __transform_approximate_hpp__
+#define __transform_approximate_hpp__
+
+#include <boost/range.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace transform {
+	// approximate_transformer wraps a backend and only runs the exact transform at a few
+	// points of each input row (end points and midpoints), linearly interpolating everything
+	// in between.  If the interpolated midpoint of a span differs from the exact one by more
+	// than max_error (|dx| + |dy|, in output units) the span is split in two and both halves
+	// are refined the same way.
+	//
+	// Input is expected to be laid out row by row with every row sampling a straight line at
+	// even steps, e.g. pixel centres of a raster.  All spans at the same level of refinement
+	// are batched into a single backend run, so multi-threaded and OpenCL backends still get
+	// reasonably sized work.
+	//
+	template<typename TBackend>
+	class approximate_transformer {
+		public:
+		approximate_transformer(double max_error):
+			b_(), max_error_(max_error), exact_points_(0) { }
+
+		template<
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void run(const TTransform& transform,
+				const ForwardIterableInputRange& x, const ForwardIterableInputRange& y,
+				ForwardIterableOutputRange& xOut, ForwardIterableOutputRange& yOut,
+				size_t row_length = 0) {
+			typedef typename boost::range_iterator<ForwardIterableOutputRange>::type iterator;
+			typedef typename boost::range_const_iterator<ForwardIterableInputRange>::type const_iterator;
+
+			size_t size = boost::size(x);
+
+			assert(size == boost::size(y));
+			assert(size == boost::size(xOut));
+			assert(boost::size(xOut) == boost::size(yOut));
+
+			exact_points_ = 0;
+			if (size == 0)
+				return;
+
+			// a zero row length means the whole input is a single row
+			if (row_length == 0 || row_length > size)
+				row_length = size;
+
+			const_iterator xb = boost::begin(x), yb = boost::begin(y);
+			iterator ox = boost::begin(xOut), oy = boost::begin(yOut);
+
+			std::vector<span> pending, next;
+			for (size_t s = 0 ; s < size ; s += row_length)
+				pending.push_back(span(s, std::min(s + row_length, size) - 1));
+
+			std::vector<char> exact(size, 0);
+
+			std::vector<size_t> index;
+			std::vector<double> sx, sy, sox, soy;
+
+			while (!pending.empty()) {
+				// gather all the points this level needs exactly
+				//
+				index.clear();
+				for (const span& s : pending) {
+					request(exact, index, s.first);
+					request(exact, index, s.last);
+					if (s.last - s.first > 1)
+						request(exact, index, s.middle());
+				}
+
+				size_t count = index.size();
+
+				sx.resize(count); sy.resize(count);
+				sox.resize(count); soy.resize(count);
+
+				for (size_t i = 0 ; i < count ; i ++) {
+					sx[i] = xb[index[i]];
+					sy[i] = yb[index[i]];
+				}
+
+				if (count > 0)
+					b_.run(transform, sx, sy, sox, soy);
+
+				for (size_t i = 0 ; i < count ; i ++) {
+					ox[index[i]] = sox[i];
+					oy[index[i]] = soy[i];
+				}
+
+				exact_points_ += count;
+
+				// decide which spans are good enough to interpolate, split the rest
+				//
+				next.clear();
+				for (const span& s : pending) {
+					if (s.last - s.first <= 1)
+						continue;
+
+					size_t m = s.middle();
+					double t = static_cast<double>(m - s.first) / (s.last - s.first);
+
+					double x0 = ox[s.first], y0 = oy[s.first],
+						   x1 = ox[s.last], y1 = oy[s.last];
+					double xm = ox[m], ym = oy[m];
+
+					double err = std::abs(x0 + (x1 - x0) * t - xm) +
+						std::abs(y0 + (y1 - y0) * t - ym);
+
+					// err is NaN if any of the exact points could not be projected, which
+					// should never be interpolated across
+					if (err <= max_error_) {
+						double scale = 1.0 / (s.last - s.first);
+						for (size_t i = s.first + 1 ; i < s.last ; i ++) {
+							if (exact[i])
+								continue;
+
+							double f = (i - s.first) * scale;
+							ox[i] = x0 + (x1 - x0) * f;
+							oy[i] = y0 + (y1 - y0) * f;
+						}
+					}
+					else {
+						next.push_back(span(s.first, m));
+						next.push_back(span(m, s.last));
+					}
+				}
+
+				pending.swap(next);
+			}
+		}
+
+		// number of points transformed exactly during the last run
+		size_t exact_points() const { return exact_points_; }
+
+		double max_error() const { return max_error_; }
+
+		// the wrapped backend, for callers who need exact results from the same instance
+		TBackend& backend() { return b_; }
+
+		private:
+		struct span {
+			size_t first, last;
+
+			span(size_t f, size_t l): first(f), last(l) { }
+			size_t middle() const { return first + (last - first) / 2; }
+		};
+
+		static void request(std::vector<char>& exact, std::vector<size_t>& index, size_t i) {
+			if (!exact[i]) {
+				exact[i] = 1;
+				index.push_back(i);
+			}
+		}
+
+		TBackend b_;
+		double max_error_;
+		size_t exact_points_;
+	};
+}
+
+#endif // __transform_approximate_hpp__
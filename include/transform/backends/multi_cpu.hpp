@@ -9,12 +9,123 @@
 #include <boost/range.hpp>
 
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 #include "../concurrency.hpp"
+#include "../cpu_op.hpp"
+#include "../span.hpp"
 
 namespace transform {
 	namespace backends {
+		namespace detail {
+			// contiguous ranges go straight to the batch kernels
+			template<
+				typename TTransform,
+				typename ConstIterator,
+				typename Iterator
+			>
+			void compute_chunk(const TTransform& p, ConstIterator sx, ConstIterator ex,
+					ConstIterator sy, Iterator ox, Iterator oy, std::true_type) {
+				size_t count = ex - sx;
+				if (count > 0)
+					do_batch_op(p, &(*sx), &(*sy), &(*ox), &(*oy), count);
+			}
+
+			// anything else is copied through scratch buffers of at most staging_points
+			template<
+				typename TTransform,
+				typename ConstIterator,
+				typename Iterator
+			>
+			void compute_chunk(const TTransform& p, ConstIterator sx, ConstIterator ex,
+					ConstIterator sy, Iterator ox, Iterator oy, std::false_type) {
+				typedef typename std::iterator_traits<ConstIterator>::value_type value_type;
+				typedef typename std::iterator_traits<Iterator>::value_type output_type;
+
+				size_t block = std::min<size_t>(ex - sx, staging_points);
+				if (block == 0)
+					return;
+
+				std::vector<value_type> x(block), y(block);
+				std::vector<output_type> bx(block), by(block);
+
+				while (sx != ex) {
+					size_t count = std::min<size_t>(ex - sx, block);
+
+					std::copy(sx, sx + count, x.begin());
+					std::copy(sy, sy + count, y.begin());
+
+					do_batch_op(p, &x[0], &y[0], &bx[0], &by[0], count);
+
+					ox = std::copy(bx.begin(), bx.begin() + count, ox);
+					oy = std::copy(by.begin(), by.begin() + count, oy);
+
+					sx += count;
+					sy += count;
+				}
+			}
+
+			template<
+				typename TTransform,
+				typename ConstIterator,
+				typename Iterator
+			>
+			void compute_chunk(const TTransform& p, ConstIterator sx, ConstIterator ex,
+					ConstIterator sy, ConstIterator sz, Iterator ox, Iterator oy, Iterator oz,
+					std::true_type) {
+				size_t count = ex - sx;
+				if (count > 0)
+					do_batch_op3(p, &(*sx), &(*sy), &(*sz), &(*ox), &(*oy), &(*oz), count);
+			}
+
+			template<
+				typename TTransform,
+				typename ConstIterator,
+				typename Iterator
+			>
+			void compute_chunk(const TTransform& p, ConstIterator sx, ConstIterator ex,
+					ConstIterator sy, ConstIterator sz, Iterator ox, Iterator oy, Iterator oz,
+					std::false_type) {
+				typedef typename std::iterator_traits<ConstIterator>::value_type value_type;
+				typedef typename std::iterator_traits<Iterator>::value_type output_type;
+
+				size_t block = std::min<size_t>(ex - sx, staging_points);
+				if (block == 0)
+					return;
+
+				std::vector<value_type> x(block), y(block), z(block);
+				std::vector<output_type> bx(block), by(block), bz(block);
+
+				while (sx != ex) {
+					size_t count = std::min<size_t>(ex - sx, block);
+
+					std::copy(sx, sx + count, x.begin());
+					std::copy(sy, sy + count, y.begin());
+					std::copy(sz, sz + count, z.begin());
+
+					do_batch_op3(p, &x[0], &y[0], &z[0], &bx[0], &by[0], &bz[0], count);
+
+					ox = std::copy(bx.begin(), bx.begin() + count, ox);
+					oy = std::copy(by.begin(), by.begin() + count, oy);
+					oz = std::copy(bz.begin(), bz.begin() + count, oz);
+
+					sx += count;
+					sy += count;
+					sz += count;
+				}
+			}
+
+			template<
+				typename ConstIterator,
+				typename Iterator
+			>
+			struct contiguous_chunks : std::integral_constant<bool,
+				is_contiguous_iterator<ConstIterator>::value &&
+				is_contiguous_iterator<Iterator>::value> { };
+		}
+
 		template<unsigned MaxConcurrency = 0>
 		struct multi_cpu {
 			template<
@@ -33,9 +144,8 @@ namespace transform {
 				auto compute = 
 					[&p](const_iterator sx, const_iterator ex, const_iterator sy,
 							const_iterator ey, iterator ox, iterator oy) {
-					for ( ; sx != ex ; ++sx, ++sy) {
-						p.op(*sx, *sy, *ox++, *oy++);
-					}
+					detail::compute_chunk(p, sx, ex, sy, ox, oy,
+							detail::contiguous_chunks<const_iterator, iterator>());
 				};
 
 				typename boost::range_difference<ForwardIterableInputRange>::type 
@@ -59,18 +169,165 @@ namespace transform {
 
 
 				for (unsigned i = 0 ; i < max_threads ; i ++) {
-					const_iterator xe = xb + per_batch, ye = yb + per_batch;
+					// last batch picks up whatever is left over from the division
+					size_t count = (i == max_threads - 1) ? sx - per_batch * i : per_batch;
+					const_iterator xe = xb + count, ye = yb + count;
 
 					c.queue(compute, xb, xe, yb, ye, ox, oy);
 
-					xb += per_batch;
-					yb += per_batch;
-					ox += per_batch;
-					oy += per_batch;
+					xb += count;
+					yb += count;
+					ox += count;
+					oy += count;
+				}
+
+				c.wait();
+			}
+
+			// same as above with a z coordinate, 2D transforms copy z through unchanged
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run(const TTransform& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& xOut,
+				ForwardIterableOutputRange& yOut,
+				ForwardIterableOutputRange& zOut) const {
+				typedef typename boost::range_iterator<ForwardIterableOutputRange>::type iterator;
+				typedef typename boost::range_const_iterator<ForwardIterableInputRange>::type const_iterator;
+
+				auto compute =
+					[&p](const_iterator sx, const_iterator ex, const_iterator sy,
+							const_iterator sz, iterator ox, iterator oy, iterator oz) {
+					detail::compute_chunk(p, sx, ex, sy, sz, ox, oy, oz,
+							detail::contiguous_chunks<const_iterator, iterator>());
+				};
+
+				size_t size = boost::size(x);
+
+				assert(size == (size_t)boost::size(y));
+				assert(size == (size_t)boost::size(z));
+				assert(size == (size_t)boost::size(xOut));
+				assert(boost::size(xOut) == boost::size(yOut));
+				assert(boost::size(xOut) == boost::size(zOut));
+
+				const_iterator xb = boost::begin(x),
+							   yb = boost::begin(y),
+							   zb = boost::begin(z);
+
+				iterator ox = boost::begin(xOut),
+						 oy = boost::begin(yOut),
+						 oz = boost::begin(zOut);
+
+				utility::scheduler<MaxConcurrency> c;
+				unsigned max_threads = c.concurrency();
+				size_t per_batch = size / max_threads;
+
+				for (unsigned i = 0 ; i < max_threads ; i ++) {
+					size_t count = (i == max_threads - 1) ? size - per_batch * i : per_batch;
+
+					c.queue(compute, xb, xb + count, yb, zb, ox, oy, oz);
+
+					xb += count; yb += count; zb += count;
+					ox += count; oy += count; oz += count;
+				}
+
+				c.wait();
+			}
+
+			// transform the grid formed by every (lon, lat) pair, rows of the grid are split
+			// among threads and each slice goes through do_grid_op
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run_grid(const TTransform& p,
+				const ForwardIterableInputRange& lon_axis,
+				const ForwardIterableInputRange& lat_axis,
+				ForwardIterableOutputRange& xOut,
+				ForwardIterableOutputRange& yOut) const {
+				typedef typename boost::range_value<ForwardIterableInputRange>::type value_type;
+
+				// axes are tiny compared to the grid, keep a contiguous copy
+				std::vector<value_type>
+					lon(boost::begin(lon_axis), boost::end(lon_axis)),
+					lat(boost::begin(lat_axis), boost::end(lat_axis));
+
+				size_t cols = lon.size(), rows = lat.size();
+
+				assert(rows * cols == (size_t)boost::size(xOut));
+				assert(boost::size(xOut) == boost::size(yOut));
+
+				if (rows == 0 || cols == 0)
+					return;
+
+				typedef typename boost::range_iterator<ForwardIterableOutputRange>::type iterator;
+
+				iterator ox = boost::begin(xOut), oy = boost::begin(yOut);
+
+				auto compute = [&p, &lon, &lat, cols, ox, oy](size_t first, size_t count) {
+					grid_rows(p, lon, lat, first, count, ox + first * cols, oy + first * cols,
+							is_contiguous_iterator<iterator>());
+				};
+
+				utility::scheduler<MaxConcurrency> c;
+				unsigned max_threads = c.concurrency();
+				size_t per_batch = rows / max_threads;
+
+				size_t first = 0;
+				for (unsigned i = 0 ; i < max_threads ; i ++) {
+					size_t count = (i == max_threads - 1) ? rows - first : per_batch;
+
+					c.queue(compute, first, count);
+					first += count;
 				}
 
 				c.wait();
 			}
+
+		private:
+			template<
+				typename TTransform,
+				typename TValue,
+				typename Iterator
+			>
+			static void grid_rows(const TTransform& p,
+				const std::vector<TValue>& lon, const std::vector<TValue>& lat,
+				size_t first, size_t count, Iterator ox, Iterator oy, std::true_type) {
+				do_grid_op(p, &lon[0], lon.size(), &lat[first], count, &(*ox), &(*oy));
+			}
+
+			// outputs which aren't contiguous get as many whole rows at a time as fit in
+			// staging_points, or one
+			template<
+				typename TTransform,
+				typename TValue,
+				typename Iterator
+			>
+			static void grid_rows(const TTransform& p,
+				const std::vector<TValue>& lon, const std::vector<TValue>& lat,
+				size_t first, size_t count, Iterator ox, Iterator oy, std::false_type) {
+				typedef typename std::iterator_traits<Iterator>::value_type output_type;
+
+				size_t cols = lon.size();
+				size_t rows = std::max<size_t>(1, std::min(count, detail::staging_points / cols));
+
+				std::vector<output_type> bx(rows * cols), by(rows * cols);
+
+				for (size_t r = first, end = first + count ; r < end ; r += rows) {
+					size_t n = std::min(rows, end - r);
+
+					do_grid_op(p, &lon[0], cols, &lat[r], n, &bx[0], &by[0]);
+
+					ox = std::copy(bx.begin(), bx.begin() + n * cols, ox);
+					oy = std::copy(by.begin(), by.begin() + n * cols, oy);
+				}
+			}
 		};
 
 		typedef multi_cpu<0> full_concurrency_multi_cpu;
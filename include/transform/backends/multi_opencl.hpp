@@ -0,0 +1,290 @@
+// multi_opencl.hpp
+// OpenCL backend sharding each batch across every device
+//
+
+#ifndef __transform_backends_multi_opencl_hpp__
+#define __transform_backends_multi_opencl_hpp__
+
+#include "opencl.hpp"
+#include "../concurrency.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace transform {
+	namespace backends {
+		namespace detail {
+			// split count points among devices in proportion to their throughput (points per
+			// second, 0 when not measured yet).  Devices which haven't been measured are
+			// assumed to be as fast as the average measured one.  Batches too small to give
+			// every device min_shard points only go to the fastest ones.
+			inline std::vector<size_t> shard_sizes(const std::vector<double>& throughput,
+					size_t count, size_t min_shard) {
+				size_t n = throughput.size();
+				std::vector<size_t> sizes(n, 0);
+
+				if (n == 0 || count == 0)
+					return sizes;
+
+				double known = 0.;
+				size_t measured = 0;
+				for (double t : throughput) {
+					if (t > 0.) {
+						known += t;
+						measured ++;
+					}
+				}
+
+				std::vector<double> rate(n);
+				for (size_t i = 0 ; i < n ; i ++)
+					rate[i] = (throughput[i] > 0.) ? throughput[i] :
+						(measured > 0 ? known / measured : 1.);
+
+				// fastest first, ties go to the earlier device
+				std::vector<size_t> order(n);
+				for (size_t i = 0 ; i < n ; i ++)
+					order[i] = i;
+
+				std::stable_sort(order.begin(), order.end(),
+						[&rate](size_t a, size_t b) { return rate[a] > rate[b]; });
+
+				size_t used = std::max<size_t>(1, std::min(n, count / std::max<size_t>(1, min_shard)));
+
+				double total = 0.;
+				for (size_t i = 0 ; i < used ; i ++)
+					total += rate[order[i]];
+
+				// the fastest device picks up what rounding leaves over
+				size_t assigned = 0;
+				for (size_t i = 1 ; i < used ; i ++) {
+					size_t s = static_cast<size_t>(count * rate[order[i]] / total + 0.5);
+					s = std::min(s, count - assigned);
+
+					sizes[order[i]] = s;
+					assigned += s;
+				}
+
+				sizes[order[0]] = count - assigned;
+				return sizes;
+			}
+		}
+
+		// one opencl backend per device of TDeviceType's type on every platform, devices
+		// without double precision are skipped.  Each run is split among the devices in
+		// proportion to the throughput they showed on earlier runs of the same transform
+		// (evenly on the first one) and the shards run concurrently.
+		//
+		template<
+			typename TDeviceType = any_device
+		>
+		struct multi_opencl {
+			// batches are only split where every device gets at least this many points
+			static const size_t min_shard = 16384;
+
+			// every device's backend is made with options
+			explicit multi_opencl(const opencl_options& options = opencl_options()) {
+				cl_uint platform_count = 0;
+				if (clGetPlatformIDs(0, NULL, &platform_count) != CL_SUCCESS)
+					platform_count = 0;
+
+				std::vector<cl_platform_id> platforms(platform_count);
+				if (platform_count > 0)
+					clGetPlatformIDs(platform_count, &platforms[0], NULL);
+
+				for (cl_platform_id platform : platforms) {
+					cl_uint device_count = 0;
+					if (clGetDeviceIDs(platform, TDeviceType::device_type, 0, NULL, &device_count) != CL_SUCCESS ||
+							device_count == 0)
+						continue;
+
+					std::vector<cl_device_id> ids(device_count);
+					clGetDeviceIDs(platform, TDeviceType::device_type, device_count, &ids[0], NULL);
+
+					for (cl_device_id id : ids) {
+						if (!opencl<TDeviceType>::supports_double_precision(id))
+							continue;
+
+						devices_.push_back(std::unique_ptr<opencl<TDeviceType>>(new opencl<TDeviceType>(id, options)));
+					}
+				}
+
+				if (devices_.empty())
+					throw std::runtime_error("Failed to find any OpenCL devices with double precision");
+			}
+
+			size_t device_count() const { return devices_.size(); }
+
+			const opencl<TDeviceType>& device(size_t i) const { return *devices_.at(i); }
+
+			// build TTransforms' programs on every device, see opencl::warm_up
+			template<typename... TTransforms>
+			void warm_up() const {
+				for (const auto& d : devices_)
+					d->template warm_up<TTransforms...>();
+			}
+
+			// run stats of every device's shards, see opencl::take_run_stats
+			std::vector<opencl_run_stats> take_run_stats() const {
+				std::vector<opencl_run_stats> taken;
+				for (const auto& d : devices_) {
+					std::vector<opencl_run_stats> s = d->take_run_stats();
+					taken.insert(taken.end(), s.begin(), s.end());
+				}
+
+				return taken;
+			}
+
+			// points per second each device managed on recent runs of TTransform, 0 until
+			// measured
+			template<typename TTransform>
+			std::vector<double> throughput() const {
+				std::lock_guard<std::mutex> lock(mutex_);
+
+				auto i = throughput_.find(std::type_index(typeid(TTransform)));
+				return (i != throughput_.end()) ? i->second : std::vector<double>(devices_.size(), 0.);
+			}
+
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run(const TTransform& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y) const {
+				assert(boost::size(x) == boost::size(y));
+				assert(boost::size(out_x) == boost::size(x));
+				assert(boost::size(out_x) == boost::size(out_y));
+
+				shard<TTransform>(boost::size(x), [&](const opencl<TDeviceType>& d, size_t first, size_t count) {
+					auto sx = slice(x, first, count), sy = slice(y, first, count);
+					auto ox = slice(out_x, first, count), oy = slice(out_y, first, count);
+
+					d.run(p, sx, sy, ox, oy);
+				});
+			}
+
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run(const TTransform& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y,
+				ForwardIterableOutputRange& out_z) const {
+				assert(boost::size(x) == boost::size(y));
+				assert(boost::size(x) == boost::size(z));
+				assert(boost::size(out_x) == boost::size(x));
+				assert(boost::size(out_x) == boost::size(out_y));
+				assert(boost::size(out_x) == boost::size(out_z));
+
+				shard<TTransform>(boost::size(x), [&](const opencl<TDeviceType>& d, size_t first, size_t count) {
+					auto sx = slice(x, first, count), sy = slice(y, first, count), sz = slice(z, first, count);
+					auto ox = slice(out_x, first, count), oy = slice(out_y, first, count),
+						 oz = slice(out_z, first, count);
+
+					d.run(p, sx, sy, sz, ox, oy, oz);
+				});
+			}
+
+		private:
+			template<typename TRange>
+			static boost::iterator_range<typename boost::range_iterator<TRange>::type>
+			slice(TRange& r, size_t first, size_t count) {
+				auto b = boost::begin(r) + first;
+				return boost::make_iterator_range(b, b + count);
+			}
+
+			// run f(device, first, count) for every device's shard on a thread of its own,
+			// timing each shard to weigh the next split of TTransform.  Shards which built or
+			// tuned a kernel aren't timed, and the first exception any shard throws is
+			// rethrown once all of them are done.
+			template<typename TTransform, typename TFunction>
+			void shard(size_t size, TFunction f) const {
+				typedef std::chrono::high_resolution_clock clock;
+
+				const std::type_index key(typeid(TTransform));
+
+				std::vector<size_t> sizes;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+
+					std::vector<double>& measured = throughput_[key];
+					if (measured.empty())
+						measured.assign(devices_.size(), 0.);
+
+					sizes = detail::shard_sizes(measured, size, min_shard);
+				}
+
+				std::vector<double> seconds(devices_.size(), 0.);
+				std::vector<std::exception_ptr> errors(devices_.size());
+
+				auto compute = [&](size_t i, size_t first) {
+					try {
+						size_t setups = devices_[i]->setups();
+
+						clock::time_point start = clock::now();
+						f(*devices_[i], first, sizes[i]);
+
+						if (devices_[i]->setups() == setups)
+							seconds[i] = std::chrono::duration<double>(clock::now() - start).count();
+					}
+					catch(...) {
+						errors[i] = std::current_exception();
+					}
+				};
+
+				utility::scheduler<0> c;
+
+				size_t first = 0;
+				for (size_t i = 0 ; i < devices_.size() ; i ++) {
+					if (sizes[i] > 0)
+						c.queue(compute, i, first);
+					first += sizes[i];
+				}
+
+				c.wait();
+
+				for (const std::exception_ptr& e : errors)
+					if (e)
+						std::rethrow_exception(e);
+
+				// smoothed, so one slow run (e.g. the device was busy) doesn't swing the split
+				std::lock_guard<std::mutex> lock(mutex_);
+
+				std::vector<double>& measured = throughput_[key];
+				for (size_t i = 0 ; i < devices_.size() ; i ++) {
+					if (sizes[i] < min_shard || seconds[i] <= 0.)
+						continue;
+
+					double t = sizes[i] / seconds[i];
+					measured[i] = (measured[i] > 0.) ? 0.5 * (measured[i] + t) : t;
+				}
+			}
+
+			std::vector<std::unique_ptr<opencl<TDeviceType>>> devices_;
+
+			// per transform, different kernels run at different speeds on each device
+			mutable std::map<std::type_index, std::vector<double>> throughput_;
+			mutable std::mutex mutex_;
+		};
+	}
+}
+
+#endif // __transform_backends_multi_opencl_hpp__
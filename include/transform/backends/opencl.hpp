@@ -6,71 +6,179 @@
 #define __transform_backends_opencl_hpp__
 
 #include "../transforms/basic.hpp"
+#include "../transforms/composite.hpp"
+#include "../transforms/polynomial.hpp"
+#include "../transforms/thin_plate_spline.hpp"
 #include "../transforms/cartographic.hpp"
+#include "../transforms/datum.hpp"
+#include "../device.hpp"
+#include "../span.hpp"
+#include "opencl_stats.hpp"
 
 #include <OpenCL/opencl.h>
 
 #include <boost/range.hpp>
 
+#include <chrono>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <type_traits>
+#include <vector>
 
 namespace transform {
 	namespace backends {
+		// how a kernel is launched: the work-group size (0 leaves it to the OpenCL runtime)
+		// and how many points each work-item transforms.  Kernels stride through their
+		// points by the global size, so any combination covers every point.
+		struct kernel_tuning {
+			size_t local_size;
+			unsigned points_per_item;
+		};
+
+		// what the device compiler may trade for speed, see the README for measured errors
+		enum class opencl_precision {
+			strict,		// IEEE double throughout, the same results as the CPU backends
+			relaxed,	// -cl-mad-enable -cl-no-signed-zeros
+			fast,		// -cl-fast-relaxed-math, assumes no infinities or NaNs either
+			native		// fast, with sin and cos in single precision through native_sin/cos
+		};
+
+		// how an opencl backend is set up
+		struct opencl_options {
+			// make command queues with CL_QUEUE_PROFILING_ENABLE and record the device
+			// timestamps of every upload, kernel and download (see take_run_stats)
+			bool profiling;
+
+			// build options for every program
+			opencl_precision precision;
+
+			opencl_options() : profiling(false), precision(opencl_precision::strict) { }
+		};
+
 		namespace detail {
-			template<typename T>
-			struct kernel {
-				static std::pair<cl_program, cl_kernel> load_transform(cl_context ctx) {
-					static_assert(sizeof(T) == 0,
-							"You need to specialize load_transform for this type");
+			// queue kernel over count points, with enough work-items for the tuning and no
+			// more (the global size is rounded up to the work-group size).  evt, when not
+			// NULL, gets the kernel's event.
+			void enqueue_kernel(cl_command_queue queue, cl_kernel kernel, size_t count,
+					const kernel_tuning& t, cl_event *evt = NULL);
+
+			// time the configured kernel over count points with every work-group size the
+			// kernel allows out of 32 to 256 and 1 to 8 points per work-item, the fastest
+			// wins.  Outputs are rewritten by every trial.
+			kernel_tuning tune_kernel(cl_command_queue queue, cl_device_id dev, cl_kernel kernel,
+					size_t count);
+
+			std::string device_name(cl_device_id dev);
+
+			// wait for the events which aren't NULL
+			void wait_for_events(const cl_event *events, size_t count);
+
+			// buffers released on destruction, so a run which throws half way (e.g. when a
+			// lazy program build fails) doesn't leak what it had allocated
+			struct mem_guard {
+				cl_mem mems[6];
+				size_t count;
+
+				mem_guard() : count(0) { }
+				~mem_guard() {
+					for (size_t i = 0 ; i < count ; i ++)
+						clReleaseMemObject(mems[i]);
 				}
 
-				static void configure_transform(const T& t,
-						cl_kernel kernel,
-						cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t numelements) {
-					static_assert(sizeof(T) == 0,
-							"You need to specialize apply_to_transform for this type");
+				cl_mem hold(cl_mem m) {
+					assert(count < 6);
+					mems[count ++] = m;
+					return m;
 				}
-			};
 
-			template<typename TDeviceType, typename T>
-			struct opencl_kernel_wrapper {
-				static void load(cl_context ctx, cl_device_id dev) {
-					auto p = detail::kernel<T>::load_transform(ctx, dev);
+				mem_guard(const mem_guard&) = delete;
+				mem_guard& operator=(const mem_guard&) = delete;
+			};
 
-					program() = p.first;
-					kernel() = p.second;
+			// events released on destruction unless dismissed, for uploads which haven't
+			// been handed over to track yet
+			struct event_guard {
+				cl_event *events;
+				size_t count;
 
-					loaded() = true;
+				event_guard(cl_event *e, size_t n) : events(e), count(n) {
+					std::fill_n(events, count, static_cast<cl_event>(NULL));
+				}
+				~event_guard() {
+					for (size_t i = 0 ; i < count ; i ++)
+						if (events[i])
+							clReleaseEvent(events[i]);
 				}
 
-				static void configure(cl_context ctx, const T& t,
-						cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out,
-						size_t numelements) {
-					assert(loaded());
+				void dismiss() { count = 0; }
 
-					detail::kernel<T>::configure_transform(t, kernel(), x_in, y_in, x_out, y_out, numelements);
-				}
+				event_guard(const event_guard&) = delete;
+				event_guard& operator=(const event_guard&) = delete;
+			};
 
-				static void release() {
-					loaded() = false;
+			std::string build_options(opencl_precision precision);
 
-					clReleaseProgram(program());
-					clReleaseKernel(kernel());
-				}
+			// build the kernel for a device source (see device_op) and set its arguments,
+			// the constants struct is passed by value after the buffers and the count.  z
+			// buffers are NULL for 2D runs.
+			std::pair<cl_program, cl_kernel> load_device_program(cl_context ctx, cl_device_id dev,
+					const std::string& source, const char *function, const char *constants_name,
+					bool three_d, const std::string& options);
 
-				static cl_program& program() {
-					static cl_program p; return p;
+			void configure_device_program(cl_kernel kernel,
+					const void *constants, size_t constants_size,
+					cl_mem x_in, cl_mem y_in, const cl_mem *z_in,
+					cl_mem x_out, cl_mem y_out, const cl_mem *z_out, size_t num_elements);
+
+			// transforms with a device source run the same math as on the CPU, anything
+			// else (e.g. transforms with buffers of their own) specializes this
+			template<typename T>
+			struct kernel {
+				typedef device_op<T> op;
+
+				// the kernel function, the same for every build of the library
+				static std::string name() { return std::string(op::function()) + "_kernel"; }
+
+				static std::pair<cl_program, cl_kernel> load_transform(cl_context ctx, cl_device_id dev,
+						const std::string& options) {
+					return load_device_program(ctx, dev, op::source(), op::function(),
+							op::constants_name(), is_3d<T>::value, options);
 				}
 
-				static cl_kernel& kernel() {
-					static cl_kernel k; return k;
+				static void configure_transform(const T& t,
+						cl_kernel kernel,
+						cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t numelements) {
+					const typename op::constants_type& c = op::constants(t);
+
+					configure_device_program(kernel, &c, sizeof(c),
+							x_in, y_in, NULL, x_out, y_out, NULL, numelements);
 				}
 
-				static bool& loaded() {
-					static bool l; return l;
+				// 3D transforms (see is_3d) configure with z buffers instead
+				static void configure_transform3(const T& t,
+						cl_kernel kernel,
+						cl_mem x_in, cl_mem y_in, cl_mem z_in,
+						cl_mem x_out, cl_mem y_out, cl_mem z_out, size_t numelements) {
+					const typename op::constants_type& c = op::constants(t);
+
+					configure_device_program(kernel, &c, sizeof(c),
+							x_in, y_in, &z_in, x_out, y_out, &z_out, numelements);
 				}
 			};
+
+			// the name of a kernel, so every thread can make its own from the program
+			std::string kernel_name(cl_kernel kernel);
 		}
 
 		struct cpu_device {
@@ -81,6 +189,10 @@ namespace transform {
 			constexpr static cl_device_type device_type = CL_DEVICE_TYPE_GPU;
 		};
 
+		struct any_device {
+			constexpr static cl_device_type device_type = CL_DEVICE_TYPE_ALL;
+		};
+
 
 		template<
 			typename TDeviceType
@@ -89,6 +201,10 @@ namespace transform {
 			// typdefs for supported transforms
 			//
 			typedef transforms::scale<double>					scale_double;
+			typedef transforms::affine<double>					affine_double;
+			typedef transforms::homography<double>				homography_double;
+			typedef transforms::polynomial<double>				polynomial_double;
+			typedef transforms::thin_plate_spline<double>		thin_plate_spline_double;
 			typedef transforms::projection<
 				cartographic::projections::latlong,
 				cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>
@@ -97,51 +213,173 @@ namespace transform {
 				cartographic::projections::latlong,
 				cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>
 																projections_latlong_tmerc_double_wgs84;
-
-			opencl():
-				device_id_(NULL), context_(NULL), queue_(NULL) {
+			typedef transforms::projection<
+				cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>,
+				cartographic::projections::latlong>
+																projections_tmerc_latlong_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>,
+				cartographic::projections::latlong>
+																projections_tmerc_latlong_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>
+																projections_latlong_tmerc_double_runtime;
+			typedef transforms::projection<
+				cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>,
+				cartographic::projections::latlong>
+																projections_tmerc_latlong_double_runtime;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::webmerc>				projections_latlong_webmerc_double;
+			typedef transforms::projection<
+				cartographic::projections::webmerc,
+				cartographic::projections::latlong>				projections_webmerc_latlong_double;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>>
+																projections_latlong_lcc_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>>
+																projections_latlong_lcc_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>,
+				cartographic::projections::latlong>
+																projections_lcc_latlong_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>,
+				cartographic::projections::latlong>
+																projections_lcc_latlong_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>
+																projections_latlong_stere_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>
+																projections_latlong_stere_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::stere<cartographic::ellipsoids::sphere, double>,
+				cartographic::projections::latlong>
+																projections_stere_latlong_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>,
+				cartographic::projections::latlong>
+																projections_stere_latlong_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>
+																projections_latlong_sinu_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>
+																projections_latlong_sinu_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+				cartographic::projections::latlong>
+																projections_sinu_latlong_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+				cartographic::projections::latlong>
+																projections_sinu_latlong_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>
+																projections_latlong_geos_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>
+																projections_latlong_geos_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+				cartographic::projections::latlong>
+																projections_geos_latlong_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+				cartographic::projections::latlong>
+																projections_geos_latlong_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>>
+																projections_latlong_geocent_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::latlong,
+				cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>>
+																projections_latlong_geocent_double_wgs84;
+			typedef transforms::projection<
+				cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>,
+				cartographic::projections::latlong>
+																projections_geocent_latlong_double_sphere;
+			typedef transforms::projection<
+				cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>,
+				cartographic::projections::latlong>
+																projections_geocent_latlong_double_wgs84;
+			typedef transforms::helmert<double>							helmert_double;
+			typedef transforms::datum_shift<double>						datum_shift_double;
+
+			// the first device of TDeviceType's type on the first platform
+			opencl() : opencl(default_device()) { }
+			explicit opencl(const opencl_options& options) : opencl(default_device(), options) { }
+
+			explicit opencl(cl_device_id device_id, const opencl_options& options = opencl_options()):
+				device_id_(device_id), context_(NULL), options_(options), setups_(0) {
 				int err;
 
-				cl_device_id		device_id;
-				cl_context			context;
-				cl_command_queue	queue;
-
-				// initialize devices
-				err = clGetDeviceIDs(NULL, TDeviceType::device_type, 1, &device_id, NULL);
-				if (err != CL_SUCCESS)
-					throw std::runtime_error("Failed to initialze OpenCL device");
-
-				context = clCreateContext(0, 1, &device_id, NULL, NULL, &err);
-				if (!context)
+				context_ = clCreateContext(0, 1, &device_id, NULL, NULL, &err);
+				if (!context_)
 					throw std::runtime_error("Failed to initialize OpenCL context");
 
-				queue = clCreateCommandQueue(context, device_id, 0, &err);
-				if (!queue) {
-					clReleaseContext(context);
-					throw std::runtime_error("Failed to intialize OpenCL command queue");
+				try {
+					// the first lane, so a device which can't make a queue fails here.  Programs
+					// are built on the first run of their transform (see warm_up).
+					release_lane(acquire_lane());
+				}
+				catch(...) {
+					release();
+					throw;
 				}
-
-				device_id_ = device_id;
-				context_ = context;
-				queue_ = queue;
-
-				// load some of our supported Kernels
-				detail::opencl_kernel_wrapper<TDeviceType, scale_double>::load(context, device_id);
-				detail::opencl_kernel_wrapper<TDeviceType, projections_latlong_tmerc_double_sphere>::load(context, device_id);
-				detail::opencl_kernel_wrapper<TDeviceType, projections_latlong_tmerc_double_wgs84>::load(context, device_id);
 			}
 
 			~opencl() {
-				// release our loaded kernels
-				detail::opencl_kernel_wrapper<TDeviceType, scale_double>::release();
-				detail::opencl_kernel_wrapper<TDeviceType, projections_latlong_tmerc_double_sphere>::release();
-				detail::opencl_kernel_wrapper<TDeviceType, projections_latlong_tmerc_double_wgs84>::release();
-
-				clReleaseCommandQueue(queue_);
-				clReleaseContext(context_);
+				release();
 			}
 
+			// programs, kernels and queues belong to this instance's context
+			opencl(const opencl&) = delete;
+			opencl& operator=(const opencl&) = delete;
+
+			static cl_device_id default_device();
 			static bool supports_double_precision();
+			static bool supports_double_precision(cl_device_id device_id);
+
+			cl_device_id device() const { return device_id_; }
+			const opencl_options& options() const { return options_; }
+
+			// stats of every run since the last call, oldest first.  Only backends made with
+			// profiling on record any, and they keep them until taken.
+			std::vector<opencl_run_stats> take_run_stats() const;
+
+			// launch settings per transform.  Transforms without any get tuned on their first
+			// batch of autotune_min_points points or more, smaller batches run with one point
+			// per work-item and the runtime's work-group size until then.
+			static const size_t autotune_min_points = 65536;
+
+			// build the programs for TTransforms now rather than on their first runs, and the
+			// kernels of one lane.  Composites warm up each stage.
+			template<typename... TTransforms> void warm_up() const;
+
+			// programs built, kernels made and kernels tuned so far.  A run which moves it
+			// spent time on more than its points (multi_opencl leaves it out of throughput).
+			size_t setups() const { return setups_; }
+
+			template<typename TTransform> kernel_tuning tuning() const;
+			template<typename TTransform> void set_tuning(const kernel_tuning& t);
+
+			// tunings as text, one line per device and kernel function.  Loading only picks
+			// the lines for this backend's device, so one file can serve several.
+			void save_tuning(std::ostream& os) const;
+			void load_tuning(std::istream& is);
 
 			template<
 				typename TTransform,
@@ -154,22 +392,182 @@ namespace transform {
 				ForwardIterableOutputRange& out_x,
 				ForwardIterableOutputRange& out_y) const;
 
+			// 3D version, transforms which don't need z get a 2D run and z copied through
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run(const TTransform& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y,
+				ForwardIterableOutputRange& out_z) const;
+
 		private:
+			// a command queue and kernel objects, used by one run at a time.  Kernel arguments
+			// are set on every call, so concurrent runs can't share kernel objects, and
+			// clFinish on a queue of its own only waits for the run's own work.  Runs check a
+			// lane out of a pool and return it when done, so there are as many lanes as
+			// there have been concurrent runs.
+			struct lane {
+				// an event the run is waiting to read the timestamps of
+				struct pending_event {
+					const char *category;
+					std::string name;
+					cl_event event;
+				};
+
+				unsigned id;
+				cl_command_queue queue;
+				std::map<std::type_index, cl_kernel> kernels;
+				std::vector<pending_event> events;
+			};
+
+			// a checked out lane, returned to the pool on destruction
+			struct lane_guard {
+				const opencl& backend;
+				lane& l;
+
+				explicit lane_guard(const opencl& b) : backend(b), l(b.acquire_lane()) { }
+				~lane_guard() { backend.release_lane(l); }
+
+				lane_guard(const lane_guard&) = delete;
+				lane_guard& operator=(const lane_guard&) = delete;
+			};
+
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run3(const TTransform& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y,
+				ForwardIterableOutputRange& out_z, std::false_type) const;
+
+			template<
+				typename TTransform,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run3(const TTransform& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y,
+				ForwardIterableOutputRange& out_z, std::true_type) const;
+
+			// configure and queue the kernel for p, composites queue each stage in turn
+			template<typename TTransform>
+			void enqueue(lane& l, const TTransform& p,
+				cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t size) const;
+
+			template<
+				typename TFirst,
+				typename TSecond
+			>
+			void enqueue(lane& l, const transforms::composite<TFirst, TSecond>& p,
+				cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t size) const;
+
+			// thin-plate splines upload their control points along with the inputs
+			void enqueue(lane& l, const transforms::thin_plate_spline<double>& p,
+				cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t size) const;
+
+			// a program per transform, built once by its first run
+			struct program_entry {
+				std::once_flag built;
+				cl_program program;
+				std::string kernel_name;
+
+				program_entry() : program(NULL) { }
+			};
+
+			// TTransform's program, concurrent first runs build it once and the others wait.
+			// A failed build throws and leaves the next run to try again.
+			template<typename TTransform> const program_entry& program() const;
+
+			template<typename TTransform> void warm_up(lane& l, const TTransform *) const;
+
+			template<
+				typename TFirst,
+				typename TSecond
+			>
+			void warm_up(lane& l, const transforms::composite<TFirst, TSecond> *) const;
+
+			// lanes go back with their events released, runs which throw never record theirs
+			lane& acquire_lane() const;
+			void release_lane(lane& l) const;
+
+			// the calling thread's kernel for TTransform, made on first use
+			template<typename TTransform>
+			cl_kernel kernel(lane& l) const;
+
+			void release();
+
+			// run the configured kernel for TTransform, tuning it first if it's time to
+			template<typename TTransform>
+			void launch(lane& l, cl_kernel kernel, size_t size) const;
+
+			// keep a finished command's event for the run's stats when profiling, release it
+			// otherwise
+			void track(lane& l, const char *category, const std::string& name, cl_event evt) const;
+
+			// read the timestamps of the lane's events into the stats of a finished run
+			void record(lane& l, size_t points, double host_seconds) const;
+
+			// ranges the device can read and write in place: contiguous doubles.  Anything
+			// else goes through scratch buffers of staging_points, blocking, and gets no event.
+			template<typename TRange>
+			struct device_layout : std::integral_constant<bool,
+				is_contiguous_range<TRange>::value &&
+				std::is_same<typename boost::range_value<TRange>::type, double>::value> { };
+
 			template<typename TContainer> cl_mem make_cl_mem(TContainer& c) const;
-			template<typename TContainer> cl_mem make_cl_mem(const TContainer& c, cl_event *evt) const;
+			template<typename TContainer> cl_mem make_cl_mem(cl_command_queue q,
+					const TContainer& c, cl_event *evt) const;
+			template<typename TContainer> void upload(cl_command_queue q, cl_mem mem,
+					const TContainer& c, cl_event *evt, std::true_type) const;
+			template<typename TContainer> void upload(cl_command_queue q, cl_mem mem,
+					const TContainer& c, cl_event *evt, std::false_type) const;
 			template<typename TContainer> void download_to_host(cl_command_queue q, 
 					cl_mem mem, TContainer& c, cl_event *evt) const;
+			template<typename TContainer> void download_to_host(cl_command_queue q,
+					cl_mem mem, TContainer& c, cl_event *evt, std::true_type) const;
+			template<typename TContainer> void download_to_host(cl_command_queue q,
+					cl_mem mem, TContainer& c, cl_event *evt, std::false_type) const;
 
 		private:
 			cl_device_id device_id_;
 			cl_context context_;
-			cl_command_queue queue_;
+			opencl_options options_;
+
+			mutable std::map<std::type_index, std::unique_ptr<program_entry>> programs_;
+			mutable std::mutex programs_mutex_;
+
+			mutable std::vector<std::unique_ptr<lane>> lanes_;
+			mutable std::vector<lane*> free_lanes_;
+			mutable std::mutex lanes_mutex_;
+
+			mutable std::map<std::string, kernel_tuning> tuning_;
+			mutable std::mutex tuning_mutex_;
+
+			mutable std::vector<opencl_run_stats> run_stats_;
+			mutable std::mutex run_stats_mutex_;
+
+			mutable std::atomic<size_t> setups_;
 		};
 	}
 }
 
-#include "support/opencl_detail.hpp"
 #include "support/opencl_kernels.ipp"
+#include "support/opencl_detail.hpp"
 
 #endif // __transform_backends_opencl_hpp__
 
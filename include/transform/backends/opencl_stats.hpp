@@ -0,0 +1,56 @@
+// opencl_stats.hpp
+// Device side timings of OpenCL runs
+//
+
+#ifndef __transform_backends_opencl_stats_hpp__
+#define __transform_backends_opencl_stats_hpp__
+
+#include <OpenCL/opencl.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace transform {
+	namespace backends {
+		// one command of a run with its device timestamps, in nanoseconds of the device clock
+		struct opencl_event_stats {
+			std::string category;	// upload, kernel or download
+			std::string name;		// e.g. "upload x", "tmerc_forward_kernel"
+
+			cl_ulong queued, submitted, started, ended;
+		};
+
+		// what one call to run did, recorded by backends created with profiling on
+		struct opencl_run_stats {
+			std::string device;
+			size_t points;
+
+			// the command queue the run went through, runs on different queues may overlap
+			unsigned queue;
+
+			// wall clock time of the whole call, including waiting and host side copies
+			double host_seconds;
+
+			std::vector<opencl_event_stats> events;
+
+			// device time between start and end of the commands in category
+			double device_seconds(const std::string& category) const {
+				cl_ulong ns = 0;
+				for (const opencl_event_stats& e : events)
+					if (e.category == category)
+						ns += e.ended - e.started;
+
+				return ns * 1e-9;
+			}
+		};
+
+		// runs as a Chrome trace (chrome://tracing, Perfetto), a process per device with a
+		// track per command queue and every command from start to end.  Device clocks
+		// aren't synchronized, so each device's times are relative to its first command
+		// queued.
+		void write_chrome_trace(std::ostream& os, const std::vector<opencl_run_stats>& runs);
+	}
+}
+
+#endif // __transform_backends_opencl_stats_hpp__
@@ -57,12 +57,55 @@ namespace transform {
 				const ForwardIterableInputRange& y,
 				ForwardIterableOutputRange& out_x,
 				ForwardIterableOutputRange& out_y) const {
-				size_t sx = boost::size(x);
-
 				// data sanity
-				assert(sx == boost::size(y));
+				assert(boost::size(x) == boost::size(y));
+				assert(boost::size(y) == boost::size(out_x));
+				assert(boost::size(out_x) == boost::size(out_y));
+
+				// projcl does in-place transforms, so move all input values to output
+				std::copy(boost::begin(x), boost::end(x), boost::begin(out_x));
+				std::copy(boost::begin(y), boost::end(y), boost::begin(out_y));
+
+				transform_in_place(p, out_x, out_y, static_cast<double *>(NULL));
+			}
+
+			template<
+				typename TProjection,
+				typename ForwardIterableInputRange,
+				typename ForwardIterableOutputRange
+			>
+			void run(const TProjection& p,
+				const ForwardIterableInputRange& x,
+				const ForwardIterableInputRange& y,
+				const ForwardIterableInputRange& z,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y,
+				ForwardIterableOutputRange& out_z) const {
+				assert(boost::size(x) == boost::size(y));
+				assert(boost::size(x) == boost::size(z));
 				assert(boost::size(y) == boost::size(out_x));
 				assert(boost::size(out_x) == boost::size(out_y));
+				assert(boost::size(out_x) == boost::size(out_z));
+
+				std::copy(boost::begin(x), boost::end(x), boost::begin(out_x));
+				std::copy(boost::begin(y), boost::end(y), boost::begin(out_y));
+				std::copy(boost::begin(z), boost::end(z), boost::begin(out_z));
+
+				// heights go through pj_transform too, so datum and geocentric conversions
+				// see them
+				transform_in_place(p, out_x, out_y, &(*boost::begin(out_z)));
+			}
+
+			private:
+			template<
+				typename TProjection,
+				typename ForwardIterableOutputRange
+			>
+			void transform_in_place(const TProjection& p,
+				ForwardIterableOutputRange& out_x,
+				ForwardIterableOutputRange& out_y,
+				double *out_z) const {
+				size_t sx = boost::size(out_x);
 
 				std::string from = projection_to_string(p.from);
 				std::string to = projection_to_string(p.to);
@@ -84,7 +127,7 @@ namespace transform {
 					pj_transform(pj_in, pj_out,
 							static_cast<long>(point_count),
 							static_cast<int>(stride),
-							x, y, NULL);
+							x, y, z);
 
 					pj_free(pj_in);
 					pj_free(pj_out);
@@ -94,18 +137,10 @@ namespace transform {
 				};
 
 				typedef typename boost::range_iterator<ForwardIterableOutputRange>::type iterator;
-				typedef typename boost::range_const_iterator<ForwardIterableInputRange>::type const_iterator;
-
-				// projcl does in-place transforms, so move all input values to output
-				const_iterator bx = boost::begin(x),
-							   by = boost::begin(y);
 
 				iterator ox = boost::begin(out_x),
 						 oy = boost::begin(out_y);
 
-				std::copy(bx, boost::end(x), ox);
-				std::copy(by, boost::end(y), oy);
-
 				utility::scheduler<MaxConcurrency> c;
 				unsigned max_threads = c.concurrency();
 				size_t per_batch = sx / max_threads;
@@ -114,16 +149,18 @@ namespace transform {
 				for (unsigned i = 0 ; i < max_threads ; i ++) {
 					double *x = &(*(ox + offset));
 					double *y = &(*(oy + offset));
-					double *z = NULL;
+					double *z = out_z ? out_z + offset : NULL;
+
+					// last batch picks up whatever is left over from the division
+					size_t count = (i == max_threads - 1) ? sx - offset : per_batch;
 
-					c.queue(compute, x, y, z, 1, per_batch);
-					offset += per_batch;
+					c.queue(compute, x, y, z, 1, count);
+					offset += count;
 				}
 
 				c.wait();
 			}
 
-			private:
 			static std::string projection_to_string(const cartographic::projections::latlong& p) {
 				std::stringstream sstr;
 				sstr << "+proj=" << p.name;
@@ -131,14 +168,124 @@ namespace transform {
 				return sstr.str();
 			}
 
+			static std::string projection_to_string(const cartographic::projections::webmerc& p) {
+				return "+proj=merc +a=6378137 +b=6378137 +lat_ts=0 +lon_0=0 +x_0=0 +y_0=0 +k=1 "
+					"+units=m +nadgrids=@null +no_defs";
+			}
+
+			template<typename TEllipsoid, typename T>
+			static std::string projection_to_string(const cartographic::projections::geocent<TEllipsoid, T>& p) {
+				std::stringstream sstr;
+				sstr << "+proj=" << p.name << " +ellps=" << TEllipsoid::name;
+
+				return sstr.str();
+			}
+
 			template<typename TEllipsoid, typename T>
 			static std::string projection_to_string(const cartographic::projections::tmerc<TEllipsoid, T>& p) {
 				std::stringstream sstr;
 
+				sstr.precision(17);
 				sstr << "+proj=" << p.name
 					<< " +ellps=" << TEllipsoid::name
-					<< " +lat_0=" << std::abs(p.offset.first) << (p.offset.first > 0.0 ? "n" : "s")
-					<< " +lon_0=" << std::abs(p.offset.second) << (p.offset.second > 0.0 ? "e" : "w");
+					<< " +lat_0=" << p.phi0 * util::TO_DEGREES
+					<< " +lon_0=" << p.lambda0 * util::TO_DEGREES
+					<< " +k_0=" << p.k0
+					<< " +x_0=" << p.offset.first
+					<< " +y_0=" << p.offset.second;
+
+				return sstr.str();
+			}
+
+			template<typename TEllipsoid, typename T>
+			static std::string projection_to_string(const cartographic::projections::lcc<TEllipsoid, T>& p) {
+				std::stringstream sstr;
+
+				sstr.precision(17);
+				sstr << "+proj=" << p.name
+					<< " +ellps=" << TEllipsoid::name
+					<< " +lat_1=" << p.phi1 * util::TO_DEGREES
+					<< " +lat_2=" << p.phi2 * util::TO_DEGREES
+					<< " +lat_0=" << p.phi0 * util::TO_DEGREES
+					<< " +lon_0=" << p.lambda0 * util::TO_DEGREES
+					<< " +k_0=" << p.k0
+					<< " +x_0=" << p.offset.first
+					<< " +y_0=" << p.offset.second;
+
+				return sstr.str();
+			}
+
+			template<typename TEllipsoid, typename T>
+			static std::string projection_to_string(const cartographic::projections::stere<TEllipsoid, T>& p) {
+				std::stringstream sstr;
+
+				sstr.precision(17);
+				sstr << "+proj=" << p.name
+					<< " +ellps=" << TEllipsoid::name
+					<< " +lat_0=" << p.phi0 * util::TO_DEGREES
+					<< " +lat_ts=" << p.consts.sign * p.phits * util::TO_DEGREES
+					<< " +lon_0=" << p.lambda0 * util::TO_DEGREES
+					<< " +k_0=" << p.k0
+					<< " +x_0=" << p.offset.first
+					<< " +y_0=" << p.offset.second;
+
+				return sstr.str();
+			}
+
+			template<typename TEllipsoid, typename T>
+			static std::string projection_to_string(const cartographic::projections::sinu<TEllipsoid, T>& p) {
+				std::stringstream sstr;
+
+				sstr.precision(17);
+				sstr << "+proj=" << p.name;
+
+				// the sphere may have been resized, MODIS uses its own radius
+				if (p.consts.es <= 0.)
+					sstr << " +R=" << p.consts.a;
+				else
+					sstr << " +ellps=" << TEllipsoid::name;
+
+				sstr << " +lon_0=" << p.lambda0 * util::TO_DEGREES
+					<< " +x_0=" << p.offset.first
+					<< " +y_0=" << p.offset.second;
+
+				return sstr.str();
+			}
+
+			template<typename TEllipsoid, typename T>
+			static std::string projection_to_string(const cartographic::projections::geos<TEllipsoid, T>& p) {
+				std::stringstream sstr;
+
+				sstr.precision(17);
+				sstr << "+proj=" << p.name
+					<< " +ellps=" << TEllipsoid::name
+					<< " +h=" << p.h
+					<< " +lon_0=" << p.lambda0 * util::TO_DEGREES
+					<< " +sweep=" << (p.sweep == cartographic::projections::sweep_axis::x ? "x" : "y")
+					<< " +x_0=" << p.offset.first
+					<< " +y_0=" << p.offset.second;
+
+				return sstr.str();
+			}
+
+			template<typename T>
+			static std::string projection_to_string(const cartographic::projections::tmerc<cartographic::ellipsoids::runtime, T>& p) {
+				std::stringstream sstr;
+
+				sstr.precision(17);
+				sstr << "+proj=" << p.name;
+
+				if (p.ellipsoid.spherical())
+					sstr << " +R=" << p.ellipsoid.major_axis;
+				else
+					sstr << " +a=" << p.ellipsoid.major_axis
+						<< " +rf=" << p.ellipsoid.inverse_flattening;
+
+				sstr << " +lat_0=" << p.phi0 * util::TO_DEGREES
+					<< " +lon_0=" << p.lambda0 * util::TO_DEGREES
+					<< " +k_0=" << p.k0
+					<< " +x_0=" << p.offset.first
+					<< " +y_0=" << p.offset.second;
 
 				return sstr.str();
 			}
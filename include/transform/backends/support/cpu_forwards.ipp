@@ -2,7 +2,12 @@
 // Forward declarations for tranform specializations
 //
 
+#include "../../transforms/basic.hpp"
 #include "../../transforms/cartographic.hpp"
+#include "../../transforms/datum.hpp"
+#include "../../transforms/grid_shift.hpp"
+#include "../../transforms/polynomial.hpp"
+#include "../../transforms/thin_plate_spline.hpp"
 
 namespace transform {
 	template<>
@@ -52,4 +57,887 @@ namespace transform {
 			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>,
 			cartographic::projections::latlong>& p,
 			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::tmerc<cartographic::ellipsoids::runtime, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::webmerc>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::webmerc>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::webmerc,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::webmerc,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::webmerc>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::webmerc>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::webmerc,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::webmerc,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::webmerc>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::webmerc>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::lcc<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::sphere, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::stere<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::sinu<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_op<
+		transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, double& ox, double&oy);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<
+		transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_grid_op<
+		transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geos<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy);
+
+	template<>
+	void do_op3<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_op3<
+		transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<
+		transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::sphere, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_op3<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<
+		transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::latlong,
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_op3<
+		transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<
+		transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>,
+		double,
+		double
+	>(const transforms::projection<
+			cartographic::projections::geocent<cartographic::ellipsoids::WGS84, double>,
+			cartographic::projections::latlong>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_op3<transforms::helmert<double>, double, double>(
+			const transforms::helmert<double>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<transforms::helmert<double>, double, double>(
+			const transforms::helmert<double>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_op<transforms::datum_shift<double>, double, double>(
+			const transforms::datum_shift<double>& p,
+			const double& x, const double& y, double& ox, double& oy);
+
+	template<>
+	void do_batch_op<transforms::datum_shift<double>, double, double>(
+			const transforms::datum_shift<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op3<transforms::datum_shift<double>, double, double>(
+			const transforms::datum_shift<double>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<transforms::datum_shift<double>, double, double>(
+			const transforms::datum_shift<double>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_op<transforms::ntv2_shift, double, double>(
+			const transforms::ntv2_shift& p,
+			const double& x, const double& y, double& ox, double& oy);
+
+	template<>
+	void do_batch_op<transforms::ntv2_shift, double, double>(
+			const transforms::ntv2_shift& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_op3<transforms::gtx_shift, double, double>(
+			const transforms::gtx_shift& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz);
+
+	template<>
+	void do_batch_op3<transforms::gtx_shift, double, double>(
+			const transforms::gtx_shift& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count);
+
+	template<>
+	void do_batch_op<transforms::affine<double>, double, double>(
+			const transforms::affine<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<transforms::homography<double>, double, double>(
+			const transforms::homography<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<transforms::polynomial<double>, double, double>(
+			const transforms::polynomial<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
+
+	template<>
+	void do_batch_op<transforms::thin_plate_spline<double>, double, double>(
+			const transforms::thin_plate_spline<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count);
 }
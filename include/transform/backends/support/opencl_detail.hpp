@@ -14,10 +14,8 @@ namespace transform {
 		template<typename TDeviceType>
 		template<typename TContainer>
 		cl_mem opencl<TDeviceType>::make_cl_mem(TContainer& c) const {
-			typedef typename TContainer::value_type element_type;
-
 			size_t ps = boost::size(c);
-			size_t bs = pad(ps * sizeof(element_type), 1024);
+			size_t bs = pad(ps * sizeof(double), 1024);
 
 			assert(context_ != NULL);
 
@@ -32,14 +30,12 @@ namespace transform {
 
 		template<typename TDeviceType>
 		template<typename TContainer>
-		cl_mem opencl<TDeviceType>::make_cl_mem(const TContainer& c, cl_event *evt) const {
-			typedef typename TContainer::value_type element_type;
-
+		cl_mem opencl<TDeviceType>::make_cl_mem(cl_command_queue q, const TContainer& c, cl_event *evt) const {
 			size_t ps = boost::size(c);
-			size_t bs = pad(ps * sizeof(element_type), 1024);
+			size_t bs = pad(ps * sizeof(double), 1024);
 
 			assert(context_ != NULL);
-			assert(queue_ != NULL);
+			assert(q != NULL);
 
 			int err;
 			cl_mem b = clCreateBuffer(context_, CL_MEM_READ_ONLY,
@@ -47,42 +43,484 @@ namespace transform {
 			if (!b || err != CL_SUCCESS)
 				throw std::runtime_error("Out of memory while trying to allocate OpenCL buffer");
 
+			try {
+				upload(q, b, c, evt, device_layout<const TContainer>());
+			}
+			catch(...) {
+				clReleaseMemObject(b);
+				throw;
+			}
+
+			return b;
+		}
+
+		template<typename TDeviceType>
+		template<typename TContainer>
+		void opencl<TDeviceType>::upload(cl_command_queue q, cl_mem mem, const TContainer& c,
+				cl_event *evt, std::true_type) const {
 			cl_bool sync = (evt == NULL) ? CL_TRUE : CL_FALSE;
 
-			err = 
-				clEnqueueWriteBuffer(queue_, b, sync, 0, sizeof(element_type) * boost::size(c),
-						&c[0], 0, NULL, evt);
+			int err = 
+				clEnqueueWriteBuffer(q, mem, sync, 0, sizeof(double) * boost::size(c),
+						&(*boost::begin(c)), 0, NULL, evt);
 			if (err != CL_SUCCESS)
 				throw std::runtime_error("Failed to queue buffer upload");
+		}
 
-			return b;
+		template<typename TDeviceType>
+		template<typename TContainer>
+		void opencl<TDeviceType>::upload(cl_command_queue q, cl_mem mem, const TContainer& c,
+				cl_event *evt, std::false_type) const {
+			if (evt)
+				*evt = NULL;
+
+			size_t ps = boost::size(c);
+			std::vector<double> scratch(std::min(ps, detail::staging_points));
+
+			auto it = boost::begin(c);
+			for (size_t first = 0 ; first < ps ; first += scratch.size()) {
+				size_t n = std::min(scratch.size(), ps - first);
+
+				std::copy_n(it, n, scratch.begin());
+				std::advance(it, n);
+
+				// blocking, the scratch buffer is refilled right after
+				int err =
+					clEnqueueWriteBuffer(q, mem, CL_TRUE, sizeof(double) * first, sizeof(double) * n,
+							&scratch[0], 0, NULL, NULL);
+				if (err != CL_SUCCESS)
+					throw std::runtime_error("Failed to queue buffer upload");
+			}
 		}
 
 		template<typename TDeviceType>
 		template<typename TContainer>
 		void opencl<TDeviceType>::download_to_host(cl_command_queue q, cl_mem mem, TContainer& c, cl_event *evt) const {
-			typedef typename TContainer::value_type element_type;
+			download_to_host(q, mem, c, evt, device_layout<TContainer>());
+		}
 
+		template<typename TDeviceType>
+		template<typename TContainer>
+		void opencl<TDeviceType>::download_to_host(cl_command_queue q, cl_mem mem, TContainer& c,
+				cl_event *evt, std::true_type) const {
 			bool sync = (evt == NULL) ? CL_TRUE : CL_FALSE;
 			int err =
-				clEnqueueReadBuffer(q, mem, sync, 0, sizeof(element_type) * boost::size(c),
-						&c[0], 0, NULL, evt);
+				clEnqueueReadBuffer(q, mem, sync, 0, sizeof(double) * boost::size(c),
+						&(*boost::begin(c)), 0, NULL, evt);
 
 			if (err != CL_SUCCESS)
 				throw std::runtime_error("Failed to queue download to host");
 		}
 
+		template<typename TDeviceType>
+		template<typename TContainer>
+		void opencl<TDeviceType>::download_to_host(cl_command_queue q, cl_mem mem, TContainer& c,
+				cl_event *evt, std::false_type) const {
+			if (evt)
+				*evt = NULL;
+
+			size_t ps = boost::size(c);
+			std::vector<double> scratch(std::min(ps, detail::staging_points));
+
+			auto it = boost::begin(c);
+			for (size_t first = 0 ; first < ps ; first += scratch.size()) {
+				size_t n = std::min(scratch.size(), ps - first);
+
+				int err =
+					clEnqueueReadBuffer(q, mem, CL_TRUE, sizeof(double) * first, sizeof(double) * n,
+							&scratch[0], 0, NULL, NULL);
+				if (err != CL_SUCCESS)
+					throw std::runtime_error("Failed to queue download to host");
+
+				it = std::copy(scratch.begin(), scratch.begin() + n, it);
+			}
+		}
+
 
 		template<typename TDeviceType>
-		bool opencl<TDeviceType>::supports_double_precision() {
+		template<typename TTransform>
+		void opencl<TDeviceType>::enqueue(lane& l, const TTransform& p,
+				cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t size) const {
+			cl_kernel k = kernel<TTransform>(l);
+
+			detail::kernel<TTransform>::configure_transform(p, k, x_in, y_in, x_out, y_out, size);
+			launch<TTransform>(l, k, size);
+		}
+
+		template<typename TDeviceType>
+		template<
+			typename TFirst,
+			typename TSecond
+		>
+		void opencl<TDeviceType>::enqueue(lane& l, const transforms::composite<TFirst, TSecond>& p,
+				cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t size) const {
+			// intermediate coordinates stay on the device, the queue is in order so the second
+			// kernel sees everything the first one wrote
 			int err;
+			size_t bs = pad(size * sizeof(double), 1024);
+
+			// released once the kernels using them are done, or straight away if a stage throws
+			detail::mem_guard buffers;
+
+			cl_mem mid[2];
+			for (cl_mem& m : mid) {
+				m = clCreateBuffer(context_, CL_MEM_READ_WRITE, bs, NULL, &err);
+				if (m)
+					buffers.hold(m);
+
+				if (!m || err != CL_SUCCESS)
+					throw std::runtime_error("Out of memory while trying to allocate OpenCL buffer");
+			}
+
+			enqueue(l, p.first, x_in, y_in, mid[0], mid[1], size);
+			enqueue(l, p.second, mid[0], mid[1], x_out, y_out, size);
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::enqueue(lane& l, const transforms::thin_plate_spline<double>& p,
+				cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t size) const {
+			typedef transforms::thin_plate_spline<double> tps;
+			const tps::model& s = *p.m;
+
+			std::vector<double> packed(s.cx.size() * 4);
+			for (size_t i = 0, n = s.cx.size() ; i < n ; i ++) {
+				packed[i * 4 + 0] = s.cx[i];
+				packed[i * 4 + 1] = s.cy[i];
+				packed[i * 4 + 2] = s.wx[i];
+				packed[i * 4 + 3] = s.wy[i];
+			}
+
+			// the enqueued kernel holds its own reference, it goes once the kernel is done
+			detail::mem_guard buffers;
+			cl_mem controls = buffers.hold(make_cl_mem(l.queue, packed, NULL));
+			cl_kernel k = kernel<tps>(l);
+
+			detail::kernel<tps>::configure_transform(p, k, controls,
+					x_in, y_in, x_out, y_out, size);
+
+			launch<tps>(l, k, size);
+		}
+
+		template<typename TDeviceType>
+		template<typename TTransform>
+		const typename opencl<TDeviceType>::program_entry& opencl<TDeviceType>::program() const {
+			program_entry *e;
+			{
+				std::lock_guard<std::mutex> lock(programs_mutex_);
+
+				std::unique_ptr<program_entry>& slot = programs_[std::type_index(typeid(TTransform))];
+				if (!slot)
+					slot.reset(new program_entry);
+
+				e = slot.get();
+			}
+
+			std::call_once(e->built, [this, e]() {
+				auto p = detail::kernel<TTransform>::load_transform(context_, device_id_,
+						detail::build_options(options_.precision));
+
+				try {
+					e->kernel_name = detail::kernel_name(p.second);
+				}
+				catch(...) {
+					clReleaseKernel(p.second);
+					clReleaseProgram(p.first);
+					throw;
+				}
+
+				clReleaseKernel(p.second);
+				e->program = p.first;
+
+				setups_ ++;
+			});
+
+			return *e;
+		}
+
+		template<typename TDeviceType>
+		template<typename... TTransforms>
+		void opencl<TDeviceType>::warm_up() const {
+			lane_guard guard(*this);
+
+			int expand[] = { 0, (warm_up(guard.l, static_cast<const TTransforms *>(NULL)), 0)... };
+			(void)expand;
+		}
+
+		template<typename TDeviceType>
+		template<typename TTransform>
+		void opencl<TDeviceType>::warm_up(lane& l, const TTransform *) const {
+			kernel<TTransform>(l);
+		}
+
+		template<typename TDeviceType>
+		template<
+			typename TFirst,
+			typename TSecond
+		>
+		void opencl<TDeviceType>::warm_up(lane& l, const transforms::composite<TFirst, TSecond> *) const {
+			warm_up(l, static_cast<const TFirst *>(NULL));
+			warm_up(l, static_cast<const TSecond *>(NULL));
+		}
+
+		template<typename TDeviceType>
+		typename opencl<TDeviceType>::lane& opencl<TDeviceType>::acquire_lane() const {
+			std::lock_guard<std::mutex> lock(lanes_mutex_);
+
+			if (!free_lanes_.empty()) {
+				lane *l = free_lanes_.back();
+				free_lanes_.pop_back();
+
+				return *l;
+			}
+
+			cl_command_queue_properties properties =
+				options_.profiling ? CL_QUEUE_PROFILING_ENABLE : 0;
+
+			int err;
+			cl_command_queue queue = clCreateCommandQueue(context_, device_id_, properties, &err);
+			if (!queue)
+				throw std::runtime_error("Failed to intialize OpenCL command queue");
+
+			lanes_.push_back(std::unique_ptr<lane>(new lane));
+			lanes_.back()->id = static_cast<unsigned>(lanes_.size() - 1);
+			lanes_.back()->queue = queue;
+
+			return *lanes_.back();
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::release_lane(lane& l) const {
+			for (auto& e : l.events)
+				clReleaseEvent(e.event);
+			l.events.clear();
+
+			std::lock_guard<std::mutex> lock(lanes_mutex_);
+			free_lanes_.push_back(&l);
+		}
+
+		template<typename TDeviceType>
+		template<typename TTransform>
+		cl_kernel opencl<TDeviceType>::kernel(lane& l) const {
+			const std::type_index key(typeid(TTransform));
+
+			// the lane is checked out to the calling run
+			auto k = l.kernels.find(key);
+			if (k != l.kernels.end())
+				return k->second;
+
+			const program_entry& p = program<TTransform>();
+
+			int err;
+			cl_kernel created = clCreateKernel(p.program, p.kernel_name.c_str(), &err);
+			if (!created || err != CL_SUCCESS)
+				throw std::runtime_error("Failed to load kernel");
+
+			l.kernels[key] = created;
+			setups_ ++;
+
+			return created;
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::release() {
+			for (auto& l : lanes_) {
+				for (auto& e : l->events)
+					clReleaseEvent(e.event);
+
+				for (auto& k : l->kernels)
+					clReleaseKernel(k.second);
+
+				clReleaseCommandQueue(l->queue);
+			}
+
+			for (auto& p : programs_)
+				if (p.second->program)
+					clReleaseProgram(p.second->program);
+
+			lanes_.clear();
+			free_lanes_.clear();
+			programs_.clear();
+
+			if (context_)
+				clReleaseContext(context_);
+			context_ = NULL;
+		}
+
+		template<typename TDeviceType>
+		template<typename TTransform>
+		void opencl<TDeviceType>::launch(lane& l, cl_kernel kernel, size_t size) const {
+			// by kernel function, transforms sharing one share its tuning
+			const std::string key = detail::kernel<TTransform>::name();
+
+			kernel_tuning t = { 0, 1 };
+			bool tuned;
+			{
+				std::lock_guard<std::mutex> lock(tuning_mutex_);
+
+				auto i = tuning_.find(key);
+				tuned = (i != tuning_.end());
+				if (tuned)
+					t = i->second;
+			}
+
+			if (!tuned && size >= autotune_min_points) {
+				t = detail::tune_kernel(l.queue, device_id_, kernel, size);
+				setups_ ++;
+
+				std::lock_guard<std::mutex> lock(tuning_mutex_);
+				tuning_[key] = t;
+			}
+
+			if (!options_.profiling) {
+				detail::enqueue_kernel(l.queue, kernel, size, t);
+				return;
+			}
+
+			cl_event evt;
+			detail::enqueue_kernel(l.queue, kernel, size, t, &evt);
+			track(l, "kernel", program<TTransform>().kernel_name, evt);
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::track(lane& l, const char *category, const std::string& name,
+				cl_event evt) const {
+			if (!evt)
+				return;
+
+			if (!options_.profiling) {
+				clReleaseEvent(evt);
+				return;
+			}
+
+			typename lane::pending_event e = { category, name, evt };
+			l.events.push_back(e);
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::record(lane& l, size_t points, double host_seconds) const {
+			if (!options_.profiling)
+				return;
+
+			opencl_run_stats s;
+			s.device = detail::device_name(device_id_);
+			s.queue = l.id;
+			s.points = points;
+			s.host_seconds = host_seconds;
+
+			for (auto& e : l.events) {
+				opencl_event_stats es;
+				es.category = e.category;
+				es.name = e.name;
+
+				int err = 0;
+				err |= clGetEventProfilingInfo(e.event, CL_PROFILING_COMMAND_QUEUED,
+						sizeof(cl_ulong), &es.queued, NULL);
+				err |= clGetEventProfilingInfo(e.event, CL_PROFILING_COMMAND_SUBMIT,
+						sizeof(cl_ulong), &es.submitted, NULL);
+				err |= clGetEventProfilingInfo(e.event, CL_PROFILING_COMMAND_START,
+						sizeof(cl_ulong), &es.started, NULL);
+				err |= clGetEventProfilingInfo(e.event, CL_PROFILING_COMMAND_END,
+						sizeof(cl_ulong), &es.ended, NULL);
+
+				clReleaseEvent(e.event);
+
+				if (err == CL_SUCCESS)
+					s.events.push_back(es);
+			}
+
+			l.events.clear();
+
+			std::lock_guard<std::mutex> lock(run_stats_mutex_);
+			run_stats_.push_back(s);
+		}
+
+		template<typename TDeviceType>
+		std::vector<opencl_run_stats> opencl<TDeviceType>::take_run_stats() const {
+			std::lock_guard<std::mutex> lock(run_stats_mutex_);
+
+			std::vector<opencl_run_stats> taken;
+			taken.swap(run_stats_);
+
+			return taken;
+		}
+
+		template<typename TDeviceType>
+		template<typename TTransform>
+		kernel_tuning opencl<TDeviceType>::tuning() const {
+			std::lock_guard<std::mutex> lock(tuning_mutex_);
+
+			auto i = tuning_.find(detail::kernel<TTransform>::name());
+			if (i == tuning_.end()) {
+				kernel_tuning t = { 0, 1 };
+				return t;
+			}
+
+			return i->second;
+		}
+
+		template<typename TDeviceType>
+		template<typename TTransform>
+		void opencl<TDeviceType>::set_tuning(const kernel_tuning& t) {
+			if (t.points_per_item == 0)
+				throw std::invalid_argument("Kernels need at least one point per work-item");
+
+			std::lock_guard<std::mutex> lock(tuning_mutex_);
+			tuning_[detail::kernel<TTransform>::name()] = t;
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::save_tuning(std::ostream& os) const {
+			const std::string device = detail::device_name(device_id_);
+
+			std::lock_guard<std::mutex> lock(tuning_mutex_);
+			for (const auto& t : tuning_)
+				os << device << '\t' << t.first << '\t'
+				   << t.second.local_size << '\t' << t.second.points_per_item << '\n';
+		}
+
+		template<typename TDeviceType>
+		void opencl<TDeviceType>::load_tuning(std::istream& is) {
+			const std::string device = detail::device_name(device_id_);
+
+			std::lock_guard<std::mutex> lock(tuning_mutex_);
+
+			std::string line;
+			while (std::getline(is, line)) {
+				size_t a = line.find('\t'), b = line.find('\t', a + 1), c = line.find('\t', b + 1);
+				if (a == std::string::npos || b == std::string::npos || c == std::string::npos)
+					continue;
+
+				if (line.compare(0, a, device) != 0 || a != device.size())
+					continue;
+
+				kernel_tuning t;
+				t.local_size = std::stoul(line.substr(b + 1, c - b - 1));
+				t.points_per_item = static_cast<unsigned>(std::stoul(line.substr(c + 1)));
+
+				if (t.points_per_item > 0)
+					tuning_[line.substr(a + 1, b - a - 1)] = t;
+			}
+		}
+
+		template<typename TDeviceType>
+		cl_device_id opencl<TDeviceType>::default_device() {
 			cl_device_id device_id;
 
-			err = clGetDeviceIDs(NULL, TDeviceType::device_type, 1, &device_id, NULL);
+			int err = clGetDeviceIDs(NULL, TDeviceType::device_type, 1, &device_id, NULL);
 			if (err != CL_SUCCESS)
 				throw std::runtime_error("Failed to initialze OpenCL device");
 
-			cl_device_fp_config fp_config, required_config = 
+			return device_id;
+		}
+
+		template<typename TDeviceType>
+		bool opencl<TDeviceType>::supports_double_precision() {
+			return supports_double_precision(default_device());
+		}
+
+		template<typename TDeviceType>
+		bool opencl<TDeviceType>::supports_double_precision(cl_device_id device_id) {
+			cl_device_fp_config fp_config = 0, required_config = 
 				CL_FP_FMA | CL_FP_ROUND_TO_NEAREST | CL_FP_ROUND_TO_ZERO | CL_FP_ROUND_TO_INF | CL_FP_INF_NAN | CL_FP_DENORM;
 
 			clGetDeviceInfo(device_id, CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(fp_config), &fp_config, NULL);
@@ -108,6 +546,8 @@ namespace transform {
 			assert(boost::size(out_x) == boost::size(y));
 			assert(boost::size(out_x) == boost::size(out_y));
 
+			if (size == 0)
+				return;
 
 #if false
 			cl_ulong max_buf;
@@ -115,45 +555,153 @@ namespace transform {
 				clGetDeviceInfo(device_id_, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
 						sizeof(cl_ulong), &max_buf, NULL);
 #endif
+			typedef std::chrono::high_resolution_clock clock;
+
 			cl_event uploads[2];
 
-			auto start = util::timer_start();
+			clock::time_point start = clock::now();
 
 			// Apply the kernel
 			// 
-			cl_mem x_in = make_cl_mem(x, &uploads[0]);
-			cl_mem y_in = make_cl_mem(y, &uploads[1]);
-
-			cl_mem x_out = make_cl_mem(out_x);
-			cl_mem y_out = make_cl_mem(out_y);
+			lane_guard guard(*this);
+			lane& l = guard.l;
 
-			clWaitForEvents(2, uploads);
+			// buffers go however the run ends, tracked events with the lane
+			detail::mem_guard buffers;
+			detail::event_guard pending(uploads, 2);
 
-			auto end = util::timer_end(start);
+			cl_mem x_in = buffers.hold(make_cl_mem(l.queue, x, &uploads[0]));
+			cl_mem y_in = buffers.hold(make_cl_mem(l.queue, y, &uploads[1]));
 
-			detail::opencl_kernel_wrapper<TDeviceType,TTransform>::configure(context_, p, x_in, y_in, x_out, y_out, size);
+			cl_mem x_out = buffers.hold(make_cl_mem(out_x));
+			cl_mem y_out = buffers.hold(make_cl_mem(out_y));
 
-			cl_kernel kernel = detail::opencl_kernel_wrapper<TDeviceType,TTransform>::kernel();
+			detail::wait_for_events(uploads, 2);
+			pending.dismiss();
+			track(l, "upload", "upload x", uploads[0]);
+			track(l, "upload", "upload y", uploads[1]);
 
-			err = clEnqueueNDRangeKernel(queue_, kernel, 1, NULL, &size, NULL, 0, NULL, NULL);
-			if (err != CL_SUCCESS) {
-				throw std::runtime_error("Failed to execute kernel");
-			}
+			enqueue(l, p, x_in, y_in, x_out, y_out, size);
 
-			clFinish(queue_);
+			clFinish(l.queue);
 
 			cl_event downloads[2];
-			download_to_host(queue_, x_out, out_x, &downloads[0]);
-			download_to_host(queue_, y_out, out_y, &downloads[1]);
+			download_to_host(l.queue, x_out, out_x, &downloads[0]);
+			download_to_host(l.queue, y_out, out_y, &downloads[1]);
 
 			// wait for downloads to finish
-			clWaitForEvents(2, downloads);
+			detail::wait_for_events(downloads, 2);
+			track(l, "download", "download x", downloads[0]);
+			track(l, "download", "download y", downloads[1]);
+
+			record(l, size, std::chrono::duration<double>(clock::now() - start).count());
+		}
+
+		template<typename TDeviceType>
+		template<
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void opencl<TDeviceType>::run(const TTransform& p,
+			const ForwardIterableInputRange& x,
+			const ForwardIterableInputRange& y,
+			const ForwardIterableInputRange& z,
+			ForwardIterableOutputRange& out_x,
+			ForwardIterableOutputRange& out_y,
+			ForwardIterableOutputRange& out_z) const {
+			assert(boost::size(x) == boost::size(z));
+			assert(boost::size(out_x) == boost::size(out_z));
+
+			run3(p, x, y, z, out_x, out_y, out_z,
+					std::integral_constant<bool, is_3d<TTransform>::value>());
+		}
+
+		template<typename TDeviceType>
+		template<
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void opencl<TDeviceType>::run3(const TTransform& p,
+			const ForwardIterableInputRange& x,
+			const ForwardIterableInputRange& y,
+			const ForwardIterableInputRange& z,
+			ForwardIterableOutputRange& out_x,
+			ForwardIterableOutputRange& out_y,
+			ForwardIterableOutputRange& out_z, std::false_type) const {
+			run(p, x, y, out_x, out_y);
+			std::copy(boost::begin(z), boost::end(z), boost::begin(out_z));
+		}
+
+		template<typename TDeviceType>
+		template<
+			typename TTransform,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange
+		>
+		void opencl<TDeviceType>::run3(const TTransform& p,
+			const ForwardIterableInputRange& x,
+			const ForwardIterableInputRange& y,
+			const ForwardIterableInputRange& z,
+			ForwardIterableOutputRange& out_x,
+			ForwardIterableOutputRange& out_y,
+			ForwardIterableOutputRange& out_z, std::true_type) const {
+			size_t size = boost::size(x);
+
+			assert(size == boost::size(y));
+			assert(boost::size(out_x) == boost::size(y));
+			assert(boost::size(out_x) == boost::size(out_y));
+
+			if (size == 0)
+				return;
+
+			typedef std::chrono::high_resolution_clock clock;
+
+			cl_event uploads[3];
+
+			clock::time_point start = clock::now();
+
+			lane_guard guard(*this);
+			lane& l = guard.l;
+
+			detail::mem_guard buffers;
+			detail::event_guard pending(uploads, 3);
+
+			cl_mem x_in = buffers.hold(make_cl_mem(l.queue, x, &uploads[0]));
+			cl_mem y_in = buffers.hold(make_cl_mem(l.queue, y, &uploads[1]));
+			cl_mem z_in = buffers.hold(make_cl_mem(l.queue, z, &uploads[2]));
+
+			cl_mem x_out = buffers.hold(make_cl_mem(out_x));
+			cl_mem y_out = buffers.hold(make_cl_mem(out_y));
+			cl_mem z_out = buffers.hold(make_cl_mem(out_z));
+
+			detail::wait_for_events(uploads, 3);
+			pending.dismiss();
+			track(l, "upload", "upload x", uploads[0]);
+			track(l, "upload", "upload y", uploads[1]);
+			track(l, "upload", "upload z", uploads[2]);
+
+			cl_kernel k = kernel<TTransform>(l);
+
+			detail::kernel<TTransform>::configure_transform3(p, k,
+					x_in, y_in, z_in, x_out, y_out, z_out, size);
+
+			launch<TTransform>(l, k, size);
+
+			clFinish(l.queue);
+
+			cl_event downloads[3];
+			download_to_host(l.queue, x_out, out_x, &downloads[0]);
+			download_to_host(l.queue, y_out, out_y, &downloads[1]);
+			download_to_host(l.queue, z_out, out_z, &downloads[2]);
+
+			detail::wait_for_events(downloads, 3);
+			track(l, "download", "download x", downloads[0]);
+			track(l, "download", "download y", downloads[1]);
+			track(l, "download", "download z", downloads[2]);
 
-			// release allocated buffers
-			clReleaseMemObject(x_in);
-			clReleaseMemObject(y_in);
-			clReleaseMemObject(x_out);
-			clReleaseMemObject(y_out);
+			record(l, size, std::chrono::duration<double>(clock::now() - start).count());
 		}
 	}
 }
@@ -6,45 +6,23 @@
 namespace transform {
 	namespace backends {
 		namespace detail {
-			// kernel for scaling doubles
+			// kernel for the direct sum of thin-plate splines of doubles, control points and
+			// their weights come packed as (cx, cy, wx, wy) in their own buffer
 			//
 			template<>
-			struct kernel<transforms::scale<double>> {
-				static std::pair<cl_program, cl_kernel> load_transform(cl_context ctx, cl_device_id dev);
-				static void configure_transform(const transforms::scale<double>& s,
-						cl_kernel kernel,
-						cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements);
-			};
+			struct kernel<transforms::thin_plate_spline<double>> {
+				static std::string name() { return "thin_plate_spline"; }
 
-			// kernel for cartographc projection from lat-long to tmerc<double>, with sphere ellipsoid
-			//
-			template<>
-			struct kernel<transforms::projection<
-				cartographic::projections::latlong,
-				cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>> {
-				static std::pair<cl_program, cl_kernel> load_transform(cl_context ctx, cl_device_id dev);
-				static void configure_transform(
-					const transforms::projection<
-						cartographic::projections::latlong,
-						cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>& s,
-					cl_kernel kernel,
-					cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements);
+				static std::pair<cl_program, cl_kernel> load_transform(cl_context ctx, cl_device_id dev,
+						const std::string& options);
+				static void configure_transform(const transforms::thin_plate_spline<double>& s,
+						cl_kernel kernel, cl_mem controls,
+						cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements);
 			};
 
-			// kernel for cartographc projection from lat-long to tmerc<double>, with WGS84 ellipsoid
-			//
-			template<>
-			struct kernel<transforms::projection<
-				cartographic::projections::latlong,
-				cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>> {
-				static std::pair<cl_program, cl_kernel> load_transform(cl_context ctx, cl_device_id dev);
-				static void configure_transform(
-					const transforms::projection<
-						cartographic::projections::latlong,
-						cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>& s,
-					cl_kernel kernel,
-					cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements);
-			};
+			// everything else with a device_op (scales, affine transforms, homographies,
+			// polynomials, projections, Helmert transforms and datum shifts) is built from
+			// its device source by the primary template
 		}
 	}
 }
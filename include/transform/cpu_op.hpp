@@ -5,6 +5,16 @@
 #ifndef __transform_cpu_op_hpp__
 #define __transform_cpu_op_hpp__
 
+#include <cstddef>
+#include <type_traits>
+
+// ask the compiler to vectorize batch kernel loops, needs -fopenmp-simd (see WITH_OPENMP_SIMD)
+#if defined(TRANSFORM_OPENMP_SIMD)
+#define TRANSFORM_SIMD_LOOP _Pragma("omp simd")
+#else
+#define TRANSFORM_SIMD_LOOP
+#endif
+
 namespace transform {
 	template<
 		typename TDerived,
@@ -17,22 +27,94 @@ namespace transform {
 				"You need to specialize transform op for the projections you intend to use");
 	}
 
+	// transform count contiguous points in one go.  The default visits every point, transforms
+	// with branch free kernels specialize this so loops can be vectorized.
+	template<
+		typename TTransform,
+		typename TValue,
+		typename TOutput
+	>
+	void do_batch_op(const TTransform& p, const TValue *x, const TValue *y,
+			TOutput *ox, TOutput *oy, size_t count) {
+		for (size_t i = 0 ; i < count ; i ++) {
+			p.op(x[i], y[i], ox[i], oy[i]);
+		}
+	}
+
+	// 3D version of do_op.  Transforms which only work on x and y (projections between
+	// geodetic and planar coordinates) leave z as it is, transforms which need or change z
+	// specialize this instead of do_op.
+	template<
+		typename TTransform,
+		typename TValue,
+		typename TOutput
+	>
+	void do_op3(const TTransform& p, const TValue& x, const TValue& y, const TValue& z,
+			TOutput& ox, TOutput& oy, TOutput& oz) {
+		p.op(x, y, ox, oy);
+		oz = static_cast<TOutput>(z);
+	}
+
+	// 3D version of do_batch_op
+	template<
+		typename TTransform,
+		typename TValue,
+		typename TOutput
+	>
+	void do_batch_op3(const TTransform& p, const TValue *x, const TValue *y, const TValue *z,
+			TOutput *ox, TOutput *oy, TOutput *oz, size_t count) {
+		for (size_t i = 0 ; i < count ; i ++) {
+			do_op3(p, x[i], y[i], z[i], ox[i], oy[i], oz[i]);
+		}
+	}
+
+	// transforms which only make sense with a z coordinate (e.g. to and from geocentric
+	// coordinates) specialize this, backends use it to pick between 2D and 3D code paths
+	template<typename TTransform>
+	struct is_3d : std::false_type { };
+
+	// evaluate a transform over a regular grid, out is row major with one row per lat and
+	// one column per lon.  The default just visits every cell, transforms which can reuse
+	// per row and per column terms specialize this.
+	template<
+		typename TTransform,
+		typename TValue,
+		typename TOutput
+	>
+	void do_grid_op(const TTransform& p, const TValue *lon, size_t lon_count,
+			const TValue *lat, size_t lat_count, TOutput *ox, TOutput *oy) {
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			for (size_t c = 0 ; c < lon_count ; c ++) {
+				p.op(lon[c], lat[r], *ox++, *oy++);
+			}
+		}
+	}
+
 	template<typename TDerived>
 	struct cpu_op {
-		// we accept a refernce of the derived class (although they are the same object),
-		// to avoid code-smell with casting base types to derived types when we call do_op
-		// below
-		cpu_op(const TDerived& derived):
-			derived_(derived) { }
+		// derived classes pass themselves in for symmetry with earlier versions, the
+		// transform is recovered from this instead of being held on to, so copies of a
+		// transform (e.g. inside a composite) don't point back at the original
+		cpu_op(const TDerived&) { }
+
 		template<typename TValue, typename TOutput>
 		void op(const TValue& x, const TValue& y,
 				TOutput& ox, TOutput& oy) const {
 			// assumption is that cpu_op is used as a base class and TTransform is the
 			// derived class
-			do_op<TDerived, TValue, TOutput>(derived_, x, y, ox, oy);
+			do_op<TDerived, TValue, TOutput>(derived(), x, y, ox, oy);
 		}
 
-		const TDerived& derived_;
+		template<typename TValue, typename TOutput>
+		void op(const TValue& x, const TValue& y, const TValue& z,
+				TOutput& ox, TOutput& oy, TOutput& oz) const {
+			do_op3<TDerived, TValue, TOutput>(derived(), x, y, z, ox, oy, oz);
+		}
+
+		private:
+		const TDerived& derived() const {
+			return static_cast<const TDerived&>(*this);
+		}
 	};
 };
 
@@ -0,0 +1,96 @@
+// device.hpp
+// Transform math shared by the CPU and OpenCL backends
+//
+
+#ifndef __transform_device_hpp__
+#define __transform_device_hpp__
+
+#include <cmath>
+#include <string>
+
+// Kernels are written once, in the subset of C that C++ and OpenCL C share: doubles only,
+// structs of doubles for constants, pointers for outputs and ternaries rather than
+// branches where batches should vectorize.  TRANSFORM_DEVICE_SOURCE compiles its body as
+// inline C++ (in whatever namespace it is used in, transform::device by convention) and
+// keeps the text in name_source() for the OpenCL backend to build.  Macros in the body
+// are not expanded in the text, so TRANSFORM_DEVICE is left for the OpenCL prelude to
+// define away and HUGE_VAL and M_PI come from the device compiler.
+//
+#define TRANSFORM_DEVICE inline
+
+#define TRANSFORM_DEVICE_SOURCE(name, ...) \
+	__VA_ARGS__ \
+	inline const char *name##_source() { return #__VA_ARGS__; }
+
+namespace transform {
+	namespace device {
+		TRANSFORM_DEVICE_SOURCE(common,
+			TRANSFORM_DEVICE double to_radians(double v) {
+				return v * 0.017453292519943295769236907684886;
+			}
+
+			TRANSFORM_DEVICE double to_degrees(double v) {
+				return v * 57.295779513082320876798154814105;
+			}
+
+			TRANSFORM_DEVICE double mod_pi(double v) {
+				return fabs(v) > M_PI ? v - (v > 0.0 ? 2.0 * M_PI : -2.0 * M_PI) : v;
+			}
+
+			// meridional distance for the series coefficients en
+			TRANSFORM_DEVICE double mlfn(const double *en, double phi, double sphi, double cphi) {
+				cphi *= sphi;
+				sphi *= sphi;
+
+				return en[0] * phi - cphi * (en[1] + sphi * (en[2] + sphi * (en[3] + sphi * en[4])));
+			}
+
+			// latitude from the meridional distance with a fixed number of Newton steps
+			TRANSFORM_DEVICE double inv_mlfn(const double *en, double es, double arg) {
+				double k = 1.0 / (1.0 - es);
+				double phi = arg;
+
+				for (int i = 0 ; i < 5 ; i ++) {
+					double s = sin(phi), c = cos(phi);
+					double t = 1.0 - es * s * s;
+
+					phi -= (mlfn(en, phi, s, c) - arg) * (t * sqrt(t)) * k;
+				}
+
+				return phi;
+			}
+
+			// isometric latitude term used by conformal projections
+			TRANSFORM_DEVICE double tsfn(double phi, double sinphi, double e) {
+				double es = sinphi * e;
+				return tan(0.5 * (M_PI_2 - phi)) / pow((1.0 - es) / (1.0 + es), 0.5 * e);
+			}
+
+			// and back, every one of the fixed iterations shrinks the error by about es
+			TRANSFORM_DEVICE double phi2(double ts, double e) {
+				double he = 0.5 * e;
+				double phi = M_PI_2 - 2.0 * atan(ts);
+
+				for (int i = 0 ; i < 8 ; i ++) {
+					double con = e * sin(phi);
+					phi = M_PI_2 - 2.0 * atan(ts * pow((1.0 - con) / (1.0 + con), he));
+				}
+
+				return phi;
+			}
+		)
+	}
+
+	// how a transform runs from its device source: the source (including what it depends
+	// on), the function to call for each point and the struct of constants it is called
+	// with.  2D functions take (c, x, y, &ox, &oy), 3D ones (see is_3d) also take z and &oz.
+	// The OpenCL backend builds kernels for every transform with a specialization.
+	//
+	template<typename T>
+	struct device_op {
+		static_assert(sizeof(T) == 0,
+				"This transform has no device source, specialize device_op or the OpenCL kernel for it");
+	};
+}
+
+#endif // __transform_device_hpp__
@@ -0,0 +1,289 @@
+// grids.hpp
+// Memory mapped NTv2 and GTX grid shift files
+//
+
+#ifndef __transform_grids_hpp__
+#define __transform_grids_hpp__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace transform {
+	namespace grids {
+		// read only mapping of a whole file.  Nothing is read up front, the OS pages grid
+		// nodes in as lookups touch them and keeps recently used pages cached, so only the
+		// parts of a grid a workload actually covers ever make it into memory.
+		//
+		class mapped_file {
+			public:
+			explicit mapped_file(const std::string& path);
+			~mapped_file();
+
+			mapped_file(const mapped_file&) = delete;
+			mapped_file& operator=(const mapped_file&) = delete;
+
+			const unsigned char *data() const { return data_; }
+			size_t size() const { return size_; }
+
+			private:
+			const unsigned char *data_;
+			size_t size_;
+		};
+
+		namespace detail {
+			static inline uint32_t swap32(uint32_t v) {
+				return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+			}
+
+			// grid values are read straight out of the mapping, swapping bytes when the file
+			// and host byte orders differ
+			static inline float load_float(const unsigned char *p, bool swap) {
+				uint32_t v;
+				std::memcpy(&v, p, sizeof(v));
+				if (swap)
+					v = swap32(v);
+
+				float f;
+				std::memcpy(&f, &v, sizeof(f));
+				return f;
+			}
+
+			static inline double bilinear(double v00, double v01, double v10, double v11,
+					double tx, double ty) {
+				double bottom = v00 + (v01 - v00) * tx,
+					   top = v10 + (v11 - v10) * tx;
+
+				return bottom + (top - bottom) * ty;
+			}
+		}
+
+		// one NTv2 sub-grid.  Limits and increments are in arc seconds with longitudes
+		// positive west, as in the file.  Nodes run west from the south east corner one row
+		// at a time, each node is four floats: latitude shift, longitude shift and their
+		// accuracies.
+		//
+		struct ntv2_subgrid {
+			std::string name, parent;
+
+			double s_lat, n_lat, e_lon, w_lon;
+			double lat_inc, lon_inc;
+			size_t rows, cols;
+
+			const unsigned char *nodes;
+
+			// more detailed sub-grids inside this one
+			std::vector<size_t> children;
+
+			// the first cache bucket of this sub-grid and how many buckets a row of them has
+			size_t bucket_base, buckets_x;
+
+			bool contains(double lat, double lon_w) const {
+				return lat >= s_lat && lat <= n_lat && lon_w >= e_lon && lon_w <= w_lon;
+			}
+		};
+
+		// an NTv2 horizontal grid shift file (either byte order).  Sub-grids are indexed by
+		// their parents so lookups only test the grids nested in the one a point falls in.
+		//
+		// For batch lookups every sub-grid is split into square buckets of
+		// bucket_cells x bucket_cells cells, points sorted by bucket touch grid memory in
+		// order instead of all over the file.
+		//
+		class ntv2 {
+			public:
+			static const size_t npos = static_cast<size_t>(-1);
+			static const size_t bucket_cells = 16;
+
+			explicit ntv2(const std::string& path);
+
+			// shift (in degrees, longitude positive east) at lon, lat (degrees), false when
+			// no sub-grid covers the point
+			bool shift(double lon, double lat, double& dlon, double& dlat) const {
+				double lat_s = lat * 3600., lon_w = -lon * 3600.;
+
+				size_t g = locate(lat_s, lon_w);
+				if (g == npos)
+					return false;
+
+				interpolate(g, lat_s, lon_w, dlon, dlat);
+				return true;
+			}
+
+			// the most detailed sub-grid containing the point (arc seconds, positive west) or
+			// npos
+			size_t locate(double lat_s, double lon_w) const {
+				for (size_t r : roots_) {
+					if (!subgrids_[r].contains(lat_s, lon_w))
+						continue;
+
+					size_t g = r;
+					for (bool descend = true ; descend ; ) {
+						descend = false;
+						for (size_t c : subgrids_[g].children) {
+							if (subgrids_[c].contains(lat_s, lon_w)) {
+								g = c;
+								descend = true;
+								break;
+							}
+						}
+					}
+
+					return g;
+				}
+
+				return npos;
+			}
+
+			// bilinear interpolation of the shifts in sub-grid g, output in degrees with
+			// longitude positive east
+			void interpolate(size_t g, double lat_s, double lon_w, double& dlon, double& dlat) const {
+				const ntv2_subgrid& s = subgrids_[g];
+
+				size_t c, r;
+				double tx, ty;
+				cell(s, lat_s, lon_w, r, c, tx, ty);
+
+				const unsigned char *n00 = s.nodes + (r * s.cols + c) * 16,
+					  *n01 = n00 + 16,
+					  *n10 = n00 + s.cols * 16,
+					  *n11 = n10 + 16;
+
+				double slat = detail::bilinear(
+						detail::load_float(n00, swap_), detail::load_float(n01, swap_),
+						detail::load_float(n10, swap_), detail::load_float(n11, swap_), tx, ty);
+				double slon = detail::bilinear(
+						detail::load_float(n00 + 4, swap_), detail::load_float(n01 + 4, swap_),
+						detail::load_float(n10 + 4, swap_), detail::load_float(n11 + 4, swap_), tx, ty);
+
+				dlat = slat / 3600.;
+				dlon = -slon / 3600.;
+			}
+
+			// cache bucket of a point in sub-grid g
+			size_t bucket(size_t g, double lat_s, double lon_w) const {
+				const ntv2_subgrid& s = subgrids_[g];
+
+				size_t c, r;
+				double tx, ty;
+				cell(s, lat_s, lon_w, r, c, tx, ty);
+
+				return s.bucket_base + (r / bucket_cells) * s.buckets_x + c / bucket_cells;
+			}
+
+			size_t bucket_count() const { return bucket_count_; }
+
+			const std::vector<ntv2_subgrid>& subgrids() const { return subgrids_; }
+
+			private:
+			static void cell(const ntv2_subgrid& s, double lat_s, double lon_w,
+					size_t& r, size_t& c, double& tx, double& ty) {
+				double fx = (lon_w - s.e_lon) / s.lon_inc,
+					   fy = (lat_s - s.s_lat) / s.lat_inc;
+
+				// points on the north and west edges use the last cell
+				c = std::min(static_cast<size_t>(fx), s.cols - 2);
+				r = std::min(static_cast<size_t>(fy), s.rows - 2);
+
+				tx = fx - c;
+				ty = fy - r;
+			}
+
+			mapped_file file_;
+			bool swap_;
+
+			std::vector<ntv2_subgrid> subgrids_;
+			std::vector<size_t> roots_;
+			size_t bucket_count_;
+		};
+
+		// a GTX vertical grid (geoid undulations or other height offsets in meters), always
+		// big endian.  Rows run north from the south west corner.
+		//
+		class gtx {
+			public:
+			static const size_t bucket_cells = 16;
+
+			explicit gtx(const std::string& path);
+
+			// the grid value at lon, lat (degrees), false when the point is off the grid or
+			// next to a node without data
+			bool value(double lon, double lat, double& v) const {
+				size_t r, c;
+				double tx, ty;
+
+				if (!cell(lon, lat, r, c, tx, ty))
+					return false;
+
+				const unsigned char *p00 = data_ + (r * cols + c) * 4,
+					  *p01 = p00 + 4,
+					  *p10 = p00 + cols * 4,
+					  *p11 = p10 + 4;
+
+				float v00 = detail::load_float(p00, swap_), v01 = detail::load_float(p01, swap_),
+					  v10 = detail::load_float(p10, swap_), v11 = detail::load_float(p11, swap_);
+
+				if (nodata(v00) || nodata(v01) || nodata(v10) || nodata(v11))
+					return false;
+
+				v = detail::bilinear(v00, v01, v10, v11, tx, ty);
+				return true;
+			}
+
+			// cache bucket of a point, bucket_count() for points off the grid
+			size_t bucket(double lon, double lat) const {
+				size_t r, c;
+				double tx, ty;
+
+				if (!cell(lon, lat, r, c, tx, ty))
+					return bucket_count_;
+
+				return (r / bucket_cells) * buckets_x_ + c / bucket_cells;
+			}
+
+			size_t bucket_count() const { return bucket_count_; }
+
+			// lower left node and spacing in degrees
+			double lat_origin, lon_origin;
+			double lat_inc, lon_inc;
+			size_t rows, cols;
+
+			private:
+			static bool nodata(float v) {
+				return std::abs(v + 88.8888f) < 1e-4f;
+			}
+
+			bool cell(double lon, double lat, size_t& r, size_t& c, double& tx, double& ty) const {
+				double dlon = std::fmod(lon - lon_origin, 360.);
+				if (dlon < 0.)
+					dlon += 360.;
+
+				double fx = dlon / lon_inc,
+					   fy = (lat - lat_origin) / lat_inc;
+
+				// negated so NaNs end up off the grid too
+				if (!(fx <= cols - 1 && fy >= 0. && fy <= rows - 1))
+					return false;
+
+				c = std::min(static_cast<size_t>(fx), cols - 2);
+				r = std::min(static_cast<size_t>(fy), rows - 2);
+
+				tx = fx - c;
+				ty = fy - r;
+				return true;
+			}
+
+			mapped_file file_;
+			bool swap_;
+			const unsigned char *data_;
+
+			size_t buckets_x_, bucket_count_;
+		};
+	}
+}
+
+#endif // __transform_grids_hpp__
@@ -0,0 +1,82 @@
+// span.hpp
+// Pointer and length ranges, and telling contiguous ranges apart at compile time
+//
+
+#ifndef __transform_span_hpp__
+#define __transform_span_hpp__
+
+#include <boost/range.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace transform {
+	// count elements starting at data, usable wherever backends take a range.  Like
+	// std::span (which needs C++20) it's a view, copies refer to the same elements.
+	template<typename T>
+	class span {
+		public:
+		typedef T element_type;
+		typedef typename std::remove_cv<T>::type value_type;
+		typedef T& reference;
+		typedef T *pointer;
+		typedef T *iterator;
+		typedef T *const_iterator;
+		typedef size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+
+		span() : data_(NULL), size_(0) { }
+		span(T *data, size_t size) : data_(data), size_(size) { }
+
+		T *data() const { return data_; }
+		size_t size() const { return size_; }
+		bool empty() const { return size_ == 0; }
+
+		T *begin() const { return data_; }
+		T *end() const { return data_ + size_; }
+
+		T& operator[](size_t i) const { return data_[i]; }
+
+		private:
+		T *data_;
+		size_t size_;
+	};
+
+	template<typename T>
+	span<T> make_span(T *data, size_t size) {
+		return span<T>(data, size);
+	}
+
+	// iterators over elements laid out one after the other in memory: pointers and
+	// std::vector iterators, and anything modelling std::contiguous_iterator under C++20
+	template<
+		typename TIterator,
+		typename TValue = typename std::iterator_traits<TIterator>::value_type
+	>
+	struct is_contiguous_iterator : std::integral_constant<bool,
+		std::is_pointer<TIterator>::value ||
+		(!std::is_same<TValue, bool>::value &&
+			(std::is_same<TIterator, typename std::vector<TValue>::iterator>::value ||
+			 std::is_same<TIterator, typename std::vector<TValue>::const_iterator>::value))
+#if __cplusplus >= 202002L
+		|| std::contiguous_iterator<TIterator>
+#endif
+		> { };
+
+	template<typename TRange>
+	struct is_contiguous_range :
+		std::integral_constant<bool,
+			is_contiguous_iterator<typename boost::range_iterator<TRange>::type>::value> { };
+
+	namespace backends {
+		namespace detail {
+			// ranges which aren't contiguous (deques, transformed views) go through scratch
+			// buffers of this many points at a time to reach the batch kernels
+			static const size_t staging_points = 16384;
+		}
+	}
+}
+
+#endif // __transform_span_hpp__
@@ -5,19 +5,31 @@
 #ifndef __transform_transforms_basic_hpp__
 #define __transform_transforms_basic_hpp__
 
+#include "basic_device.hpp"
+#include "../device.hpp"
+
 #include <cmath>
+#include <algorithm>
+#include <string>
 
 namespace transform {
 	namespace transforms {
 		template<typename T, typename TOut>
 		struct basic_scale {
 			T s;
-			basic_scale(const T& _s) : s(_s) { }
+			basic_scale(const T& _s) : s(_s) {
+				consts.s = s;
+			}
 
 			void op(const T& x, const T& y, TOut& xo, TOut&yo) const {
-				xo = static_cast<TOut>(s * x);
-				yo = static_cast<TOut>(s * y);
+				double dx, dy;
+				device::scale_apply(&consts, x, y, &dx, &dy);
+
+				xo = static_cast<TOut>(dx);
+				yo = static_cast<TOut>(dy);
 			}
+
+			device::scale_constants consts;
 		};
 
 		template<typename T>
@@ -25,6 +37,92 @@ namespace transform {
 			scale(const T& s) : basic_scale<T, T>(s) { }
 		};
 
+		// six parameter affine transform in GDAL geotransform order, mostly pixel to world
+		// for georeferenced images:
+		//
+		//   xo = c[0] + c[1] * x + c[2] * y
+		//   yo = c[3] + c[4] * x + c[5] * y
+		//
+		template<typename T>
+		struct affine {
+			T c[6];
+
+			affine(const T& c0, const T& c1, const T& c2, const T& c3, const T& c4, const T& c5) {
+				c[0] = c0; c[1] = c1; c[2] = c2;
+				c[3] = c3; c[4] = c4; c[5] = c5;
+
+				std::copy(c, c + 6, consts.c);
+			}
+
+			template<typename TOut>
+			void op(const T& x, const T& y, TOut& xo, TOut& yo) const {
+				double dx, dy;
+				device::affine_apply(&consts, x, y, &dx, &dy);
+
+				xo = static_cast<TOut>(dx);
+				yo = static_cast<TOut>(dy);
+			}
+
+			// world to pixel from pixel to world, the linear part must not be singular
+			affine inverse() const {
+				T det = c[1] * c[5] - c[2] * c[4];
+				T i1 = c[5] / det, i2 = -c[2] / det,
+				  i4 = -c[4] / det, i5 = c[1] / det;
+
+				return affine(-(i1 * c[0] + i2 * c[3]), i1, i2,
+						-(i4 * c[0] + i5 * c[3]), i4, i5);
+			}
+
+			// the coefficients as the kernels take them, worked out once
+			device::affine_constants consts;
+		};
+
+		// eight parameter projective transform (a 3x3 matrix with the last element fixed
+		// to 1), for imagery of planes seen at an angle:
+		//
+		//   w  = h[6] * x + h[7] * y + 1
+		//   xo = (h[0] * x + h[1] * y + h[2]) / w
+		//   yo = (h[3] * x + h[4] * y + h[5]) / w
+		//
+		template<typename T>
+		struct homography {
+			T h[8];
+
+			homography(const T *coefficients) {
+				std::copy(coefficients, coefficients + 8, h);
+				std::copy(h, h + 8, consts.h);
+			}
+
+			template<typename TOut>
+			void op(const T& x, const T& y, TOut& xo, TOut& yo) const {
+				double dx, dy;
+				device::homography_apply(&consts, x, y, &dx, &dy);
+
+				xo = static_cast<TOut>(dx);
+				yo = static_cast<TOut>(dy);
+			}
+
+			// the matrix inverse, rescaled so its last element is 1 again
+			homography inverse() const {
+				const T m[9] = { h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7], 1 };
+				T a[9] = {
+					m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8], m[1] * m[5] - m[2] * m[4],
+					m[5] * m[6] - m[3] * m[8], m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+					m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7], m[0] * m[4] - m[1] * m[3]
+				};
+
+				// the adjugate is the inverse up to scale, which a homography doesn't care about
+				T out[8];
+				for (int i = 0 ; i < 8 ; i ++)
+					out[i] = a[i] / a[8];
+
+				return homography(out);
+			}
+
+			// the coefficients as the kernels take them, worked out once
+			device::homography_constants consts;
+		};
+
 		template<typename T, typename TOut>
 		struct sine_cosine {
 			void op(const T& x, const T& y, TOut& xo, TOut& yo) const {
@@ -33,5 +131,47 @@ namespace transform {
 			}
 		};
 	}
+
+	template<>
+	struct device_op<transforms::scale<double>> {
+		typedef device::scale_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::scale_source();
+		}
+
+		static const char *function() { return "scale_apply"; }
+		static const char *constants_name() { return "scale_constants"; }
+
+		static const constants_type& constants(const transforms::scale<double>& p) { return p.consts; }
+	};
+
+	template<>
+	struct device_op<transforms::affine<double>> {
+		typedef device::affine_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::affine_source();
+		}
+
+		static const char *function() { return "affine_apply"; }
+		static const char *constants_name() { return "affine_constants"; }
+
+		static const constants_type& constants(const transforms::affine<double>& p) { return p.consts; }
+	};
+
+	template<>
+	struct device_op<transforms::homography<double>> {
+		typedef device::homography_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::homography_source();
+		}
+
+		static const char *function() { return "homography_apply"; }
+		static const char *constants_name() { return "homography_constants"; }
+
+		static const constants_type& constants(const transforms::homography<double>& p) { return p.consts; }
+	};
 };
 #endif // __transform_transforms_basic_hpp__
@@ -0,0 +1,56 @@
+// basic_device.hpp
+// Scale, affine and homography kernels shared by the CPU and OpenCL backends, see device.hpp
+//
+
+#ifndef __transform_transforms_basic_device_hpp__
+#define __transform_transforms_basic_device_hpp__
+
+#include "../device.hpp"
+
+namespace transform {
+	namespace device {
+		TRANSFORM_DEVICE_SOURCE(scale,
+			typedef struct {
+				double s;
+			} scale_constants;
+
+			TRANSFORM_DEVICE void scale_apply(const scale_constants *c,
+					double x, double y, double *ox, double *oy) {
+				*ox = c->s * x;
+				*oy = c->s * y;
+			}
+		)
+
+		// coefficients in GDAL geotransform order, see affine
+		//
+		TRANSFORM_DEVICE_SOURCE(affine,
+			typedef struct {
+				double c[6];
+			} affine_constants;
+
+			TRANSFORM_DEVICE void affine_apply(const affine_constants *c,
+					double x, double y, double *ox, double *oy) {
+				*ox = c->c[0] + c->c[1] * x + c->c[2] * y;
+				*oy = c->c[3] + c->c[4] * x + c->c[5] * y;
+			}
+		)
+
+		// the 3x3 matrix row major without its last element, which is 1
+		//
+		TRANSFORM_DEVICE_SOURCE(homography,
+			typedef struct {
+				double h[8];
+			} homography_constants;
+
+			TRANSFORM_DEVICE void homography_apply(const homography_constants *c,
+					double x, double y, double *ox, double *oy) {
+				double w = c->h[6] * x + c->h[7] * y + 1.;
+
+				*ox = (c->h[0] * x + c->h[1] * y + c->h[2]) / w;
+				*oy = (c->h[3] * x + c->h[4] * y + c->h[5]) / w;
+			}
+		)
+	}
+}
+
+#endif // __transform_transforms_basic_device_hpp__
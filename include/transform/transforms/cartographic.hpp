@@ -8,9 +8,13 @@
 #include <string>
 #include <cmath>
 #include <type_traits>
+#include <algorithm>
+#include <stdexcept>
 
 #include "../cpu_op.hpp"
+#include "../device.hpp"
 #include "../utility.hpp"
+#include "cartographic_device.hpp"
 
 namespace transform {
 	namespace cartographic {
@@ -49,6 +53,39 @@ namespace transform {
 				};
 
 			};
+
+			// an ellipsoid only known at runtime (e.g. loaded from configuration), all the
+			// derived constants are worked out once when it is constructed
+			//
+			struct runtime {
+				static constexpr const char *name = "runtime";
+
+				// an inverse flattening of 0 or less makes a sphere
+				runtime(double a, double rf) : major_axis(a), inverse_flattening(rf) {
+					double f = (rf <= 0.0) ? 0.0 : 1.0 / rf;
+
+					ecc2 = f * (2.0 - f);
+					one_ecc2 = 1.0 - ecc2;
+					ecc = std::sqrt(ecc2);
+					minor_axis = a * (1.0 - f);
+
+					util::projection::enfn(ecc2, en);
+				}
+
+				template<typename TEllipsoid>
+				static runtime of() {
+					typedef typename TEllipsoid::params p;
+					double f = 1.0 - std::sqrt(p::one_ecc2);
+
+					return runtime(p::major_axis, f <= 0.0 ? 0.0 : 1.0 / f);
+				}
+
+				bool spherical() const { return ecc2 <= 0.0; }
+
+				double major_axis, minor_axis, inverse_flattening;
+				double ecc2, one_ecc2, ecc;
+				double en[5];
+			};
 		}
 
 		namespace projections {
@@ -61,18 +98,387 @@ namespace transform {
 				latlong() : base_projection("latlong") { }
 			};
 
+			// spherical mercator on the WGS84 major axis as used by web maps (EPSG:3857),
+			// latitudes of +/-90 project to infinity
+			//
+			struct webmerc : base_projection {
+				static constexpr double radius = 6378137.0;
+
+				webmerc() : base_projection("webmerc") {
+					consts.a = radius;
+				}
+
+				device::webmerc_constants consts;
+			};
+
+			// transverse mercator, offset is the false easting and northing added to the
+			// projected coordinates, lat_0/lon_0 (in degrees) are the origin and central
+			// meridian and k_0 the scale factor on the central meridian
+			//
 			template<typename TEllipsoid, typename T>
 			struct tmerc : base_projection {
 				typedef typename std::pair<T, T> offset_t;
 				typedef TEllipsoid ellipsoid_type;
 
-
 				tmerc(const offset_t& off) : base_projection("tmerc"), offset(off),
-					ml0(util::projection::mlfn<TEllipsoid>(offset.second)) {
+					phi0(0), lambda0(0), k0(1),
+					ml0(util::projection::mlfn<TEllipsoid>(phi0)) {
+					init_consts();
+				}
+
+				tmerc(const offset_t& off, const T& lat_0, const T& lon_0, const T& k_0) :
+					base_projection("tmerc"), offset(off),
+					phi0(lat_0 * util::TO_RADIANS), lambda0(lon_0 * util::TO_RADIANS), k0(k_0),
+					ml0(util::projection::mlfn<TEllipsoid>(phi0)) {
+					init_consts();
 				}
 
 				offset_t offset;
+				T phi0, lambda0;	// radians
+				T k0;
 				T ml0;
+
+				device::tmerc_constants consts;
+
+				private:
+				void init_consts() {
+					typedef typename TEllipsoid::params p;
+
+					consts.scale = p::major_axis * k0;
+					consts.k0 = k0;
+					consts.ecc2 = p::ecc2;
+					consts.one_ecc2 = p::one_ecc2;
+					consts.esp = p::ecc2 / p::one_ecc2;
+					consts.en[0] = p::en0;
+					consts.en[1] = p::en1;
+					consts.en[2] = p::en2;
+					consts.en[3] = p::en3;
+					consts.en[4] = p::en4;
+					consts.ml0 = ml0;
+					consts.phi0 = phi0;
+					consts.lambda0 = lambda0;
+					consts.x0 = offset.first;
+					consts.y0 = offset.second;
+					consts.spherical = (p::ecc2 <= 0.0) ? 1. : 0.;
+				}
+			};
+
+			// tmerc for a runtime ellipsoid
+			//
+			template<typename T>
+			struct tmerc<ellipsoids::runtime, T> : base_projection {
+				typedef typename std::pair<T, T> offset_t;
+				typedef ellipsoids::runtime ellipsoid_type;
+
+				tmerc(const ellipsoids::runtime& e, const offset_t& off,
+						const T& lat_0 = 0, const T& lon_0 = 0, const T& k_0 = 1) :
+					base_projection("tmerc"), ellipsoid(e), offset(off),
+					phi0(lat_0 * util::TO_RADIANS), lambda0(lon_0 * util::TO_RADIANS), k0(k_0),
+					ml0(util::projection::mlfn(ellipsoid.en, phi0, std::sin(phi0), std::cos(phi0))) {
+					consts.scale = ellipsoid.major_axis * k0;
+					consts.k0 = k0;
+					consts.ecc2 = ellipsoid.ecc2;
+					consts.one_ecc2 = ellipsoid.one_ecc2;
+					consts.esp = ellipsoid.ecc2 / ellipsoid.one_ecc2;
+					std::copy(ellipsoid.en, ellipsoid.en + 5, consts.en);
+					consts.ml0 = ml0;
+					consts.phi0 = phi0;
+					consts.lambda0 = lambda0;
+					consts.x0 = offset.first;
+					consts.y0 = offset.second;
+					consts.spherical = ellipsoid.spherical() ? 1. : 0.;
+				}
+
+				ellipsoids::runtime ellipsoid;
+				offset_t offset;
+				T phi0, lambda0;	// radians
+				T k0;
+				T ml0;
+
+				device::tmerc_constants consts;
+			};
+
+			// UTM zones are tmerc with fixed parameters
+			//
+			template<typename TEllipsoid, typename T>
+			tmerc<TEllipsoid, T> utm(int zone, bool south = false) {
+				typedef typename tmerc<TEllipsoid, T>::offset_t offset_t;
+
+				return tmerc<TEllipsoid, T>(offset_t(500000.0, south ? 10000000.0 : 0.0),
+						0.0, -183.0 + 6.0 * zone, 0.9996);
+			}
+
+			template<typename T>
+			tmerc<ellipsoids::runtime, T> utm(const ellipsoids::runtime& e, int zone, bool south = false) {
+				typedef typename tmerc<ellipsoids::runtime, T>::offset_t offset_t;
+
+				return tmerc<ellipsoids::runtime, T>(e,
+						offset_t(500000.0, south ? 10000000.0 : 0.0),
+						0.0, -183.0 + 6.0 * zone, 0.9996);
+			}
+
+			// zone a point falls in, including the Norway and Svalbard exceptions.  Points
+			// which aren't in any zone, with a longitude outside [-180, 180] or coordinates
+			// which aren't finite, get 0.
+			//
+			template<typename T>
+			int utm_zone(const T& lon, const T& lat) {
+				// before the cast, which is undefined for NaN and huge values
+				if (!(lon >= -180.0 && lon <= 180.0) || !std::isfinite(lat))
+					return 0;
+
+				int zone = static_cast<int>(std::floor((lon + 180.0) / 6.0)) + 1;
+				zone = std::max(1, std::min(zone, 60));
+
+				if (lat >= 56.0 && lat < 64.0 && lon >= 3.0 && lon < 12.0)
+					return 32;
+
+				if (lat >= 72.0 && lat < 84.0 && lon >= 0.0 && lon < 42.0) {
+					if (lon < 9.0) return 31;
+					if (lon < 21.0) return 33;
+					if (lon < 33.0) return 35;
+					return 37;
+				}
+
+				return zone;
+			}
+
+			// lambert conformal conic, lat_1/lat_2 (in degrees) are the standard parallels,
+			// lat_0/lon_0 the origin and k_0 the scale factor.  The one standard parallel
+			// variant has lat_1 == lat_2 (usually equal to lat_0 as well) and a scale factor,
+			// see lcc_1sp
+			//
+			template<typename TEllipsoid, typename T>
+			struct lcc : base_projection {
+				typedef typename std::pair<T, T> offset_t;
+				typedef TEllipsoid ellipsoid_type;
+
+				lcc(const offset_t& off, const T& lat_1, const T& lat_2,
+						const T& lat_0, const T& lon_0, const T& k_0 = 1) :
+					base_projection("lcc"), offset(off),
+					phi1(lat_1 * util::TO_RADIANS), phi2(lat_2 * util::TO_RADIANS),
+					phi0(lat_0 * util::TO_RADIANS), lambda0(lon_0 * util::TO_RADIANS), k0(k_0) {
+					typedef typename TEllipsoid::params p;
+					using namespace util::projection;
+
+					const T EPS10 = 1e-10;
+
+					T e = p::ecc, es = p::ecc2;
+
+					T sinphi = std::sin(phi1), cosphi = std::cos(phi1);
+					bool secant = std::abs(phi1 - phi2) >= EPS10;
+					T n, c, rho0;
+
+					if (es > 0.0) {
+						T m1 = msfn(sinphi, cosphi, es);
+						T ml1 = tsfn(phi1, sinphi, e);
+
+						n = sinphi;
+						if (secant) {
+							T sinphi2 = std::sin(phi2);
+							n = std::log(m1 / msfn(sinphi2, std::cos(phi2), es)) /
+								std::log(ml1 / tsfn(phi2, sinphi2, e));
+						}
+
+						c = m1 * std::pow(ml1, -n) / n;
+						rho0 = (std::abs(std::abs(phi0) - M_PI_2) < EPS10) ? 0.0 :
+							c * std::pow(tsfn(phi0, std::sin(phi0), e), n);
+					}
+					else {
+						n = sinphi;
+						if (secant)
+							n = std::log(cosphi / std::cos(phi2)) /
+								std::log(std::tan(M_PI_4 + .5 * phi2) / std::tan(M_PI_4 + .5 * phi1));
+
+						c = cosphi * std::pow(std::tan(M_PI_4 + .5 * phi1), n) / n;
+						rho0 = (std::abs(std::abs(phi0) - M_PI_2) < EPS10) ? 0.0 :
+							c * std::pow(std::tan(M_PI_4 + .5 * phi0), -n);
+					}
+
+					consts.a = p::major_axis;
+					consts.k0 = k0;
+					consts.e = e;
+					consts.es = es;
+					consts.n = n;
+					consts.c = c;
+					consts.rho0 = rho0;
+					consts.lambda0 = lambda0;
+					consts.x0 = offset.first;
+					consts.y0 = offset.second;
+					consts.spherical = (es <= 0.0) ? 1. : 0.;
+				}
+
+				offset_t offset;
+				T phi1, phi2, phi0, lambda0;	// radians
+				T k0;
+
+				device::lcc_constants consts;
+			};
+
+			// lcc with a single standard parallel at the origin latitude
+			//
+			template<typename TEllipsoid, typename T>
+			lcc<TEllipsoid, T> lcc_1sp(const typename lcc<TEllipsoid, T>::offset_t& offset,
+					const T& lat_0, const T& lon_0, const T& k_0) {
+				return lcc<TEllipsoid, T>(offset, lat_0, lat_0, lat_0, lon_0, k_0);
+			}
+
+			// polar stereographic, lat_0 (in degrees) has to be 90 or -90.  The scale is either
+			// set by the latitude of true scale lat_ts or, when lat_ts is at the pole, by the
+			// scale factor k_0 at the pole (which is ignored otherwise, as in proj)
+			//
+			template<typename TEllipsoid, typename T>
+			struct stere : base_projection {
+				typedef typename std::pair<T, T> offset_t;
+				typedef TEllipsoid ellipsoid_type;
+
+				stere(const offset_t& off, const T& lat_0, const T& lat_ts,
+						const T& lon_0, const T& k_0 = 1) :
+					base_projection("stere"), offset(off),
+					phi0(lat_0 * util::TO_RADIANS), phits(std::abs(lat_ts) * util::TO_RADIANS),
+					lambda0(lon_0 * util::TO_RADIANS), k0(k_0) {
+					typedef typename TEllipsoid::params p;
+
+					const T EPS10 = 1e-10;
+
+					if (std::abs(std::abs(phi0) - M_PI_2) >= EPS10)
+						throw std::invalid_argument("stere only supports the polar aspects, lat_0 has to be +/-90");
+
+					T e = p::ecc;
+
+					if (std::abs(phits - M_PI_2) < EPS10) {
+						consts.akm1 = 2. * k0 /
+							std::sqrt(std::pow(1. + e, 1. + e) * std::pow(1. - e, 1. - e));
+					}
+					else {
+						T s = std::sin(phits);
+						consts.akm1 = std::cos(phits) / util::projection::tsfn(phits, s, e) /
+							std::sqrt(1. - e * e * s * s);
+					}
+
+					consts.a = p::major_axis;
+					consts.e = e;
+					consts.lambda0 = lambda0;
+					consts.x0 = offset.first;
+					consts.y0 = offset.second;
+					consts.sign = phi0 < 0. ? -1. : 1.;
+				}
+
+				offset_t offset;
+				T phi0, phits, lambda0;	// radians
+				T k0;
+
+				device::stere_constants consts;
+			};
+
+			// sinusoidal (Sanson-Flamsteed), equal area with straight parallels.  The
+			// spherical case is the ellipsoidal one with es = 0.
+			//
+			template<typename TEllipsoid, typename T>
+			struct sinu : base_projection {
+				typedef typename std::pair<T, T> offset_t;
+				typedef TEllipsoid ellipsoid_type;
+
+				sinu(const offset_t& off, const T& lon_0) :
+					base_projection("sinu"), offset(off), lambda0(lon_0 * util::TO_RADIANS) {
+					typedef typename TEllipsoid::params p;
+
+					consts.a = p::major_axis;
+					consts.es = p::ecc2;
+					util::projection::enfn<double>(consts.es, consts.en);
+					consts.lambda0 = lambda0;
+					consts.x0 = offset.first;
+					consts.y0 = offset.second;
+				}
+
+				offset_t offset;
+				T lambda0;	// radians
+
+				device::sinu_constants consts;
+			};
+
+			// the sinusoidal grid MODIS land products are tiled on, a sphere of radius
+			// 6371007.181 centred on Greenwich
+			//
+			template<typename T>
+			sinu<ellipsoids::sphere, T> modis_sinu() {
+				sinu<ellipsoids::sphere, T> s(typename sinu<ellipsoids::sphere, T>::offset_t(0, 0), 0);
+				s.consts.a = 6371007.181;
+				return s;
+			}
+
+			// the axis a geostationary imager sweeps around, GOES is x and Meteosat and
+			// Himawari are y
+			//
+			enum class sweep_axis { x, y };
+
+			// geostationary satellite view, h is the satellite height above the ellipsoid in
+			// meters and output is the scanning angle times h.  Points on the far side of the
+			// earth (forward) and scan angles which miss the earth (inverse) come out as
+			// infinity.
+			//
+			template<typename TEllipsoid, typename T>
+			struct geos : base_projection {
+				typedef typename std::pair<T, T> offset_t;
+				typedef TEllipsoid ellipsoid_type;
+
+				geos(const offset_t& off, const T& h_, const T& lon_0,
+						sweep_axis sweep_ = sweep_axis::y) :
+					base_projection("geos"), offset(off), h(h_),
+					lambda0(lon_0 * util::TO_RADIANS), sweep(sweep_) {
+					typedef typename TEllipsoid::params p;
+
+					if (h <= 0)
+						throw std::invalid_argument("geos needs a positive satellite height");
+
+					consts.a = p::major_axis;
+					consts.radius_g_1 = h / p::major_axis;
+					consts.radius_g = 1. + consts.radius_g_1;
+					consts.c = consts.radius_g * consts.radius_g - 1.;
+					consts.radius_p = std::sqrt(p::one_ecc2);
+					consts.radius_p2 = p::one_ecc2;
+					consts.radius_p_inv2 = 1. / p::one_ecc2;
+					consts.lambda0 = lambda0;
+					consts.x0 = offset.first;
+					consts.y0 = offset.second;
+					consts.flip_axis = (sweep == sweep_axis::x) ? 1. : 0.;
+				}
+
+				offset_t offset;
+				T h;
+				T lambda0;	// radians
+				sweep_axis sweep;
+
+				device::geos_constants consts;
+			};
+
+			inline device::geocent_constants make_geocent_constants(double a, double es) {
+				device::geocent_constants c;
+
+				c.a = a;
+				c.es = es;
+				c.one_es = 1. - es;
+				c.e4 = es * es;
+				c.inv_a2 = 1. / (a * a);
+
+				return c;
+			}
+
+			// earth centred, earth fixed cartesian coordinates (in meters) on the given
+			// ellipsoid.  Conversions between latlong and geocent need a z coordinate, the
+			// ellipsoidal height on the latlong side, so they only run through the 3D entry
+			// points of transformer and backends.
+			//
+			template<typename TEllipsoid, typename T>
+			struct geocent : base_projection {
+				typedef TEllipsoid ellipsoid_type;
+
+				geocent() : base_projection("geocent"),
+					consts(make_geocent_constants(TEllipsoid::params::major_axis,
+								TEllipsoid::params::ecc2)) {
+				}
+
+				device::geocent_constants consts;
 			};
 		}
 	}
@@ -90,6 +496,257 @@ namespace transform {
 				from(from_), to(to_) {}
 		};
 	}
+
+	template<typename TEllipsoid, typename T>
+	struct is_3d<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::geocent<TEllipsoid, T>>> : std::true_type { };
+
+	template<typename TEllipsoid, typename T>
+	struct is_3d<transforms::projection<
+		cartographic::projections::geocent<TEllipsoid, T>,
+		cartographic::projections::latlong>> : std::true_type { };
+
+	// device sources for the projections, every ellipsoid shares the kernels and only the
+	// constants differ
+	//
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::tmerc<TEllipsoid, double>>> {
+		typedef device::tmerc_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::tmerc_source();
+		}
+
+		static const char *function() { return "tmerc_forward"; }
+		static const char *constants_name() { return "tmerc_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::tmerc<TEllipsoid, double>,
+		cartographic::projections::latlong>> {
+		typedef device::tmerc_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::tmerc_source();
+		}
+
+		static const char *function() { return "tmerc_inverse"; }
+		static const char *constants_name() { return "tmerc_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
+
+	template<>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::webmerc>> {
+		typedef device::webmerc_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::webmerc_source();
+		}
+
+		static const char *function() { return "webmerc_forward"; }
+		static const char *constants_name() { return "webmerc_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<>
+	struct device_op<transforms::projection<
+		cartographic::projections::webmerc,
+		cartographic::projections::latlong>> {
+		typedef device::webmerc_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::webmerc_source();
+		}
+
+		static const char *function() { return "webmerc_inverse"; }
+		static const char *constants_name() { return "webmerc_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::lcc<TEllipsoid, double>>> {
+		typedef device::lcc_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::lcc_source();
+		}
+
+		static const char *function() { return "lcc_forward"; }
+		static const char *constants_name() { return "lcc_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::lcc<TEllipsoid, double>,
+		cartographic::projections::latlong>> {
+		typedef device::lcc_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::lcc_source();
+		}
+
+		static const char *function() { return "lcc_inverse"; }
+		static const char *constants_name() { return "lcc_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::stere<TEllipsoid, double>>> {
+		typedef device::stere_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::stere_source();
+		}
+
+		static const char *function() { return "stere_forward"; }
+		static const char *constants_name() { return "stere_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::stere<TEllipsoid, double>,
+		cartographic::projections::latlong>> {
+		typedef device::stere_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::stere_source();
+		}
+
+		static const char *function() { return "stere_inverse"; }
+		static const char *constants_name() { return "stere_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::sinu<TEllipsoid, double>>> {
+		typedef device::sinu_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::sinu_source();
+		}
+
+		static const char *function() { return "sinu_forward"; }
+		static const char *constants_name() { return "sinu_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::sinu<TEllipsoid, double>,
+		cartographic::projections::latlong>> {
+		typedef device::sinu_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::sinu_source();
+		}
+
+		static const char *function() { return "sinu_inverse"; }
+		static const char *constants_name() { return "sinu_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::geos<TEllipsoid, double>>> {
+		typedef device::geos_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::geos_source();
+		}
+
+		static const char *function() { return "geos_forward"; }
+		static const char *constants_name() { return "geos_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::geos<TEllipsoid, double>,
+		cartographic::projections::latlong>> {
+		typedef device::geos_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::geos_source();
+		}
+
+		static const char *function() { return "geos_inverse"; }
+		static const char *constants_name() { return "geos_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::latlong,
+		cartographic::projections::geocent<TEllipsoid, double>>> {
+		typedef device::geocent_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::geocent_source();
+		}
+
+		static const char *function() { return "geocent_forward"; }
+		static const char *constants_name() { return "geocent_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.to.consts; }
+	};
+
+	template<typename TEllipsoid>
+	struct device_op<transforms::projection<
+		cartographic::projections::geocent<TEllipsoid, double>,
+		cartographic::projections::latlong>> {
+		typedef device::geocent_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::geocent_source();
+		}
+
+		static const char *function() { return "geocent_inverse"; }
+		static const char *constants_name() { return "geocent_constants"; }
+
+		template<typename TTransform>
+		static const constants_type& constants(const TTransform& p) { return p.from.consts; }
+	};
 }
 
 #endif // __transforms_transform_cartographic_hpp__
@@ -0,0 +1,434 @@
+// cartographic_device.hpp
+// Projection kernels shared by the CPU and OpenCL backends, see device.hpp
+//
+
+#ifndef __transform_transforms_cartographic_device_hpp__
+#define __transform_transforms_cartographic_device_hpp__
+
+#include "../device.hpp"
+
+namespace transform {
+	namespace device {
+		// transverse mercator, the spherical and ellipsoidal forms share the constants and a
+		// uniform branch on spherical picks between them
+		//
+		TRANSFORM_DEVICE_SOURCE(tmerc,
+			typedef struct {
+				double scale;			// major axis * k0
+				double k0;
+				double ecc2, one_ecc2, esp;
+				double en[5];
+				double ml0;
+				double phi0, lambda0;	// radians
+				double x0, y0;
+				double spherical;		// 1 on a sphere, 0 otherwise, tested against 0.5
+			} tmerc_constants;
+
+			TRANSFORM_DEVICE void tmerc_forward(const tmerc_constants *c,
+					double lon, double lat, double *ox, double *oy) {
+				const double FC1 = 1., FC2 = .5, FC3 = .16666666666666666666, FC4 = .08333333333333333333,
+					  FC5 = .05, FC6 = .03333333333333333333, FC7 = .02380952380952380952,
+					  FC8 = .01785714285714285714;
+
+				double lambda = mod_pi(to_radians(lon) - c->lambda0);
+				double phi = to_radians(lat);
+				double x, y;
+
+				if (c->spherical > 0.5) {
+					double cosphi = cos(phi);
+					double b = cosphi * sin(lambda);
+
+					// more than 90 degrees away from the central meridian
+					if (fabs(lambda) > M_PI_2 || fabs(fabs(b) - 1.) <= 1e-10) {
+						*ox = *oy = HUGE_VAL;
+						return;
+					}
+
+					x = 0.5 * log((1. + b) / (1. - b));
+					y = cosphi * cos(lambda) / sqrt(1. - b * b);
+
+					b = fabs(y);
+					if (b - 1. > 1e-10) {
+						*ox = *oy = HUGE_VAL;
+						return;
+					}
+
+					y = (b >= 1.) ? 0. : acos(y);
+					y = (phi < 0.) ? -y : y;
+					y -= c->phi0;
+				}
+				else {
+					double sinphi = sin(phi), cosphi = cos(phi);
+					double t = (fabs(cosphi) > 1e-10) ? sinphi / cosphi : 0.;
+					double al = cosphi * lambda;
+					double als = al * al;
+					double n = c->esp * cosphi * cosphi;
+
+					t *= t;
+					al /= sqrt(1. - c->ecc2 * sinphi * sinphi);
+
+					x = al * (FC1 +
+							FC3 * als * (1. - t + n +
+								FC5 * als * (5. + t * (t - 18.) + n * (14. - 58. * t)
+									+ FC7 * als * (61. + t * (t * (179. - t) - 479.))
+									)));
+					y = (mlfn(c->en, phi, sinphi, cosphi) - c->ml0 +
+							sinphi * al * lambda * FC2 * (1. +
+								FC4 * als * (5. - t + n * (9. + 4. * n) +
+									FC6 * als * (61. + t * (t - 58.) + n * (270. - 330. * t)
+										+ FC8 * als * (1385. + t * (t * (543. - t) - 3111.))
+										))));
+				}
+
+				*ox = c->x0 + c->scale * x;
+				*oy = c->y0 + c->scale * y;
+			}
+
+			TRANSFORM_DEVICE void tmerc_inverse(const tmerc_constants *c,
+					double x_in, double y_in, double *olon, double *olat) {
+				const double FC1 = 1., FC2 = .5, FC3 = .16666666666666666666, FC4 = .08333333333333333333,
+					  FC5 = .05, FC6 = .03333333333333333333, FC7 = .02380952380952380952,
+					  FC8 = .01785714285714285714;
+
+				double x = (x_in - c->x0) / c->scale;
+				double y = (y_in - c->y0) / c->scale;
+				double lambda, phi;
+
+				if (c->spherical > 0.5) {
+					double h = exp(x);
+					double g = 0.5 * (h - 1. / h);
+
+					h = cos(c->phi0 + y);
+
+					// the hemisphere comes from the unshifted y
+					phi = asin(sqrt((1. - h * h) / (1. + g * g)));
+					phi = (c->phi0 + y < 0.) ? -phi : phi;
+
+					lambda = (fabs(g) > 1e-10 || fabs(h) > 1e-10) ? atan2(g, h) : 0.;
+				}
+				else {
+					phi = inv_mlfn(c->en, c->ecc2, c->ml0 + y);
+
+					double sinphi = sin(phi), cosphi = cos(phi);
+					double t = (fabs(cosphi) > 1e-10) ? sinphi / cosphi : 0.;
+					double n = c->esp * cosphi * cosphi;
+					double con = 1. - c->ecc2 * sinphi * sinphi;
+					double d = x * sqrt(con);
+					double ds = d * d;
+
+					con *= t;
+					t *= t;
+
+					phi -= (con * ds / c->one_ecc2) * FC2 * (1. -
+							ds * FC4 * (5. + t * (3. - 9. * n) + n * (1. - 4. * n) -
+								ds * FC6 * (61. + t * (90. - 252. * n + 45. * t) + 46. * n
+									- ds * FC8 * (1385. + t * (3633. + t * (4095. + 1574. * t)))
+									)));
+					lambda = d * (FC1 -
+							ds * FC3 * (1. + 2. * t + n -
+								ds * FC5 * (5. + t * (28. + 24. * t + 8. * n) + 6. * n
+									- ds * FC7 * (61. + t * (662. + t * (1320. + 720. * t)))
+									))) / cosphi;
+				}
+
+				*olon = to_degrees(mod_pi(lambda + c->lambda0));
+				*olat = to_degrees(phi);
+			}
+		)
+
+		// web mercator, both directions are branch free so batches vectorize when the
+		// compiler has vector versions of the math functions (e.g. glibc libmvec with
+		// -ffast-math)
+		//
+		TRANSFORM_DEVICE_SOURCE(webmerc,
+			typedef struct {
+				double a;				// sphere radius
+			} webmerc_constants;
+
+			TRANSFORM_DEVICE void webmerc_forward(const webmerc_constants *c,
+					double lon, double lat, double *x, double *y) {
+				double s = sin(to_radians(lat));
+
+				// the poles (and anything past them) are infinitely far north or south
+				int fail = fabs(lat) >= 90.;
+
+				*x = fail ? HUGE_VAL : c->a * mod_pi(to_radians(lon));
+				*y = fail ? HUGE_VAL : c->a * 0.5 * log((1. + s) / (1. - s));
+			}
+
+			TRANSFORM_DEVICE void webmerc_inverse(const webmerc_constants *c,
+					double x, double y, double *lon, double *lat) {
+				*lon = to_degrees(mod_pi(x / c->a));
+				*lat = to_degrees(M_PI_2 - 2. * atan(exp(-y / c->a)));
+			}
+		)
+
+		// lambert conformal conic, the spherical case falls out of the ellipsoidal formulas
+		// with e = 0 so the forward kernel is a single branch free path
+		//
+		TRANSFORM_DEVICE_SOURCE(lcc,
+			typedef struct {
+				double a;				// major axis
+				double k0;
+				double e, es;
+				double n, c, rho0;
+				double lambda0;			// radians
+				double x0, y0;
+				double spherical;		// 1 on a sphere, 0 otherwise, tested against 0.5
+			} lcc_constants;
+
+			TRANSFORM_DEVICE void lcc_forward(const lcc_constants *c,
+					double lon, double lat, double *x, double *y) {
+				double lambda = mod_pi(to_radians(lon) - c->lambda0) * c->n;
+				double phi = to_radians(lat);
+
+				double rho = c->c * pow(tsfn(phi, sin(phi), c->e), c->n);
+
+				// the pole opposite to the apex of the cone can not be projected
+				int fail = fabs(fabs(phi) - M_PI_2) < 1e-10 && phi * c->n <= 0.;
+
+				double scale = c->a * c->k0;
+
+				*x = fail ? HUGE_VAL : c->x0 + scale * rho * sin(lambda);
+				*y = fail ? HUGE_VAL : c->y0 + scale * (c->rho0 - rho * cos(lambda));
+			}
+
+			TRANSFORM_DEVICE void lcc_inverse(const lcc_constants *c,
+					double x_in, double y_in, double *lon, double *lat) {
+				double scale = c->a * c->k0;
+
+				// cones opening to the south are flipped over
+				double flip = (c->n < 0.) ? -1. : 1.;
+
+				double x = flip * (x_in - c->x0) / scale,
+					   y = flip * (c->rho0 - (y_in - c->y0) / scale);
+
+				double rho = flip * sqrt(x * x + y * y);
+				double ts = pow(rho / c->c, 1. / c->n);
+
+				double phi = (c->spherical > 0.5) ? M_PI_2 - 2. * atan(ts) : phi2(ts, c->e);
+
+				*lon = to_degrees(mod_pi(atan2(x, y) / c->n + c->lambda0));
+				*lat = to_degrees(phi);
+			}
+		)
+
+		// polar stereographic, the hemisphere only flips signs so north and south share a
+		// path, and the spherical case is the ellipsoidal one with e = 0
+		//
+		TRANSFORM_DEVICE_SOURCE(stere,
+			typedef struct {
+				double a;				// major axis
+				double akm1;
+				double e;
+				double lambda0;			// radians
+				double x0, y0;
+				double sign;			// 1 for the north pole, -1 for the south one
+			} stere_constants;
+
+			TRANSFORM_DEVICE void stere_forward(const stere_constants *c,
+					double lon, double lat, double *x, double *y) {
+				double lambda = mod_pi(to_radians(lon) - c->lambda0);
+				double phi = c->sign * to_radians(lat);
+
+				double r = c->a * c->akm1 * tsfn(phi, sin(phi), c->e);
+
+				// the opposite pole is infinitely far away
+				int fail = fabs(phi + M_PI_2) < 1e-10;
+
+				*x = fail ? HUGE_VAL : c->x0 + r * sin(lambda);
+				*y = fail ? HUGE_VAL : c->y0 - c->sign * r * cos(lambda);
+			}
+
+			TRANSFORM_DEVICE void stere_inverse(const stere_constants *c,
+					double x_in, double y_in, double *lon, double *lat) {
+				double x = (x_in - c->x0) / c->a,
+					   y = -c->sign * (y_in - c->y0) / c->a;
+
+				double ts = sqrt(x * x + y * y) / c->akm1;
+
+				*lon = to_degrees(mod_pi(atan2(x, y) + c->lambda0));
+				*lat = c->sign * to_degrees(phi2(ts, c->e));
+			}
+		)
+
+		// sinusoidal, as with stere the spherical case is the ellipsoidal one with es = 0
+		//
+		TRANSFORM_DEVICE_SOURCE(sinu,
+			typedef struct {
+				double a;				// major axis (or sphere radius)
+				double es;
+				double en[5];			// meridional distance series
+				double lambda0;			// radians
+				double x0, y0;
+			} sinu_constants;
+
+			TRANSFORM_DEVICE void sinu_forward(const sinu_constants *c,
+					double lon, double lat, double *x, double *y) {
+				double lambda = mod_pi(to_radians(lon) - c->lambda0);
+				double phi = to_radians(lat);
+				double s = sin(phi), co = cos(phi);
+
+				*x = c->x0 + c->a * lambda * co / sqrt(1. - c->es * s * s);
+				*y = c->y0 + c->a * mlfn(c->en, phi, s, co);
+			}
+
+			// the parallel through y (in major axes), and what multiplies x into a longitude
+			// on it.  Points beyond the poles fail.
+			TRANSFORM_DEVICE void sinu_parallel(const sinu_constants *c, double y,
+					double *phi, double *scale, int *fail) {
+				*phi = inv_mlfn(c->en, c->es, y);
+				double s = sin(*phi);
+
+				// every longitude is the same point at the poles
+				int pole = fabs(*phi) >= M_PI_2 - 1e-10;
+
+				*scale = pole ? 0. : sqrt(1. - c->es * s * s) / cos(*phi);
+				*fail = fabs(y) > c->en[0] * M_PI_2 + 1e-10;
+			}
+
+			TRANSFORM_DEVICE void sinu_inverse(const sinu_constants *c,
+					double x_in, double y_in, double *lon, double *lat) {
+				double phi, scale;
+				int fail;
+
+				sinu_parallel(c, (y_in - c->y0) / c->a, &phi, &scale, &fail);
+
+				double lambda = (x_in - c->x0) / c->a * scale;
+
+				// outside the outline of the projected world too
+				fail = fail || fabs(lambda) > M_PI + 1e-10;
+
+				*lon = fail ? HUGE_VAL : to_degrees(mod_pi(lambda + c->lambda0));
+				*lat = fail ? HUGE_VAL : to_degrees(phi);
+			}
+		)
+
+		// geostationary view.  The geocentric latitude is worked out algebraically rather
+		// than through tan and atan, and the spherical case has radius_p = 1.  Points the
+		// satellite can't see fail without branching so batches stay vectorized.
+		//
+		TRANSFORM_DEVICE_SOURCE(geos,
+			typedef struct {
+				double a;				// major axis
+				double radius_g;		// satellite distance from the centre, in major axes
+				double radius_g_1;		// satellite height, in major axes
+				double c;				// radius_g^2 - 1
+				double radius_p, radius_p2, radius_p_inv2;	// polar radius in major axes, squared, and 1 / squared
+				double lambda0;			// radians
+				double x0, y0;
+				double flip_axis;		// 1 for a sweep around x, 0 otherwise, tested against 0.5
+			} geos_constants;
+
+			TRANSFORM_DEVICE void geos_forward_trig(const geos_constants *c,
+					double cos_lambda, double sin_lambda, double cos_phi, double sin_phi,
+					double *x, double *y) {
+				double d = 1. / sqrt(cos_phi * cos_phi + c->radius_p2 * c->radius_p2 * sin_phi * sin_phi);
+				double cp = cos_phi * d, sp = c->radius_p2 * sin_phi * d;
+				double r = c->radius_p / sqrt(c->radius_p * c->radius_p * cp * cp + sp * sp);
+
+				double vx = r * cos_lambda * cp, vy = r * sin_lambda * cp, vz = r * sp;
+				double tmp = c->radius_g - vx;
+
+				int fail = tmp * vx - vy * vy - vz * vz * c->radius_p_inv2 < 0.;
+
+				double ax = (c->flip_axis > 0.5) ? atan(vy / sqrt(vz * vz + tmp * tmp)) : atan(vy / tmp),
+					   ay = (c->flip_axis > 0.5) ? atan(vz / tmp) : atan(vz / sqrt(vy * vy + tmp * tmp));
+
+				*x = fail ? HUGE_VAL : c->x0 + c->a * c->radius_g_1 * ax;
+				*y = fail ? HUGE_VAL : c->y0 + c->a * c->radius_g_1 * ay;
+			}
+
+			TRANSFORM_DEVICE void geos_forward(const geos_constants *c,
+					double lon, double lat, double *x, double *y) {
+				double lambda = mod_pi(to_radians(lon) - c->lambda0);
+				double phi = to_radians(lat);
+
+				geos_forward_trig(c, cos(lambda), sin(lambda), cos(phi), sin(phi), x, y);
+			}
+
+			// tx and ty are the tangents of the scanning angles
+			TRANSFORM_DEVICE void geos_inverse_tan(const geos_constants *c,
+					double tx, double ty, double *lon, double *lat) {
+				double vx = -1.,
+					   vy = (c->flip_axis > 0.5) ? tx * sqrt(1. + ty * ty) : tx,
+					   vz = (c->flip_axis > 0.5) ? ty : ty * sqrt(1. + tx * tx);
+
+				double az = vz / c->radius_p;
+				double qa = vy * vy + az * az + vx * vx,
+					   qb = 2. * c->radius_g * vx;
+				double det = qb * qb - 4. * qa * c->c;
+
+				// the line of sight misses the earth
+				int fail = det < 0.;
+
+				double k = (-qb - sqrt(fail ? 0. : det)) / (2. * qa);
+
+				vx = c->radius_g + k * vx;
+				vy *= k;
+				vz *= k;
+
+				double lambda = atan2(vy, vx),
+					   phi = atan(c->radius_p_inv2 * vz / sqrt(vx * vx + vy * vy));
+
+				*lon = fail ? HUGE_VAL : to_degrees(mod_pi(lambda + c->lambda0));
+				*lat = fail ? HUGE_VAL : to_degrees(phi);
+			}
+
+			TRANSFORM_DEVICE void geos_inverse(const geos_constants *c,
+					double x, double y, double *lon, double *lat) {
+				double h = c->a * c->radius_g_1;
+
+				geos_inverse_tan(c, tan((x - c->x0) / h), tan((y - c->y0) / h), lon, lat);
+			}
+		)
+
+		// geodetic to geocentric is closed form, and back uses Vermeille's non-iterative
+		// method (Journal of Geodesy 76, 2002), valid everywhere except close to the centre
+		// of the earth.  The spherical case falls out with es = 0.
+		//
+		TRANSFORM_DEVICE_SOURCE(geocent,
+			typedef struct {
+				double a;				// major axis
+				double es, one_es;		// eccentricity squared and 1 - es
+				double e4;				// es squared
+				double inv_a2;			// 1 / a^2
+			} geocent_constants;
+
+			TRANSFORM_DEVICE void geocent_forward(const geocent_constants *c,
+					double lon, double lat, double h, double *x, double *y, double *z) {
+				double lambda = to_radians(lon), phi = to_radians(lat);
+
+				double sinphi = sin(phi), cosphi = cos(phi);
+				double n = c->a / sqrt(1. - c->es * sinphi * sinphi);
+
+				*x = (n + h) * cosphi * cos(lambda);
+				*y = (n + h) * cosphi * sin(lambda);
+				*z = (n * c->one_es + h) * sinphi;
+			}
+
+			TRANSFORM_DEVICE void geocent_inverse(const geocent_constants *c,
+					double x, double y, double z, double *lon, double *lat, double *h) {
+				double d2 = x * x + y * y;
+
+				double p = d2 * c->inv_a2;
+				double q = c->one_es * c->inv_a2 * z * z;
+				double r = (p + q - c->e4) / 6.;
+				double s = c->e4 * p * q / (4. * r * r * r);
+				double t = cbrt(1. + s + sqrt(s * (2. + s)));
+				double u = r * (1. + t + 1. / t);
+				double v = sqrt(u * u + c->e4 * q);
+				double w = c->es * (u + v - q) / (2. * v);
+				double k = sqrt(u + v + w * w) - w;
+				double d = k * sqrt(d2) / (k + c->es);
+				double dz = sqrt(d * d + z * z);
+
+				*lon = to_degrees(atan2(y, x));
+				*lat = to_degrees(2. * atan2(z, d + dz));
+				*h = (k + c->es - 1.) / k * dz;
+			}
+		)
+	}
+}
+
+#endif // __transform_transforms_cartographic_device_hpp__
@@ -0,0 +1,74 @@
+// composite.hpp
+// Chaining transforms into a single pass
+//
+
+#ifndef __transform_transforms_composite_hpp__
+#define __transform_transforms_composite_hpp__
+
+#include "../cpu_op.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace transform {
+	namespace transforms {
+		// first followed by second as one transform, e.g. pixel -> world -> projected as
+		// compose(affine, projection).  Composites nest, so longer chains are composites of
+		// composites.
+		//
+		template<
+			typename TFirst,
+			typename TSecond
+		>
+		struct composite {
+			TFirst first;
+			TSecond second;
+
+			composite(const TFirst& f, const TSecond& s) : first(f), second(s) { }
+
+			template<typename TValue, typename TOutput>
+			void op(const TValue& x, const TValue& y, TOutput& ox, TOutput& oy) const {
+				TOutput tx, ty;
+
+				first.op(x, y, tx, ty);
+				second.op(tx, ty, ox, oy);
+			}
+		};
+
+		template<
+			typename TFirst,
+			typename TSecond
+		>
+		composite<TFirst, TSecond> compose(const TFirst& first, const TSecond& second) {
+			return composite<TFirst, TSecond>(first, second);
+		}
+
+		// batches run every stage through its own batch kernel a block at a time, the
+		// intermediate coordinates never leave a small stack buffer.  Found through argument
+		// dependent lookup, it is a better match than the generic do_batch_op.
+		//
+		template<
+			typename TFirst,
+			typename TSecond,
+			typename TValue,
+			typename TOutput
+		>
+		void do_batch_op(const composite<TFirst, TSecond>& p, const TValue *x, const TValue *y,
+				TOutput *ox, TOutput *oy, size_t count) {
+			using transform::do_batch_op;
+
+			const size_t block = 256;
+			TOutput tx[block], ty[block];
+
+			for (size_t i = 0 ; i < count ; i += block) {
+				size_t n = std::min(block, count - i);
+
+				do_batch_op(p.first, x + i, y + i, tx, ty, n);
+				do_batch_op(p.second, static_cast<const TOutput *>(tx), static_cast<const TOutput *>(ty),
+						ox + i, oy + i, n);
+			}
+		}
+	}
+}
+
+#endif // __transform_transforms_composite_hpp__
@@ -0,0 +1,126 @@
+// datum.hpp
+// Datum shifts between geocentric coordinate systems
+//
+
+#ifndef __transform_transforms_datum_hpp__
+#define __transform_transforms_datum_hpp__
+
+#include "cartographic.hpp"
+#include "datum_device.hpp"
+#include "../cpu_op.hpp"
+#include "../device.hpp"
+#include "../utility.hpp"
+
+namespace transform {
+	namespace transforms {
+		// the two sign conventions for Helmert rotations in use, EPSG methods 9606 and 9607.
+		// Coordinate frame rotations are position vector ones with the signs flipped.
+		//
+		enum class rotation_convention {
+			position_vector,
+			coordinate_frame
+		};
+
+		// seven parameter Helmert (Bursa-Wolf) transform between geocentric coordinates,
+		// translations are in meters, rotations in arc seconds and the scale difference in
+		// parts per million.  Rotations use the usual small angle approximation, which is
+		// what the published parameter sets expect.
+		//
+		// To go the other way construct a helmert with every parameter negated.
+		//
+		template<typename T>
+		struct helmert : cpu_op<helmert<T>> {
+			helmert(T tx_, T ty_, T tz_, T rx_, T ry_, T rz_, T s_,
+					rotation_convention c = rotation_convention::position_vector) :
+				cpu_op<helmert<T>>(*this),
+				tx(tx_), ty(ty_), tz(tz_), rx(rx_), ry(ry_), rz(rz_), s(s_), convention(c) {
+				T sign = (c == rotation_convention::position_vector) ? 1 : -1;
+				T to_radians = util::TO_RADIANS / 3600.;
+
+				T x = sign * rx * to_radians,
+				  y = sign * ry * to_radians,
+				  z = sign * rz * to_radians;
+				T k = 1 + s * 1e-6;
+
+				T m[9] = {
+					k,      -k * z,  k * y,
+					k * z,   k,     -k * x,
+					-k * y,  k * x,  k
+				};
+
+				std::copy(m, m + 9, consts.m);
+
+				consts.t[0] = tx;
+				consts.t[1] = ty;
+				consts.t[2] = tz;
+			}
+
+			T tx, ty, tz;
+			T rx, ry, rz;
+			T s;
+			rotation_convention convention;
+
+			// the rotation-scale matrix and translation, worked out once from the seven
+			// parameters
+			device::helmert_constants consts;
+		};
+
+		// latlong (with ellipsoidal heights) on one ellipsoid to latlong on another through
+		// a Helmert transform, in a single pass: geodetic to geocentric on the source
+		// ellipsoid, the Helmert transform and geocentric to geodetic on the target one.
+		// Used through the 2D entry points heights are taken to be 0 and dropped.
+		//
+		template<typename T>
+		struct datum_shift : cpu_op<datum_shift<T>> {
+			datum_shift(const cartographic::ellipsoids::runtime& from_ellps,
+					const helmert<T>& h,
+					const cartographic::ellipsoids::runtime& to_ellps) :
+				cpu_op<datum_shift<T>>(*this) {
+				consts.from = cartographic::projections::make_geocent_constants(
+						from_ellps.major_axis, from_ellps.ecc2);
+				consts.shift = h.consts;
+				consts.to = cartographic::projections::make_geocent_constants(
+						to_ellps.major_axis, to_ellps.ecc2);
+			}
+
+			device::datum_shift_constants consts;
+		};
+	}
+
+	template<typename T>
+	struct is_3d<transforms::helmert<T>> : std::true_type { };
+
+	template<typename T>
+	struct is_3d<transforms::datum_shift<T>> : std::true_type { };
+
+	template<>
+	struct device_op<transforms::helmert<double>> {
+		typedef device::helmert_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::helmert_source();
+		}
+
+		static const char *function() { return "helmert_apply"; }
+		static const char *constants_name() { return "helmert_constants"; }
+
+		static const constants_type& constants(const transforms::helmert<double>& p) { return p.consts; }
+	};
+
+	template<>
+	struct device_op<transforms::datum_shift<double>> {
+		typedef device::datum_shift_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::geocent_source() +
+				device::helmert_source() + device::datum_shift_source();
+		}
+
+		static const char *function() { return "datum_shift_apply"; }
+		static const char *constants_name() { return "datum_shift_constants"; }
+
+		static const constants_type& constants(const transforms::datum_shift<double>& p) { return p.consts; }
+	};
+}
+
+#endif // __transform_transforms_datum_hpp__
@@ -0,0 +1,52 @@
+// datum_device.hpp
+// Datum shift kernels shared by the CPU and OpenCL backends, see device.hpp
+//
+
+#ifndef __transform_transforms_datum_device_hpp__
+#define __transform_transforms_datum_device_hpp__
+
+#include "../device.hpp"
+#include "cartographic_device.hpp"
+
+namespace transform {
+	namespace device {
+		// Helmert transforms are a matrix multiply and an add, the 3x3 rotation-scale matrix
+		// is row major
+		//
+		TRANSFORM_DEVICE_SOURCE(helmert,
+			typedef struct {
+				double m[9];
+				double t[3];
+			} helmert_constants;
+
+			TRANSFORM_DEVICE void helmert_apply(const helmert_constants *c,
+					double x, double y, double z, double *ox, double *oy, double *oz) {
+				*ox = c->t[0] + c->m[0] * x + c->m[1] * y + c->m[2] * z;
+				*oy = c->t[1] + c->m[3] * x + c->m[4] * y + c->m[5] * z;
+				*oz = c->t[2] + c->m[6] * x + c->m[7] * y + c->m[8] * z;
+			}
+		)
+
+		// geodetic to geocentric on one ellipsoid, Helmert and back to geodetic on the other,
+		// needs the geocent and helmert sources before it
+		//
+		TRANSFORM_DEVICE_SOURCE(datum_shift,
+			typedef struct {
+				geocent_constants from;
+				helmert_constants shift;
+				geocent_constants to;
+			} datum_shift_constants;
+
+			TRANSFORM_DEVICE void datum_shift_apply(const datum_shift_constants *c,
+					double lon, double lat, double h, double *olon, double *olat, double *oh) {
+				double x, y, z, sx, sy, sz;
+
+				geocent_forward(&c->from, lon, lat, h, &x, &y, &z);
+				helmert_apply(&c->shift, x, y, z, &sx, &sy, &sz);
+				geocent_inverse(&c->to, sx, sy, sz, olon, olat, oh);
+			}
+		)
+	}
+}
+
+#endif // __transform_transforms_datum_device_hpp__
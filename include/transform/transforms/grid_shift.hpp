@@ -0,0 +1,56 @@
+// grid_shift.hpp
+// Datum shifts interpolated from NTv2 and GTX grids
+//
+
+#ifndef __transform_transforms_grid_shift_hpp__
+#define __transform_transforms_grid_shift_hpp__
+
+#include "../cpu_op.hpp"
+#include "../grids.hpp"
+
+#include <memory>
+
+namespace transform {
+	namespace transforms {
+		// forward applies the shifts stored in a grid (source to target datum for NTv2,
+		// adding the grid value to heights for GTX), inverse undoes them
+		//
+		enum class grid_direction {
+			forward,
+			inverse
+		};
+
+		// horizontal datum shift of latlong points through an NTv2 grid.  Points no sub-grid
+		// covers come out as infinity.  The inverse is found by iterating on the forward
+		// shift the way PROJ does.
+		//
+		// Grids are shared between transforms and only mapped once.
+		//
+		struct ntv2_shift : cpu_op<ntv2_shift> {
+			ntv2_shift(const std::shared_ptr<const grids::ntv2>& g,
+					grid_direction d = grid_direction::forward) :
+				cpu_op<ntv2_shift>(*this), grid(g), direction(d) { }
+
+			std::shared_ptr<const grids::ntv2> grid;
+			grid_direction direction;
+		};
+
+		// vertical shift of heights through a GTX grid (e.g. ellipsoidal to orthometric
+		// heights with a geoid model), x and y are latlong and pass through.  Heights of
+		// points off the grid come out as infinity.
+		//
+		struct gtx_shift : cpu_op<gtx_shift> {
+			gtx_shift(const std::shared_ptr<const grids::gtx>& g,
+					grid_direction d = grid_direction::forward) :
+				cpu_op<gtx_shift>(*this), grid(g), direction(d) { }
+
+			std::shared_ptr<const grids::gtx> grid;
+			grid_direction direction;
+		};
+	}
+
+	template<>
+	struct is_3d<transforms::gtx_shift> : std::true_type { };
+}
+
+#endif // __transform_transforms_grid_shift_hpp__
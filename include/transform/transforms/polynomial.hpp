@@ -0,0 +1,231 @@
+// polynomial.hpp
+// Polynomial transforms fitted to ground control points
+//
+
+#ifndef __transform_transforms_polynomial_hpp__
+#define __transform_transforms_polynomial_hpp__
+
+#include "polynomial_device.hpp"
+#include "../device.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace transform {
+	namespace transforms {
+		// bivariate polynomial of order 1 to 3 for each output coordinate, the usual GCP
+		// warp for imagery without a sensor model.  Inputs are normalized (centred and
+		// scaled) before evaluation, which keeps fitting well conditioned.
+		//
+		// Coefficients are stored by powers of y then powers of x, so for order 2 the terms
+		// are 1, u, u^2, v, uv, v^2 with u and v the normalized inputs.  Evaluation is in
+		// Horner form, as a polynomial in v whose coefficients are polynomials in u.
+		//
+		template<typename T>
+		struct polynomial {
+			static const int max_order = 3;
+			static const int max_terms = 10;
+
+			int order;
+			T x0, y0, scale;	// u = (x - x0) * scale, v = (y - y0) * scale
+			T cx[max_terms], cy[max_terms];
+
+			// coefficients apply to raw inputs
+			polynomial(int order_, const T *cx_, const T *cy_) :
+				order(order_), x0(0), y0(0), scale(1) {
+				if (order < 1 || order > max_order)
+					throw std::invalid_argument("Polynomial order must be between 1 and 3");
+
+				std::fill(cx, cx + max_terms, T(0));
+				std::fill(cy, cy + max_terms, T(0));
+				std::copy(cx_, cx_ + terms(order), cx);
+				std::copy(cy_, cy_ + terms(order), cy);
+
+				init_consts();
+			}
+
+			static int terms(int order) {
+				return (order + 1) * (order + 2) / 2;
+			}
+
+			// least squares fit mapping (src_x, src_y) onto (dst_x, dst_y), needs at least
+			// terms(order) points which don't all sit on a lower order curve
+			static polynomial fit(int order,
+					const std::vector<T>& src_x, const std::vector<T>& src_y,
+					const std::vector<T>& dst_x, const std::vector<T>& dst_y) {
+				size_t n = src_x.size();
+				int k = terms(order);
+
+				if (order < 1 || order > max_order)
+					throw std::invalid_argument("Polynomial order must be between 1 and 3");
+
+				if (src_y.size() != n || dst_x.size() != n || dst_y.size() != n)
+					throw std::invalid_argument("GCP arrays differ in size");
+
+				if (n < static_cast<size_t>(k))
+					throw std::invalid_argument("Not enough GCPs for the polynomial order");
+
+				// centre on the mean and scale the largest deviation to 1
+				T mx = 0, my = 0;
+				for (size_t i = 0 ; i < n ; i ++) {
+					mx += src_x[i];
+					my += src_y[i];
+				}
+				mx /= n;
+				my /= n;
+
+				T extent = 0;
+				for (size_t i = 0 ; i < n ; i ++)
+					extent = std::max(extent, std::max(std::abs(src_x[i] - mx), std::abs(src_y[i] - my)));
+
+				polynomial p(order);
+				p.x0 = mx;
+				p.y0 = my;
+				p.scale = (extent > 0) ? 1 / extent : 1;
+
+				// design matrix, one row per GCP, column major so Householder works down columns
+				std::vector<T> a(n * k), bx(dst_x), by(dst_y);
+				for (size_t i = 0 ; i < n ; i ++) {
+					T row[max_terms];
+					p.monomials((src_x[i] - mx) * p.scale, (src_y[i] - my) * p.scale, row);
+
+					for (int j = 0 ; j < k ; j ++)
+						a[j * n + i] = row[j];
+				}
+
+				solve_least_squares(a, n, k, bx, by, p.cx, p.cy);
+				p.init_consts();
+				return p;
+			}
+
+			template<typename TOut>
+			void op(const T& x, const T& y, TOut& xo, TOut& yo) const {
+				double dx, dy;
+				device::polynomial_apply(&consts, x, y, &dx, &dy);
+
+				xo = static_cast<TOut>(dx);
+				yo = static_cast<TOut>(dy);
+			}
+
+			// where the coefficients of v^j start
+			static int base(int order, int j) {
+				return j * (order + 1) - j * (j - 1) / 2;
+			}
+
+			// the coefficients spread out into the order 3 layout the kernels take, worked
+			// out once the polynomial is complete
+			device::polynomial_constants consts;
+
+			private:
+			explicit polynomial(int order_) : order(order_), x0(0), y0(0), scale(1) {
+				std::fill(cx, cx + max_terms, T(0));
+				std::fill(cy, cy + max_terms, T(0));
+			}
+
+			void init_consts() {
+				std::fill(consts.cx, consts.cx + max_terms, 0.);
+				std::fill(consts.cy, consts.cy + max_terms, 0.);
+
+				for (int j = 0 ; j <= order ; j ++) {
+					for (int i = 0 ; i <= order - j ; i ++) {
+						consts.cx[base(max_order, j) + i] = cx[base(order, j) + i];
+						consts.cy[base(max_order, j) + i] = cy[base(order, j) + i];
+					}
+				}
+
+				consts.x0 = x0;
+				consts.y0 = y0;
+				consts.scale = scale;
+				consts.order = order;
+			}
+
+			void monomials(T u, T v, T *out) const {
+				T vj = 1;
+				for (int j = 0 ; j <= order ; j ++, vj *= v) {
+					T ui = 1;
+					for (int i = 0 ; i <= order - j ; i ++, ui *= u)
+						out[base(order, j) + i] = ui * vj;
+				}
+			}
+
+			// Householder QR of the n x k column major matrix a, applied to both right hand
+			// sides, then back substitution
+			static void solve_least_squares(std::vector<T>& a, size_t n, int k,
+					std::vector<T>& bx, std::vector<T>& by, T *cx, T *cy) {
+				std::vector<T> diag(k);
+
+				for (int j = 0 ; j < k ; j ++) {
+					T *col = &a[j * n];
+
+					T norm = 0;
+					for (size_t i = j ; i < n ; i ++)
+						norm += col[i] * col[i];
+					norm = std::sqrt(norm);
+
+					T reference = 0;
+					for (size_t i = 0 ; i < n ; i ++)
+						reference = std::max(reference, std::abs(col[i]));
+
+					if (norm <= reference * 1e-12)
+						throw std::invalid_argument("GCPs don't determine the polynomial (degenerate layout)");
+
+					T alpha = (col[j] > 0) ? -norm : norm;
+					col[j] -= alpha;
+
+					T vnorm2 = 0;
+					for (size_t i = j ; i < n ; i ++)
+						vnorm2 += col[i] * col[i];
+
+					// reflect the remaining columns and the right hand sides
+					auto reflect = [&](T *target) {
+						T d = 0;
+						for (size_t i = j ; i < n ; i ++)
+							d += col[i] * target[i];
+
+						T f = 2 * d / vnorm2;
+						for (size_t i = j ; i < n ; i ++)
+							target[i] -= f * col[i];
+					};
+
+					for (int c = j + 1 ; c < k ; c ++)
+						reflect(&a[c * n]);
+
+					reflect(&bx[0]);
+					reflect(&by[0]);
+
+					diag[j] = alpha;
+				}
+
+				for (int j = k - 1 ; j >= 0 ; j --) {
+					T sx = bx[j], sy = by[j];
+					for (int c = j + 1 ; c < k ; c ++) {
+						sx -= a[c * n + j] * cx[c];
+						sy -= a[c * n + j] * cy[c];
+					}
+
+					cx[j] = sx / diag[j];
+					cy[j] = sy / diag[j];
+				}
+			}
+		};
+	}
+
+	template<>
+	struct device_op<transforms::polynomial<double>> {
+		typedef device::polynomial_constants constants_type;
+
+		static std::string source() {
+			return std::string(device::common_source()) + device::polynomial_source();
+		}
+
+		static const char *function() { return "polynomial_apply"; }
+		static const char *constants_name() { return "polynomial_constants"; }
+
+		static const constants_type& constants(const transforms::polynomial<double>& p) { return p.consts; }
+	};
+}
+
+#endif // __transform_transforms_polynomial_hpp__
@@ -0,0 +1,52 @@
+// polynomial_device.hpp
+// Polynomial kernels shared by the CPU and OpenCL backends, see device.hpp
+//
+
+#ifndef __transform_transforms_polynomial_device_hpp__
+#define __transform_transforms_polynomial_device_hpp__
+
+#include "../device.hpp"
+
+namespace transform {
+	namespace device {
+		// coefficients are laid out as for an order 3 polynomial whatever the order, terms
+		// by powers of v then powers of u (see polynomial), so v^j starts at
+		// 4j - j(j - 1) / 2.  The order bounds the Horner loops, it is the same for every
+		// point so batches still vectorize.
+		//
+		TRANSFORM_DEVICE_SOURCE(polynomial,
+			typedef struct {
+				double cx[10], cy[10];
+				double x0, y0, scale;	// u = (x - x0) * scale, v = (y - y0) * scale
+				double order;
+			} polynomial_constants;
+
+			TRANSFORM_DEVICE double polynomial_horner(const double *c, int order, double u, double v) {
+				double acc = 0.;
+
+				for (int j = order ; j >= 0 ; j --) {
+					int base = 4 * j - j * (j - 1) / 2;
+
+					double inner = 0.;
+					for (int i = order - j ; i >= 0 ; i --)
+						inner = inner * u + c[base + i];
+
+					acc = acc * v + inner;
+				}
+
+				return acc;
+			}
+
+			TRANSFORM_DEVICE void polynomial_apply(const polynomial_constants *c,
+					double x, double y, double *ox, double *oy) {
+				int order = (int)c->order;
+				double u = (x - c->x0) * c->scale, v = (y - c->y0) * c->scale;
+
+				*ox = polynomial_horner(c->cx, order, u, v);
+				*oy = polynomial_horner(c->cy, order, u, v);
+			}
+		)
+	}
+}
+
+#endif // __transform_transforms_polynomial_device_hpp__
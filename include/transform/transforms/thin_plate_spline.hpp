@@ -0,0 +1,204 @@
+// thin_plate_spline.hpp
+// Thin-plate spline rubber sheeting through control points
+//
+
+#ifndef __transform_transforms_thin_plate_spline_hpp__
+#define __transform_transforms_thin_plate_spline_hpp__
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace transform {
+	namespace transforms {
+		// interpolating thin-plate spline for each output coordinate,
+		//
+		//   f(p) = a0 + a1 u + a2 v + sum_i w_i U(|p - c_i|),  U(r) = r^2 log r
+		//
+		// with (u, v) the inputs centred and scaled like the control points c_i.  The spline
+		// passes through every control point (or close to them with a regularization > 0)
+		// and bends as little as possible in between.
+		//
+		// The (n + 3) x (n + 3) system is solved once on construction, which is O(n^3) and
+		// takes a few seconds for a few thousand control points.  The solved model is shared
+		// between copies.
+		//
+		// A direct evaluation costs O(n) per point.  With a max_error > 0 CPU batches are
+		// split into tiles which are interpolated biquadratically from a 3x3 lattice of
+		// exact values wherever four exact check points inside the tile agree with the
+		// interpolation to within max_error (|dx| + |dy|, in output units), and subdivided
+		// otherwise.  Like approximate_transformer the bound is checked at samples, not
+		// proven.
+		//
+		template<typename T>
+		struct thin_plate_spline {
+			struct model {
+				T x0, y0, scale;
+
+				// normalized control points and their weights
+				std::vector<T> cx, cy, wx, wy;
+
+				// affine part over 1, u, v
+				T ax[3], ay[3];
+			};
+
+			std::shared_ptr<const model> m;
+			T max_error;
+
+			thin_plate_spline(const std::vector<T>& src_x, const std::vector<T>& src_y,
+					const std::vector<T>& dst_x, const std::vector<T>& dst_y,
+					T max_error_ = 0, T regularization = 0) : max_error(max_error_) {
+				m = solve(src_x, src_y, dst_x, dst_y, regularization);
+			}
+
+			static T kernel(T d2) {
+				// r^2 log r written in terms of r^2
+				return (d2 > 0) ? T(0.5) * d2 * std::log(d2) : T(0);
+			}
+
+			template<typename TOut>
+			void op(const T& x, const T& y, TOut& xo, TOut& yo) const {
+				const model& s = *m;
+				T u = (x - s.x0) * s.scale, v = (y - s.y0) * s.scale;
+
+				T sx = s.ax[0] + s.ax[1] * u + s.ax[2] * v,
+				  sy = s.ay[0] + s.ay[1] * u + s.ay[2] * v;
+
+				for (size_t i = 0, n = s.cx.size() ; i < n ; i ++) {
+					T du = u - s.cx[i], dv = v - s.cy[i];
+					T k = kernel(du * du + dv * dv);
+
+					sx += s.wx[i] * k;
+					sy += s.wy[i] * k;
+				}
+
+				xo = static_cast<TOut>(sx);
+				yo = static_cast<TOut>(sy);
+			}
+
+			private:
+			static std::shared_ptr<const model> solve(
+					const std::vector<T>& src_x, const std::vector<T>& src_y,
+					const std::vector<T>& dst_x, const std::vector<T>& dst_y,
+					T regularization) {
+				size_t n = src_x.size();
+
+				if (src_y.size() != n || dst_x.size() != n || dst_y.size() != n)
+					throw std::invalid_argument("Control point arrays differ in size");
+
+				if (n < 3)
+					throw std::invalid_argument("A thin-plate spline needs at least 3 control points");
+
+				std::shared_ptr<model> s(new model);
+
+				// centre on the mean and scale the largest deviation to 1
+				T mx = 0, my = 0;
+				for (size_t i = 0 ; i < n ; i ++) {
+					mx += src_x[i];
+					my += src_y[i];
+				}
+				mx /= n;
+				my /= n;
+
+				T extent = 0;
+				for (size_t i = 0 ; i < n ; i ++)
+					extent = std::max(extent, std::max(std::abs(src_x[i] - mx), std::abs(src_y[i] - my)));
+
+				s->x0 = mx;
+				s->y0 = my;
+				s->scale = (extent > 0) ? 1 / extent : 1;
+
+				s->cx.resize(n);
+				s->cy.resize(n);
+				for (size_t i = 0 ; i < n ; i ++) {
+					s->cx[i] = (src_x[i] - mx) * s->scale;
+					s->cy[i] = (src_y[i] - my) * s->scale;
+				}
+
+				// [ K + l I  P ] [ w ]   [ dst ]
+				// [ P^T      0 ] [ a ] = [  0  ]
+				//
+				size_t k = n + 3;
+				std::vector<T> a(k * k, T(0)), bx(k, T(0)), by(k, T(0));
+
+				for (size_t i = 0 ; i < n ; i ++) {
+					for (size_t j = 0 ; j < n ; j ++) {
+						T du = s->cx[i] - s->cx[j], dv = s->cy[i] - s->cy[j];
+						a[i * k + j] = kernel(du * du + dv * dv);
+					}
+
+					a[i * k + i] += regularization;
+
+					const T p[3] = { 1, s->cx[i], s->cy[i] };
+					for (size_t j = 0 ; j < 3 ; j ++) {
+						a[i * k + n + j] = p[j];
+						a[(n + j) * k + i] = p[j];
+					}
+
+					bx[i] = dst_x[i];
+					by[i] = dst_y[i];
+				}
+
+				lu_solve(a, k, bx, by);
+
+				s->wx.assign(bx.begin(), bx.begin() + n);
+				s->wy.assign(by.begin(), by.begin() + n);
+				std::copy(bx.begin() + n, bx.end(), s->ax);
+				std::copy(by.begin() + n, by.end(), s->ay);
+
+				return s;
+			}
+
+			// Gaussian elimination with partial pivoting on the row major k x k matrix a,
+			// solving for both right hand sides in place
+			static void lu_solve(std::vector<T>& a, size_t k, std::vector<T>& bx, std::vector<T>& by) {
+				T reference = 0;
+				for (T e : a)
+					reference = std::max(reference, std::abs(e));
+
+				for (size_t c = 0 ; c < k ; c ++) {
+					size_t pivot = c;
+					for (size_t r = c + 1 ; r < k ; r ++)
+						if (std::abs(a[r * k + c]) > std::abs(a[pivot * k + c]))
+							pivot = r;
+
+					if (std::abs(a[pivot * k + c]) <= reference * 1e-13)
+						throw std::invalid_argument("Control points don't determine the spline (duplicate or collinear points)");
+
+					if (pivot != c) {
+						std::swap_ranges(a.begin() + c * k, a.begin() + (c + 1) * k, a.begin() + pivot * k);
+						std::swap(bx[c], bx[pivot]);
+						std::swap(by[c], by[pivot]);
+					}
+
+					const T *prow = &a[c * k];
+					for (size_t r = c + 1 ; r < k ; r ++) {
+						T *row = &a[r * k];
+						T f = row[c] / prow[c];
+
+						for (size_t j = c ; j < k ; j ++)
+							row[j] -= f * prow[j];
+
+						bx[r] -= f * bx[c];
+						by[r] -= f * by[c];
+					}
+				}
+
+				for (size_t c = k ; c -- > 0 ; ) {
+					T sx = bx[c], sy = by[c];
+					for (size_t j = c + 1 ; j < k ; j ++) {
+						sx -= a[c * k + j] * bx[j];
+						sy -= a[c * k + j] * by[j];
+					}
+
+					bx[c] = sx / a[c * k + c];
+					by[c] = sy / a[c * k + c];
+				}
+			}
+		};
+	}
+}
+
+#endif // __transform_transforms_thin_plate_spline_hpp__
@@ -10,6 +10,9 @@
 
 namespace transform {
 	namespace util {
+		constexpr double TO_RADIANS = 0.017453292519943295769236907684886;
+		constexpr double TO_DEGREES = 57.295779513082320876798154814105;
+
 		template<typename Function>
 		static inline long long timeit(Function& f) {
 			typedef std::chrono::high_resolution_clock Clock;
@@ -54,6 +57,62 @@ namespace transform {
 				return mlfn<TEllipsoid>(phi, std::sin(phi), std::cos(phi));
 			}
 
+			// same as above, for ellipsoids only known at runtime
+			template<typename T>
+			static inline T mlfn(const T *en, const T& phi, const T& sphi_in, const T& cphi_in) {
+				T cphi = cphi_in * sphi_in;
+				T sphi = sphi_in * sphi_in;
+
+				return(en[0] * phi - cphi * (en[1] + sphi * (en[2]
+								+ sphi * (en[3] + sphi * en[4]))));
+			}
+
+			// meridional distance series coefficients for eccentricity squared es
+			template<typename T>
+			static inline void enfn(const T& es, T *en) {
+				const T C00 = 1.,
+					  C02 = .25,
+					  C04 = .046875,
+					  C06 = .01953125,
+					  C08 = .01068115234375,
+					  C22 = .75,
+					  C44 = .46875,
+					  C46 = .01302083333333333333,
+					  C48 = .00712076822916666666,
+					  C66 = .36458333333333333333,
+					  C68 = .00569661458333333333,
+					  C88 = .3076171875;
+
+				T t;
+
+				en[0] = C00 - es * (C02 + es * (C04 + es * (C06 + es * C08)));
+				en[1] = es * (C22 - es * (C04 + es * (C06 + es * C08)));
+				en[2] = (t = es * es) * (C44 - es * (C46 + es * C48));
+				en[3] = (t *= es) * (C66 - es * C68);
+				en[4] = t * es * C88;
+			}
+
+			template<typename T>
+			static inline T inv_mlfn(const T *en, const T& es, const T& argphi) {
+				T phi, sinPhi, cosPhi, t;
+				T k = 1./(1.-es);
+
+				phi = argphi;
+				int iter = 20;
+				do {
+					sinPhi = std::sin(phi);
+					cosPhi = std::cos(phi);
+
+					t = 1. - es * sinPhi * sinPhi;
+					t = (mlfn(en, phi, sinPhi, cosPhi) - argphi) * (t * std::sqrt(t)) * k;
+					phi -= t;
+					if (fabs(t) < 1e-12)
+						break;
+				} while(--iter);
+
+				return phi;
+			}
+
 			template<typename TEllipsoid, typename T>
 			static inline T inv_mlfn(const T& argphi) {
 				typedef typename TEllipsoid::params p;
@@ -77,6 +136,56 @@ namespace transform {
 
 				return phi;
 			}
+
+			// inv_mlfn with a fixed number of iterations for vectorized loops, Newton's method
+			// converges quadratically so a handful is plenty for double precision
+			template<typename T>
+			static inline T inv_mlfn_fixed(const T *en, const T& es, const T& argphi) {
+				const int iterations = 5;
+
+				T k = 1./(1.-es);
+				T phi = argphi;
+
+				for (int i = 0 ; i < iterations ; i ++) {
+					T sinPhi = std::sin(phi), cosPhi = std::cos(phi);
+
+					T t = 1. - es * sinPhi * sinPhi;
+					phi -= (mlfn(en, phi, sinPhi, cosPhi) - argphi) * (t * std::sqrt(t)) * k;
+				}
+
+				return phi;
+			}
+
+			// radius of the parallel at phi over the major axis
+			template<typename T>
+			static inline T msfn(const T& sinphi, const T& cosphi, const T& es) {
+				return cosphi / std::sqrt(1. - es * sinphi * sinphi);
+			}
+
+			// isometric latitude term used by conformal projections
+			template<typename T>
+			static inline T tsfn(const T& phi, const T& sinphi, const T& e) {
+				T es = sinphi * e;
+				return std::tan(.5 * (M_PI_2 - phi)) / std::pow((1. - es) / (1. + es), .5 * e);
+			}
+
+			// latitude from the isometric latitude term ts, the inverse of tsfn.  Runs a fixed
+			// number of iterations so it can be used in vectorized loops, every iteration
+			// shrinks the error by a factor of roughly es
+			template<typename T>
+			static inline T phi2(const T& ts, const T& e) {
+				const int iterations = 8;
+
+				T he = .5 * e;
+				T phi = M_PI_2 - 2. * std::atan(ts);
+
+				for (int i = 0 ; i < iterations ; i ++) {
+					T con = e * std::sin(phi);
+					phi = M_PI_2 - 2. * std::atan(ts * std::pow((1. - con) / (1. + con), he));
+				}
+
+				return phi;
+			}
 		}
 	}
 }
@@ -0,0 +1,201 @@
+// utm.hpp
+// Latlong to UTM for points spread over many zones
+//
+
+#ifndef __transform_utm_hpp__
+#define __transform_utm_hpp__
+
+#include "concurrency.hpp"
+#include "transforms/cartographic.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace transform {
+	// utm_transformer projects every point into the UTM zone its longitude (and latitude, for
+	// the Norway and Svalbard exceptions) puts it in.  Points are bucketed by zone and
+	// hemisphere with a parallel counting sort, every bucket runs through the backend as a
+	// plain latlong -> tmerc batch and results are scattered back into input order.
+	//
+	// Zones are reported as the zone number for the northern hemisphere and its negation
+	// for the southern one.  Points without a zone (see utm_zone) go to a bucket of their
+	// own which never reaches the backend, they come out as HUGE_VAL in zone 0.
+	//
+	template<
+		typename TBackend,
+		unsigned MaxConcurrency = 0
+	>
+	class utm_transformer {
+		public:
+		utm_transformer(): b_() { }
+
+		template<
+			typename TEllipsoid,
+			typename ForwardIterableInputRange,
+			typename ForwardIterableOutputRange,
+			typename ForwardIterableZoneRange
+		>
+		void run(const ForwardIterableInputRange& lon, const ForwardIterableInputRange& lat,
+				ForwardIterableOutputRange& xOut, ForwardIterableOutputRange& yOut,
+				ForwardIterableZoneRange& zones) {
+			typedef typename boost::range_value<ForwardIterableInputRange>::type value_type;
+			typedef typename boost::range_value<ForwardIterableOutputRange>::type output_type;
+			typedef typename boost::range_value<ForwardIterableZoneRange>::type zone_type;
+
+			typedef cartographic::projections::latlong						projection_from;
+			typedef cartographic::projections::tmerc<TEllipsoid, double>	projection_to;
+
+			size_t size = boost::size(lon);
+
+			assert(size == boost::size(lat));
+			assert(size == boost::size(xOut));
+			assert(boost::size(xOut) == boost::size(yOut));
+			assert(size == boost::size(zones));
+
+			if (size == 0)
+				return;
+
+			auto lon_in = boost::begin(lon), lat_in = boost::begin(lat);
+			auto x_out = boost::begin(xOut), y_out = boost::begin(yOut);
+			auto zone_out = boost::begin(zones);
+
+			unsigned threads = std::max(1u, utility::scheduler<MaxConcurrency>::concurrency());
+			size_t per_batch = size / threads;
+
+			auto batch_start = [per_batch](unsigned i) { return per_batch * i; };
+			auto batch_end = [per_batch, size, threads](unsigned i) {
+				return (i == threads - 1) ? size : per_batch * (i + 1);
+			};
+
+			// pass 1, work out the bucket of each point and count per thread
+			//
+			std::vector<uint8_t> keys(size);
+			std::vector<size_t> offsets(threads * buckets, 0);
+
+			{
+				utility::scheduler<MaxConcurrency> s;
+				for (unsigned t = 0 ; t < threads ; t ++) {
+					s.queue([&, t]() {
+						size_t *hist = &offsets[t * buckets];
+						for (size_t i = batch_start(t), e = batch_end(t) ; i < e ; i ++) {
+							value_type l = lon_in[i], p = lat_in[i];
+							int zone = cartographic::projections::utm_zone(l, p);
+
+							uint8_t k = (zone == 0) ? static_cast<uint8_t>(no_zone) :
+								static_cast<uint8_t>((zone - 1) * 2 + (p < 0 ? 1 : 0));
+							keys[i] = k;
+							hist[k] ++;
+						}
+					});
+				}
+				s.wait();
+			}
+
+			// turn counts into where each thread starts writing each bucket, buckets are
+			// laid out one after the other and threads one after the other within a bucket
+			//
+			std::vector<size_t> bucket_start(buckets + 1, 0);
+			size_t running = 0;
+			for (unsigned b = 0 ; b < buckets ; b ++) {
+				bucket_start[b] = running;
+				for (unsigned t = 0 ; t < threads ; t ++) {
+					size_t count = offsets[t * buckets + b];
+					offsets[t * buckets + b] = running;
+					running += count;
+				}
+			}
+			bucket_start[buckets] = running;
+
+			// pass 2, scatter points into their buckets
+			//
+			std::vector<double> sorted_lon(size), sorted_lat(size),
+				sorted_x(size), sorted_y(size);
+			std::vector<size_t> order(size);
+
+			{
+				utility::scheduler<MaxConcurrency> s;
+				for (unsigned t = 0 ; t < threads ; t ++) {
+					s.queue([&, t]() {
+						size_t *next = &offsets[t * buckets];
+						for (size_t i = batch_start(t), e = batch_end(t) ; i < e ; i ++) {
+							size_t pos = next[keys[i]] ++;
+
+							sorted_lon[pos] = lon_in[i];
+							sorted_lat[pos] = lat_in[i];
+							order[pos] = i;
+						}
+					});
+				}
+				s.wait();
+			}
+
+			// every bucket is a homogeneous batch for a single tmerc
+			//
+			typedef boost::iterator_range<std::vector<double>::iterator> slice;
+
+			for (unsigned b = 0 ; b < buckets ; b ++) {
+				size_t first = bucket_start[b], last = bucket_start[b + 1];
+				if (first == last)
+					continue;
+
+				if (b == no_zone) {
+					std::fill(sorted_x.begin() + first, sorted_x.begin() + last, HUGE_VAL);
+					std::fill(sorted_y.begin() + first, sorted_y.begin() + last, HUGE_VAL);
+					continue;
+				}
+
+				transforms::projection<projection_from, projection_to> p(
+						projection_from(),
+						cartographic::projections::utm<TEllipsoid, double>(b / 2 + 1, b % 2 == 1));
+
+				const slice in_x(sorted_lon.begin() + first, sorted_lon.begin() + last),
+					  in_y(sorted_lat.begin() + first, sorted_lat.begin() + last);
+				slice out_x(sorted_x.begin() + first, sorted_x.begin() + last),
+					  out_y(sorted_y.begin() + first, sorted_y.begin() + last);
+
+				b_.run(p, in_x, in_y, out_x, out_y);
+			}
+
+			// and put everything back where it came from
+			//
+			{
+				utility::scheduler<MaxConcurrency> s;
+				for (unsigned t = 0 ; t < threads ; t ++) {
+					s.queue([&, t]() {
+						for (unsigned b = 0 ; b < buckets ; b ++) {
+							// each thread handles the same share of every bucket it filled
+							size_t first = (t == 0) ? bucket_start[b] : offsets[(t - 1) * buckets + b],
+								   last = offsets[t * buckets + b];
+
+							zone_type zone = static_cast<zone_type>((b == no_zone) ? 0 :
+									b % 2 == 1 ? -(int)(b / 2 + 1) : (int)(b / 2 + 1));
+
+							for (size_t pos = first ; pos < last ; pos ++) {
+								size_t i = order[pos];
+
+								x_out[i] = static_cast<output_type>(sorted_x[pos]);
+								y_out[i] = static_cast<output_type>(sorted_y[pos]);
+								zone_out[i] = zone;
+							}
+						}
+					});
+				}
+				s.wait();
+			}
+		}
+
+		private:
+		// 60 zones, north and south, and the points without one
+		static const unsigned no_zone = 120;
+		static const unsigned buckets = 121;
+
+		TBackend b_;
+	};
+}
+
+#endif // __transform_utm_hpp__
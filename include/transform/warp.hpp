@@ -0,0 +1,233 @@
+// warp.hpp
+// Tiled raster reprojection built on top of backends
+//
+
+#ifndef __transform_warp_hpp__
+#define __transform_warp_hpp__
+
+#include "concurrency.hpp"
+#include "approximate.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+namespace transform {
+	namespace raster {
+		// maps pixel (col, row) to georeferenced (x, y), the top left corner of the raster
+		// is at origin, pixel_height is usually negative for north-up images
+		//
+		struct geo_transform {
+			double origin_x, origin_y;
+			double pixel_width, pixel_height;
+
+			geo_transform(double ox, double oy, double pw, double ph):
+				origin_x(ox), origin_y(oy), pixel_width(pw), pixel_height(ph) { }
+		};
+
+		// non-owning view of a single band raster, row major without padding
+		//
+		template<typename T>
+		struct image {
+			T *data;
+			size_t width, height;
+			geo_transform gt;
+
+			image(T *d, size_t w, size_t h, const geo_transform& g):
+				data(d), width(w), height(h), gt(g) { }
+		};
+
+		enum class resampling {
+			nearest,
+			bilinear
+		};
+
+		namespace detail {
+			template<typename T>
+			static inline T round_to(double v, std::true_type) {
+				return static_cast<T>(std::floor(v + 0.5));
+			}
+
+			template<typename T>
+			static inline T round_to(double v, std::false_type) {
+				return static_cast<T>(v);
+			}
+
+			// sample src at fractional pixel position (c, r), where pixel centres are at
+			// integer positions.  Returns false if the position falls outside the raster.
+			//
+			template<typename T>
+			static inline bool sample(const image<const T>& src, double c, double r,
+					resampling method, T& out) {
+				double w = static_cast<double>(src.width),
+					   h = static_cast<double>(src.height);
+
+				// negated so NaNs coming from failed transforms end up outside too
+				if (!(c >= -0.5 && c < w - 0.5 && r >= -0.5 && r < h - 0.5))
+					return false;
+
+				if (method == resampling::nearest) {
+					size_t ic = static_cast<size_t>(c + 0.5),
+						   ir = static_cast<size_t>(r + 0.5);
+
+					out = src.data[ir * src.width + ic];
+					return true;
+				}
+
+				double fc = std::floor(c), fr = std::floor(r);
+				double tc = c - fc, tr = r - fr;
+
+				long c0 = static_cast<long>(fc), r0 = static_cast<long>(fr);
+				long last_c = static_cast<long>(src.width) - 1,
+					 last_r = static_cast<long>(src.height) - 1;
+
+				size_t c0i = static_cast<size_t>(std::max(c0, 0L)),
+					   c1i = static_cast<size_t>(std::min(c0 + 1, last_c)),
+					   r0i = static_cast<size_t>(std::max(r0, 0L)),
+					   r1i = static_cast<size_t>(std::min(r0 + 1, last_r));
+
+				const T *row0 = src.data + r0i * src.width,
+						*row1 = src.data + r1i * src.width;
+
+				double top = row0[c0i] + (row0[c1i] - static_cast<double>(row0[c0i])) * tc,
+					   bottom = row1[c0i] + (row1[c1i] - static_cast<double>(row1[c0i])) * tc;
+
+				out = round_to<T>(top + (bottom - top) * tr,
+						std::integral_constant<bool, std::is_integral<T>::value>());
+				return true;
+			}
+		}
+	}
+
+	// warper reprojects a raster tile by tile.  For every destination tile the georeferenced
+	// pixel centres are mapped back into the source raster through the given transform (so
+	// when warping latlong -> tmerc the transform is projection<tmerc, latlong>), after which
+	// the source is resampled.
+	//
+	// Coordinates for a batch of tiles (one per worker) are generated with a single backend
+	// run, which lets multi_cpu and opencl backends do the heavy lifting, the batch is then
+	// resampled by the workers in parallel.  Scratch memory is bounded by
+	// workers * tile_size^2 points no matter how large the rasters are.
+	//
+	// A non-zero max_error generates coordinates through an approximate_transformer with the
+	// given tolerance in source units.
+	//
+	template<
+		typename TBackend,
+		unsigned MaxConcurrency = 0
+	>
+	class warper {
+		public:
+		warper(size_t tile_size = 256, double max_error = 0.0):
+			tile_size_(tile_size), approx_(max_error) {
+			assert(tile_size_ > 0);
+		}
+
+		template<
+			typename TTransform,
+			typename T
+		>
+		void run(const TTransform& dst_to_src,
+				const raster::image<const T>& src, raster::image<T>& dst,
+				raster::resampling method, const T& nodata) {
+			size_t tiles_x = (dst.width + tile_size_ - 1) / tile_size_,
+				   tiles_y = (dst.height + tile_size_ - 1) / tile_size_;
+			size_t tile_count = tiles_x * tiles_y;
+
+			if (tile_count == 0)
+				return;
+
+			size_t workers = std::max(1u, utility::scheduler<MaxConcurrency>::concurrency());
+			size_t tile_points = tile_size_ * tile_size_;
+
+			std::vector<double> x(workers * tile_points), y(workers * tile_points),
+				sx(workers * tile_points), sy(workers * tile_points);
+
+			for (size_t first = 0 ; first < tile_count ; first += workers) {
+				size_t batch = std::min(workers, tile_count - first);
+				size_t points = batch * tile_points;
+
+				// destination pixel centres for every tile in this batch, edge tiles are padded
+				// out to a full tile so every row has the same length
+				//
+				for (size_t t = 0 ; t < batch ; t ++) {
+					size_t tc = (first + t) % tiles_x, tr = (first + t) / tiles_x;
+
+					double *px = &x[t * tile_points], *py = &y[t * tile_points];
+					for (size_t r = 0 ; r < tile_size_ ; r ++) {
+						double gy = dst.gt.origin_y + (tr * tile_size_ + r + 0.5) * dst.gt.pixel_height;
+						for (size_t c = 0 ; c < tile_size_ ; c ++) {
+							*px++ = dst.gt.origin_x + (tc * tile_size_ + c + 0.5) * dst.gt.pixel_width;
+							*py++ = gy;
+						}
+					}
+				}
+
+				transform_coordinates(dst_to_src, x, y, sx, sy, points);
+
+				utility::scheduler<MaxConcurrency> s;
+				for (size_t t = 0 ; t < batch ; t ++) {
+					s.queue([&, t]() {
+						resample_tile(src, dst, method, nodata,
+							(first + t) % tiles_x, (first + t) / tiles_x,
+							&sx[t * tile_points], &sy[t * tile_points]);
+					});
+				}
+
+				s.wait();
+			}
+		}
+
+		size_t tile_size() const { return tile_size_; }
+
+		private:
+		template<typename TTransform>
+		void transform_coordinates(const TTransform& p,
+				std::vector<double>& x, std::vector<double>& y,
+				std::vector<double>& sx, std::vector<double>& sy, size_t points) {
+			// backends expect ranges which match in size, so trim the last short batch
+			x.resize(points); y.resize(points);
+			sx.resize(points); sy.resize(points);
+
+			if (approx_.max_error() > 0.0)
+				approx_.run(p, x, y, sx, sy, tile_size_);
+			else
+				approx_.backend().run(p, x, y, sx, sy);
+		}
+
+		template<typename T>
+		void resample_tile(const raster::image<const T>& src, raster::image<T>& dst,
+				raster::resampling method, const T& nodata,
+				size_t tc, size_t tr, const double *sx, const double *sy) const {
+			size_t c0 = tc * tile_size_, r0 = tr * tile_size_;
+			size_t cols = std::min(tile_size_, dst.width - c0),
+				   rows = std::min(tile_size_, dst.height - r0);
+
+			double inv_pw = 1.0 / src.gt.pixel_width,
+				   inv_ph = 1.0 / src.gt.pixel_height;
+
+			for (size_t r = 0 ; r < rows ; r ++) {
+				T *out = dst.data + (r0 + r) * dst.width + c0;
+				const double *px = sx + r * tile_size_, *py = sy + r * tile_size_;
+
+				for (size_t c = 0 ; c < cols ; c ++) {
+					// pixel centres sit at integer positions in source pixel space
+					double pc = (px[c] - src.gt.origin_x) * inv_pw - 0.5,
+						   pr = (py[c] - src.gt.origin_y) * inv_ph - 0.5;
+
+					if (!raster::detail::sample(src, pc, pr, method, out[c]))
+						out[c] = nodata;
+				}
+			}
+		}
+
+		size_t tile_size_;
+
+		// also provides the backend for exact runs, so there is only ever one instance
+		approximate_transformer<TBackend> approx_;
+	};
+}
+
+#endif // __transform_warp_hpp__
@@ -0,0 +1,61 @@
+// basic_cpu.cpp
+// CPU batch specializations for basic transforms
+//
+
+#include "transform/transforms/basic.hpp"
+#include "transform/transforms/polynomial.hpp"
+#include "transform/cpu_op.hpp"
+
+namespace transform {
+	using namespace transforms;
+
+	template<>
+	void do_batch_op<affine<double>, double, double>(const affine<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::affine_constants c = p.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::affine_apply(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<homography<double>, double, double>(const homography<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::homography_constants c = p.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::homography_apply(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	namespace {
+		// the order as a constant, so the Horner loops unroll and the batch loop stays
+		// vectorizable
+		template<int Order>
+		void polynomial_batch(const polynomial<double>& p,
+				const double *x, const double *y, double *ox, double *oy, size_t count) {
+			const device::polynomial_constants c = p.consts;
+
+			TRANSFORM_SIMD_LOOP
+			for (size_t i = 0 ; i < count ; i ++) {
+				double u = (x[i] - c.x0) * c.scale, v = (y[i] - c.y0) * c.scale;
+
+				ox[i] = device::polynomial_horner(c.cx, Order, u, v);
+				oy[i] = device::polynomial_horner(c.cy, Order, u, v);
+			}
+		}
+	}
+
+	template<>
+	void do_batch_op<polynomial<double>, double, double>(const polynomial<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		switch (p.order) {
+			case 1: polynomial_batch<1>(p, x, y, ox, oy, count); break;
+			case 2: polynomial_batch<2>(p, x, y, ox, oy, count); break;
+			default: polynomial_batch<3>(p, x, y, ox, oy, count); break;
+		}
+	}
+}
@@ -3,8 +3,13 @@
 //
 
 #include "transform/transforms/cartographic.hpp"
+#include "transform/transforms/datum.hpp"
 #include <stdio.h>
 
+#include <limits>
+#include <algorithm>
+#include <vector>
+
 #define FC1 1.
 #define FC2 .5
 #define FC3 .16666666666666666666
@@ -22,204 +27,989 @@ namespace transform {
 	using namespace cartographic::ellipsoids;
 
 	template<>
-	void do_op<
-		projection<latlong, tmerc<sphere, double>>, double, double
-	>( const projection<latlong, tmerc<sphere, double>>& p,
-			const double& x, const double& y, double& ox, double&oy) {
-		struct {
-			double lam, phi;
-		} lp;
-
-		struct _P {
-			double phi0;
-		};
+	void do_op<projection<latlong, tmerc<sphere, double>>, double, double>(
+			const projection<latlong, tmerc<sphere, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::tmerc_forward(&p.to.consts, x, y, &ox, &oy);
+	}
 
-		struct _P __P = { 0.0 };
-		struct _P *P = &__P;
+	template<>
+	void do_op<projection<latlong, tmerc<WGS84, double>>, double, double>(
+			const projection<latlong, tmerc<WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::tmerc_forward(&p.to.consts, x, y, &ox, &oy);
+	}
 
+	template<>
+	void do_op<projection<tmerc<sphere, double>, latlong>, double, double>(
+			const projection<tmerc<sphere, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::tmerc_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		struct {
-			double x, y;
-		} xy;
+	template<>
+	void do_op<projection<tmerc<WGS84, double>, latlong>, double, double>(
+			const projection<tmerc<WGS84, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::tmerc_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_op<projection<latlong, tmerc<runtime, double>>, double, double>(
+			const projection<latlong, tmerc<runtime, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::tmerc_forward(&p.to.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_op<projection<tmerc<runtime, double>, latlong>, double, double>(
+			const projection<tmerc<runtime, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::tmerc_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_batch_op<projection<latlong, tmerc<sphere, double>>, double, double>(
+			const projection<latlong, tmerc<sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::tmerc_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::tmerc_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<tmerc<sphere, double>, latlong>, double, double>(
+			const projection<tmerc<sphere, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::tmerc_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::tmerc_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<latlong, tmerc<WGS84, double>>, double, double>(
+			const projection<latlong, tmerc<WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::tmerc_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::tmerc_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<tmerc<WGS84, double>, latlong>, double, double>(
+			const projection<tmerc<WGS84, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::tmerc_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::tmerc_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<latlong, tmerc<runtime, double>>, double, double>(
+			const projection<latlong, tmerc<runtime, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::tmerc_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::tmerc_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		lp.lam = x * 0.017453292519943295769236907684886;
-		lp.phi = y * 0.017453292519943295769236907684886;
+	template<>
+	void do_batch_op<projection<tmerc<runtime, double>, latlong>, double, double>(
+			const projection<tmerc<runtime, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::tmerc_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::tmerc_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		const double aks0 = 1.0;
-		const double aks5 = 0.5 * aks0;
+	// grid kernels working from the constants alone, so runtime ellipsoids get them too.
+	// Every row of the grid shares phi and every column shares lambda, so anything
+	// depending on just one of them is worked out once up front and only the cross terms
+	// are evaluated per cell.
+	//
+	static void tmerc_grid_spherical(const device::tmerc_constants& c,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		constexpr double TO_RADIAN = 0.017453292519943295769236907684886;
 
-		const double scale = 6370997.0;
 		const double EPS10 = 1e-10;
+		const double inf = std::numeric_limits<double>::infinity();
 
-		double b, cosphi;
-		if( lp.lam < -M_PI/2.0 || lp.lam > M_PI/2.0 )
-		{
-			xy.x = xy.y = std::numeric_limits<double>::infinity();
+		struct column {
+			double sin_lambda, cos_lambda;
+			bool valid;
+		};
+
+		std::vector<column> cols(lon_count);
+		for (size_t i = 0 ; i < lon_count ; i ++) {
+			double lambda = util::mod_pi(lon[i] * TO_RADIAN - c.lambda0);
+
+			cols[i].sin_lambda = sin(lambda);
+			cols[i].cos_lambda = cos(lambda);
+			cols[i].valid = !(lambda < -M_PI/2.0 || lambda > M_PI/2.0);
 		}
-		else {
-			b = (cosphi = cos(lp.phi)) * sin(lp.lam);
-			if (fabs(fabs(b) - 1.) <= EPS10) {
-				xy.x = xy.y = std::numeric_limits<double>::infinity();
-			}
-			else {
-				xy.x = aks5 * log((1. + b) / (1. - b));
-				if ((b = fabs( xy.y = cosphi * cos(lp.lam) / sqrt(1. - b * b) )) >= 1.) {
+
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			double phi = lat[r] * TO_RADIAN;
+			double cosphi = cos(phi);
+			bool south = phi < 0.;
+
+			for (size_t i = 0 ; i < lon_count ; i ++, ox ++, oy ++) {
+				const column& col = cols[i];
+
+				double b = cosphi * col.sin_lambda;
+				if (!col.valid || fabs(fabs(b) - 1.) <= EPS10) {
+					*ox = *oy = inf;
+					continue;
+				}
+
+				double x = 0.5 * log((1. + b) / (1. - b));
+				double y = cosphi * col.cos_lambda / sqrt(1. - b * b);
+
+				if ((b = fabs(y)) >= 1.) {
 					if ((b - 1.) > EPS10) {
-						xy.x = xy.y = std::numeric_limits<double>::infinity();
+						*ox = *oy = inf;
+						continue;
 					}
-					else xy.y = 0.;
-				} else
-					xy.y = acos(xy.y);
-				if (lp.phi < 0.) xy.y = -xy.y;
-				xy.y = aks0 * (xy.y - P->phi0);
-
-				xy.x = p.to.offset.first +  scale * xy.x;
-				xy.y = p.to.offset.second + scale * xy.y;
+					y = 0.;
+				}
+				else
+					y = acos(y);
+
+				if (south) y = -y;
+				y -= c.phi0;
+
+				*ox = c.x0 + c.scale * x;
+				*oy = c.y0 + c.scale * y;
 			}
 		}
+	}
+
+	static void tmerc_grid_ellipsoidal(const device::tmerc_constants& c,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		constexpr double TO_RADIAN = 0.017453292519943295769236907684886;
+
+		std::vector<double> lambda(lon_count);
+		for (size_t i = 0 ; i < lon_count ; i ++)
+			lambda[i] = util::mod_pi(lon[i] * TO_RADIAN - c.lambda0);
+
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			double phi = lat[r] * TO_RADIAN;
+
+			double sinPhi = sin(phi), cosPhi = cos(phi), t = 0.0;
+			if (std::abs(cosPhi) > 1.0e-10)
+				t = sinPhi/cosPhi;
+
+			t *= t;
 
-		ox = xy.x;
-		oy = xy.y;
+			double rs = 1.0 / sqrt(1. - c.ecc2 * sinPhi * sinPhi);
+			double n = c.esp * cosPhi * cosPhi;
+			double ml = device::mlfn(c.en, phi, sinPhi, cosPhi) - c.ml0;
+
+			// the series coefficients only depend on the row
+			double x1 = 1. - t + n,
+				   x2 = 5. + t * (t - 18.) + n * (14. - 58. * t),
+				   x3 = 61. + t * ( t * (179. - t) - 479. );
+			double y1 = 5. - t + n * (9. + 4. * n),
+				   y2 = 61. + t * (t - 58.) + n * (270. - 330. * t),
+				   y3 = 1385. + t * ( t * (543. - t) - 3111.);
+			double ys = sinPhi * FC2;
+
+			for (size_t i = 0 ; i < lon_count ; i ++) {
+				double l = lambda[i];
+				double al = cosPhi * l;
+				double als = al * al;
+
+				al *= rs;
+
+				double x = al * (FC1 +
+						FC3 * als * (x1 + FC5 * als * (x2 + FC7 * als * x3)));
+				double y = ml + ys * al * l * (1. +
+						FC4 * als * (y1 + FC6 * als * (y2 + FC8 * als * y3)));
+
+				ox[i] = c.x0 + c.scale * x;
+				oy[i] = c.y0 + c.scale * y;
+			}
+
+			ox += lon_count;
+			oy += lon_count;
+		}
 	}
 
 	template<>
-	void do_op<
+	void do_grid_op<
+		projection<latlong, tmerc<runtime, double>>, double, double
+	>(const projection<latlong, tmerc<runtime, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		if (p.to.consts.spherical > 0.5)
+			tmerc_grid_spherical(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+		else
+			tmerc_grid_ellipsoidal(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	// built from the cached constants like do_op, so run and run_grid agree
+	//
+	template<>
+	void do_grid_op<
+		projection<latlong, tmerc<sphere, double>>, double, double
+	>(const projection<latlong, tmerc<sphere, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		tmerc_grid_spherical(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	template<>
+	void do_grid_op<
 		projection<latlong, tmerc<WGS84, double>>, double, double
 	>(const projection<latlong, tmerc<WGS84, double>>& p,
-			const double& lambda_, const double& phi_, double& ox, double&oy) {
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		tmerc_grid_ellipsoidal(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
 
-		constexpr double TO_RADIAN = 0.017453292519943295769236907684886;
+	template<>
+	void do_op<projection<latlong, webmerc>, double, double>(
+			const projection<latlong, webmerc>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::webmerc_forward(&p.to.consts, x, y, &ox, &oy);
+	}
 
-		typedef cartographic::ellipsoids::WGS84			wgs84;
-		typedef cartographic::ellipsoids::WGS84::params wgs84params;
+	template<>
+	void do_op<projection<webmerc, latlong>, double, double>(
+			const projection<webmerc, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::webmerc_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		constexpr double scale = wgs84params::major_axis;
+	template<>
+	void do_batch_op<projection<latlong, webmerc>, double, double>(
+			const projection<latlong, webmerc>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::webmerc_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::webmerc_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		double lambda = lambda_ * TO_RADIAN;
-		double phi = phi_ * TO_RADIAN;
+	template<>
+	void do_batch_op<projection<webmerc, latlong>, double, double>(
+			const projection<webmerc, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::webmerc_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::webmerc_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		double sinPhi, cosPhi, t, al, als, n;
-		double x, y;
+	// x only depends on the column and y only on the row, but for the rows at the poles
+	// where both are masked
+	//
+	template<>
+	void do_grid_op<projection<latlong, webmerc>, double, double>(
+			const projection<latlong, webmerc>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		std::vector<double> xs(lon_count);
+		double unused;
 
-		sinPhi = sin(phi);
-		cosPhi = cos(phi);
-		t = 0.0;
-		if (std::abs(cosPhi) > 1.0e-10)
-			t = sinPhi/cosPhi;
+		for (size_t c = 0 ; c < lon_count ; c ++)
+			device::webmerc_forward(&p.to.consts, lon[c], 0.0, &xs[c], &unused);
 
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			double x, y;
+			device::webmerc_forward(&p.to.consts, 0.0, lat[r], &x, &y);
 
-		t *= t;
-		al = cosPhi * lambda;
-		als = al * al;
-		al /= sqrt(1. - wgs84params::ecc2 * sinPhi * sinPhi);
-		n = wgs84params::ecc2 / wgs84params::one_ecc2 * cosPhi * cosPhi;
+			if (std::isfinite(x))
+				std::copy(xs.begin(), xs.end(), ox);
+			else
+				std::fill(ox, ox + lon_count, x);
 
-		x = al * (FC1 +
-				FC3 * als * (1. - t + n +
-					FC5 * als * (5. + t * (t - 18.) + n * (14. - 58. * t)
-						+ FC7 * als * (61. + t * ( t * (179. - t) - 479. ) )
-						)));
-		double __r = util::projection::mlfn<wgs84>(phi, sinPhi, cosPhi);
+			std::fill(oy, oy + lon_count, y);
 
-		y = (util::projection::mlfn<wgs84>(phi, sinPhi, cosPhi) - p.to.ml0 +
-				sinPhi * al * lambda * FC2 * ( 1. +
-					FC4 * als * (5. - t + n * (9. + 4. * n) +
-						FC6 * als * (61. + t * (t - 58.) + n * (270. - 330. * t)
-							+ FC8 * als * (1385. + t * ( t * (543. - t) - 3111.) )
-							))));
+			ox += lon_count;
+			oy += lon_count;
+		}
+	}
 
-		ox = p.to.offset.first + scale * x;
-		oy = p.to.offset.second + scale * y;
+	template<>
+	void do_op<projection<latlong, lcc<sphere, double>>, double, double>(
+			const projection<latlong, lcc<sphere, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::lcc_forward(&p.to.consts, x, y, &ox, &oy);
 	}
 
 	template<>
-	void do_op<projection<tmerc<sphere, double>, latlong>, double, double >(
-			const projection<tmerc<sphere, double>, latlong>& p,
-			const double& x_in, const double& y_in, double& ox, double&oy) {
-		typedef cartographic::ellipsoids::sphere			sphere;
-		typedef cartographic::ellipsoids::sphere::params	sphereparams;
+	void do_op<projection<lcc<sphere, double>, latlong>, double, double>(
+			const projection<lcc<sphere, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::lcc_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		constexpr double scale = 1.0 / sphereparams::major_axis;
+	template<>
+	void do_batch_op<projection<latlong, lcc<sphere, double>>, double, double>(
+			const projection<latlong, lcc<sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::lcc_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::lcc_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
+	template<>
+	void do_batch_op<projection<lcc<sphere, double>, latlong>, double, double>(
+			const projection<lcc<sphere, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::lcc_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::lcc_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		double x = (x_in - p.from.offset.first) * scale;
-		double y = (y_in - p.from.offset.second) * scale;
+	template<>
+	void do_op<projection<latlong, lcc<WGS84, double>>, double, double>(
+			const projection<latlong, lcc<WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::lcc_forward(&p.to.consts, x, y, &ox, &oy);
+	}
 
-		double s = scale;
+	template<>
+	void do_op<projection<lcc<WGS84, double>, latlong>, double, double>(
+			const projection<lcc<WGS84, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::lcc_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		double phi0 = 0.0; // TODO: get this value here somehow
-		double lambda0 = 0.0; // TODO: get this value here somehow
+	template<>
+	void do_batch_op<projection<latlong, lcc<WGS84, double>>, double, double>(
+			const projection<latlong, lcc<WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::lcc_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::lcc_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		double h, g, phi, lambda;
+	template<>
+	void do_batch_op<projection<lcc<WGS84, double>, latlong>, double, double>(
+			const projection<lcc<WGS84, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::lcc_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::lcc_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		h = std::exp(x);
-		g = 0.5 * (h - 1.0 / h);
-		h = std::cos(phi0 + y);
+	// polar stereographic, on a grid the distance from the pole only depends on the row and the direction only
+	// on the column
+	//
+	static void stere_grid(const device::stere_constants& c,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		std::vector<double> sin_lambda(lon_count), cos_lambda(lon_count);
+		for (size_t i = 0 ; i < lon_count ; i ++) {
+			double lambda = util::mod_pi(lon[i] * util::TO_RADIANS - c.lambda0);
+
+			sin_lambda[i] = sin(lambda);
+			cos_lambda[i] = -c.sign * cos(lambda);
+		}
 
-		phi = std::asin(std::sqrt((1.0 - h * h) / (1.0 + g * g)));
-		if (y < 0.0)
-			phi = -phi;
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			double phi = c.sign * lat[r] * util::TO_RADIANS;
 
-		lambda = (g || h) ? std::atan2(g, h) : 0.0;
-		if (std::abs(g) > 1e-10 || std::abs(h) > 1e-10)
-			lambda = std::atan2(g, h);
+			if (fabs(phi + M_PI_2) < 1e-10) {
+				std::fill(ox, ox + lon_count, std::numeric_limits<double>::infinity());
+				std::fill(oy, oy + lon_count, std::numeric_limits<double>::infinity());
+			}
+			else {
+				double rho = c.a * c.akm1 * util::projection::tsfn(phi, sin(phi), c.e);
 
-		constexpr double TO_DEGREES = 180.0 / M_PI;
+				TRANSFORM_SIMD_LOOP
+				for (size_t i = 0 ; i < lon_count ; i ++) {
+					ox[i] = c.x0 + rho * sin_lambda[i];
+					oy[i] = c.y0 + rho * cos_lambda[i];
+				}
+			}
 
-		ox = util::mod_pi(lambda + lambda0);
+			ox += lon_count;
+			oy += lon_count;
+		}
+	}
 
-		ox = ox * TO_DEGREES;
-		oy = phi * TO_DEGREES;
+	template<>
+	void do_op<projection<latlong, stere<sphere, double>>, double, double>(
+			const projection<latlong, stere<sphere, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::stere_forward(&p.to.consts, x, y, &ox, &oy);
 	}
 
 	template<>
-	void do_op<projection<tmerc<WGS84, double>, latlong>, double, double>(
-			const projection<tmerc<WGS84, double>, latlong>& p,
-			const double& x_in, const double& y_in, double& ox, double&oy) {
-		typedef cartographic::ellipsoids::WGS84			wgs84;
-		typedef cartographic::ellipsoids::WGS84::params	wgs84params;
+	void do_op<projection<stere<sphere, double>, latlong>, double, double>(
+			const projection<stere<sphere, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::stere_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_batch_op<projection<latlong, stere<sphere, double>>, double, double>(
+			const projection<latlong, stere<sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::stere_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::stere_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<stere<sphere, double>, latlong>, double, double>(
+			const projection<stere<sphere, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::stere_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::stere_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_grid_op<projection<latlong, stere<sphere, double>>, double, double>(
+			const projection<latlong, stere<sphere, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		stere_grid(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	template<>
+	void do_op<projection<latlong, stere<WGS84, double>>, double, double>(
+			const projection<latlong, stere<WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::stere_forward(&p.to.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_op<projection<stere<WGS84, double>, latlong>, double, double>(
+			const projection<stere<WGS84, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::stere_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_batch_op<projection<latlong, stere<WGS84, double>>, double, double>(
+			const projection<latlong, stere<WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::stere_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::stere_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<stere<WGS84, double>, latlong>, double, double>(
+			const projection<stere<WGS84, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::stere_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::stere_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_grid_op<projection<latlong, stere<WGS84, double>>, double, double>(
+			const projection<latlong, stere<WGS84, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		stere_grid(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	// sinusoidal, on a grid y and the scale of x only depend on the row
+	//
+	static void sinu_grid(const device::sinu_constants& c,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		std::vector<double> lambda(lon_count);
+		for (size_t i = 0 ; i < lon_count ; i ++)
+			lambda[i] = util::mod_pi(lon[i] * util::TO_RADIANS - c.lambda0);
+
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			double phi = lat[r] * util::TO_RADIANS;
+			double s = sin(phi), co = cos(phi);
+
+			double scale = c.a * co / sqrt(1. - c.es * s * s),
+				   y = c.y0 + c.a * util::projection::mlfn(c.en, phi, s, co);
+
+			TRANSFORM_SIMD_LOOP
+			for (size_t i = 0 ; i < lon_count ; i ++) {
+				ox[i] = c.x0 + scale * lambda[i];
+				oy[i] = y;
+			}
+
+			ox += lon_count;
+			oy += lon_count;
+		}
+	}
+
+	static void sinu_inverse_grid(const device::sinu_constants& c,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *olon, double *olat) {
+		const double inf = std::numeric_limits<double>::infinity();
+
+		std::vector<double> u(x_count);
+		for (size_t i = 0 ; i < x_count ; i ++)
+			u[i] = (x[i] - c.x0) / c.a;
+
+		for (size_t r = 0 ; r < y_count ; r ++) {
+			double phi, scale;
+			int row_fail;
+			device::sinu_parallel(&c, (y[r] - c.y0) / c.a, &phi, &scale, &row_fail);
+
+			double lat = row_fail ? inf : phi * util::TO_DEGREES;
+
+			TRANSFORM_SIMD_LOOP
+			for (size_t i = 0 ; i < x_count ; i ++) {
+				double lambda = u[i] * scale;
+				bool fail = row_fail || fabs(lambda) > M_PI + 1e-10;
+
+				olon[i] = fail ? inf : util::mod_pi(lambda + c.lambda0) * util::TO_DEGREES;
+				olat[i] = fail ? inf : lat;
+			}
+
+			olon += x_count;
+			olat += x_count;
+		}
+	}
+
+	// geostationary view, on a grid the trigonometry of longitudes (scan angles) only depends on the column and
+	// of latitudes on the row
+	//
+	static void geos_grid(const device::geos_constants& c,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		std::vector<double> cos_lambda(lon_count), sin_lambda(lon_count);
+		for (size_t i = 0 ; i < lon_count ; i ++) {
+			double lambda = util::mod_pi(lon[i] * util::TO_RADIANS - c.lambda0);
+
+			cos_lambda[i] = cos(lambda);
+			sin_lambda[i] = sin(lambda);
+		}
+
+		for (size_t r = 0 ; r < lat_count ; r ++) {
+			double phi = lat[r] * util::TO_RADIANS;
+			double cos_phi = cos(phi), sin_phi = sin(phi);
+
+			TRANSFORM_SIMD_LOOP
+			for (size_t i = 0 ; i < lon_count ; i ++) {
+				device::geos_forward_trig(&c, cos_lambda[i], sin_lambda[i], cos_phi, sin_phi, &ox[i], &oy[i]);
+			}
+
+			ox += lon_count;
+			oy += lon_count;
+		}
+	}
+
+	static void geos_inverse_grid(const device::geos_constants& c,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *olon, double *olat) {
+		double h = c.a * c.radius_g_1;
+
+		std::vector<double> tx(x_count);
+		for (size_t i = 0 ; i < x_count ; i ++)
+			tx[i] = tan((x[i] - c.x0) / h);
+
+		for (size_t r = 0 ; r < y_count ; r ++) {
+			double ty = tan((y[r] - c.y0) / h);
+
+			TRANSFORM_SIMD_LOOP
+			for (size_t i = 0 ; i < x_count ; i ++) {
+				device::geos_inverse_tan(&c, tx[i], ty, &olon[i], &olat[i]);
+			}
+
+			olon += x_count;
+			olat += x_count;
+		}
+	}
+
+	template<>
+	void do_op<projection<latlong, sinu<sphere, double>>, double, double>(
+			const projection<latlong, sinu<sphere, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::sinu_forward(&p.to.consts, x, y, &ox, &oy);
+	}
 
-		constexpr double scale = 1.0 / wgs84params::major_axis;
+	template<>
+	void do_op<projection<sinu<sphere, double>, latlong>, double, double>(
+			const projection<sinu<sphere, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::sinu_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		double x = (x_in - p.from.offset.first) * scale;
-		double y = (y_in - p.from.offset.second) * scale;
+	template<>
+	void do_batch_op<projection<latlong, sinu<sphere, double>>, double, double>(
+			const projection<latlong, sinu<sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::sinu_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::sinu_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
+	template<>
+	void do_batch_op<projection<sinu<sphere, double>, latlong>, double, double>(
+			const projection<sinu<sphere, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::sinu_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::sinu_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		double sinPhi, cosPhi, con, t, n, d, ds;
+	template<>
+	void do_grid_op<projection<latlong, sinu<sphere, double>>, double, double>(
+			const projection<latlong, sinu<sphere, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		sinu_grid(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	template<>
+	void do_grid_op<projection<sinu<sphere, double>, latlong>, double, double>(
+			const projection<sinu<sphere, double>, latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy) {
+		sinu_inverse_grid(p.from.consts, x, x_count, y, y_count, ox, oy);
+	}
+
+	template<>
+	void do_op<projection<latlong, sinu<WGS84, double>>, double, double>(
+			const projection<latlong, sinu<WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::sinu_forward(&p.to.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_op<projection<sinu<WGS84, double>, latlong>, double, double>(
+			const projection<sinu<WGS84, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::sinu_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		double lambda, phi;
-		double lambda0 = 0.0;
+	template<>
+	void do_batch_op<projection<latlong, sinu<WGS84, double>>, double, double>(
+			const projection<latlong, sinu<WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::sinu_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::sinu_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		phi = util::projection::inv_mlfn<wgs84>(p.from.ml0 + y);
+	template<>
+	void do_batch_op<projection<sinu<WGS84, double>, latlong>, double, double>(
+			const projection<sinu<WGS84, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::sinu_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::sinu_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		sinPhi = std::sin(phi);
-		cosPhi = std::cos(phi);
+	template<>
+	void do_grid_op<projection<latlong, sinu<WGS84, double>>, double, double>(
+			const projection<latlong, sinu<WGS84, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		sinu_grid(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
 
-		t = 0.0;
-		if (std::abs(cosPhi) > 1e-10)
-			t = sinPhi / cosPhi;
+	template<>
+	void do_grid_op<projection<sinu<WGS84, double>, latlong>, double, double>(
+			const projection<sinu<WGS84, double>, latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy) {
+		sinu_inverse_grid(p.from.consts, x, x_count, y, y_count, ox, oy);
+	}
 
-		n = wgs84params::ecc2 / wgs84params::one_ecc2 * cosPhi * cosPhi;
-		con = 1. - wgs84params::ecc2 * sinPhi * sinPhi;
-		d = x * std::sqrt(con);
-		con *= t;
-		t *= t;
-		ds = d * d;
+	template<>
+	void do_op<projection<latlong, geos<sphere, double>>, double, double>(
+			const projection<latlong, geos<sphere, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::geos_forward(&p.to.consts, x, y, &ox, &oy);
+	}
 
-		phi -= (con * ds / wgs84params::one_ecc2) * FC2 * (1. - 
-				ds * FC4 * (5. + t * (3. - 9. * n) + n * (1. - 4. * n) -
-					ds * FC6 * (61. + t * (90. - 252. * n + 45. * t) + 46. * n
-						- ds * FC8 * (1385. + t * (3633. + t * (4095. + 1574. * t)))
-						)));
-		lambda = d * (FC1 -
-				ds * FC3 * (1. + 2. * t + n -
-					ds * FC5 * (5. + t * (28. + 24. * t + 8. * n) + 6. * n
-						- ds * FC7 * (61. + t * (662. + t * (1320. + 720. * t)))
-						))) / cosPhi;
+	template<>
+	void do_op<projection<geos<sphere, double>, latlong>, double, double>(
+			const projection<geos<sphere, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::geos_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
 
-		constexpr double TO_DEGREES = 180.0 / M_PI;
+	template<>
+	void do_batch_op<projection<latlong, geos<sphere, double>>, double, double>(
+			const projection<latlong, geos<sphere, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::geos_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geos_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
 
-		ox = util::mod_pi(lambda + lambda0) * TO_DEGREES;
-		oy = phi * TO_DEGREES;
+	template<>
+	void do_batch_op<projection<geos<sphere, double>, latlong>, double, double>(
+			const projection<geos<sphere, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::geos_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geos_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_grid_op<projection<latlong, geos<sphere, double>>, double, double>(
+			const projection<latlong, geos<sphere, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		geos_grid(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	template<>
+	void do_grid_op<projection<geos<sphere, double>, latlong>, double, double>(
+			const projection<geos<sphere, double>, latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy) {
+		geos_inverse_grid(p.from.consts, x, x_count, y, y_count, ox, oy);
+	}
+
+	template<>
+	void do_op<projection<latlong, geos<WGS84, double>>, double, double>(
+			const projection<latlong, geos<WGS84, double>>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::geos_forward(&p.to.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_op<projection<geos<WGS84, double>, latlong>, double, double>(
+			const projection<geos<WGS84, double>, latlong>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		device::geos_inverse(&p.from.consts, x, y, &ox, &oy);
+	}
+
+	template<>
+	void do_batch_op<projection<latlong, geos<WGS84, double>>, double, double>(
+			const projection<latlong, geos<WGS84, double>>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::geos_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geos_forward(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op<projection<geos<WGS84, double>, latlong>, double, double>(
+			const projection<geos<WGS84, double>, latlong>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const device::geos_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geos_inverse(&c, x[i], y[i], &ox[i], &oy[i]);
+		}
+	}
+
+	template<>
+	void do_grid_op<projection<latlong, geos<WGS84, double>>, double, double>(
+			const projection<latlong, geos<WGS84, double>>& p,
+			const double *lon, size_t lon_count, const double *lat, size_t lat_count,
+			double *ox, double *oy) {
+		geos_grid(p.to.consts, lon, lon_count, lat, lat_count, ox, oy);
+	}
+
+	template<>
+	void do_grid_op<projection<geos<WGS84, double>, latlong>, double, double>(
+			const projection<geos<WGS84, double>, latlong>& p,
+			const double *x, size_t x_count, const double *y, size_t y_count,
+			double *ox, double *oy) {
+		geos_inverse_grid(p.from.consts, x, x_count, y, y_count, ox, oy);
+	}
+
+	template<>
+	void do_op3<projection<latlong, geocent<sphere, double>>, double, double>(
+			const projection<latlong, geocent<sphere, double>>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		device::geocent_forward(&p.to.consts, x, y, z, &ox, &oy, &oz);
+	}
+
+	template<>
+	void do_op3<projection<geocent<sphere, double>, latlong>, double, double>(
+			const projection<geocent<sphere, double>, latlong>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		device::geocent_inverse(&p.from.consts, x, y, z, &ox, &oy, &oz);
+	}
+
+	template<>
+	void do_batch_op3<projection<latlong, geocent<sphere, double>>, double, double>(
+			const projection<latlong, geocent<sphere, double>>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		const device::geocent_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geocent_forward(&c, x[i], y[i], z[i], &ox[i], &oy[i], &oz[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op3<projection<geocent<sphere, double>, latlong>, double, double>(
+			const projection<geocent<sphere, double>, latlong>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		const device::geocent_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geocent_inverse(&c, x[i], y[i], z[i], &ox[i], &oy[i], &oz[i]);
+		}
+	}
+
+	template<>
+	void do_op3<projection<latlong, geocent<WGS84, double>>, double, double>(
+			const projection<latlong, geocent<WGS84, double>>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		device::geocent_forward(&p.to.consts, x, y, z, &ox, &oy, &oz);
+	}
+
+	template<>
+	void do_op3<projection<geocent<WGS84, double>, latlong>, double, double>(
+			const projection<geocent<WGS84, double>, latlong>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		device::geocent_inverse(&p.from.consts, x, y, z, &ox, &oy, &oz);
+	}
+
+	template<>
+	void do_batch_op3<projection<latlong, geocent<WGS84, double>>, double, double>(
+			const projection<latlong, geocent<WGS84, double>>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		const device::geocent_constants c = p.to.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geocent_forward(&c, x[i], y[i], z[i], &ox[i], &oy[i], &oz[i]);
+		}
+	}
+
+	template<>
+	void do_batch_op3<projection<geocent<WGS84, double>, latlong>, double, double>(
+			const projection<geocent<WGS84, double>, latlong>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		const device::geocent_constants c = p.from.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::geocent_inverse(&c, x[i], y[i], z[i], &ox[i], &oy[i], &oz[i]);
+		}
+	}
+
+	template<>
+	void do_op3<helmert<double>, double, double>(const helmert<double>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		device::helmert_apply(&p.consts, x, y, z, &ox, &oy, &oz);
+	}
+
+	template<>
+	void do_batch_op3<helmert<double>, double, double>(const helmert<double>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		const device::helmert_constants c = p.consts;
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::helmert_apply(&c, x[i], y[i], z[i], &ox[i], &oy[i], &oz[i]);
+		}
+	}
+
+	template<>
+	void do_op<datum_shift<double>, double, double>(const datum_shift<double>& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		double oh;
+		device::datum_shift_apply(&p.consts, x, y, 0., &ox, &oy, &oh);
+	}
+
+	template<>
+	void do_batch_op<datum_shift<double>, double, double>(const datum_shift<double>& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			double oh;
+			device::datum_shift_apply(&p.consts, x[i], y[i], 0., &ox[i], &oy[i], &oh);
+		}
+	}
+
+	template<>
+	void do_op3<datum_shift<double>, double, double>(const datum_shift<double>& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		device::datum_shift_apply(&p.consts, x, y, z, &ox, &oy, &oz);
+	}
+
+	template<>
+	void do_batch_op3<datum_shift<double>, double, double>(const datum_shift<double>& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			device::datum_shift_apply(&p.consts, x[i], y[i], z[i], &ox[i], &oy[i], &oz[i]);
+		}
 	}
 }
@@ -0,0 +1,167 @@
+// grid_shift_cpu.cpp
+// CPU specializations for grid shift transforms
+//
+
+#include "transform/transforms/grid_shift.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace transform {
+	using namespace transforms;
+
+	// batches at least this large are sorted by grid bucket before interpolating
+	static const size_t min_bucketed_batch = 4096;
+
+	// counting sort of point indices by bucket, keys go up to bucket_count inclusive (the
+	// last one collects points off the grid)
+	static void bucket_order(const std::vector<uint32_t>& keys, size_t bucket_count,
+			std::vector<uint32_t>& order) {
+		std::vector<size_t> offsets(bucket_count + 2, 0);
+
+		for (uint32_t k : keys)
+			offsets[k + 1] ++;
+
+		for (size_t b = 1 ; b < offsets.size() ; b ++)
+			offsets[b] += offsets[b - 1];
+
+		order.resize(keys.size());
+		for (size_t i = 0 ; i < keys.size() ; i ++)
+			order[offsets[keys[i]] ++] = static_cast<uint32_t>(i);
+	}
+
+	static inline void ntv2_forward(const grids::ntv2& g, double lon, double lat,
+			double& olon, double& olat) {
+		double dlon, dlat;
+
+		if (!g.shift(lon, lat, dlon, dlat)) {
+			olon = olat = std::numeric_limits<double>::infinity();
+			return;
+		}
+
+		olon = lon + dlon;
+		olat = lat + dlat;
+	}
+
+	// find the point the forward shift moves onto lon, lat
+	static inline void ntv2_inverse(const grids::ntv2& g, double lon, double lat,
+			double& olon, double& olat) {
+		double glon = lon, glat = lat;
+
+		for (int i = 0 ; i < 10 ; i ++) {
+			double dlon, dlat;
+
+			if (!g.shift(glon, glat, dlon, dlat)) {
+				olon = olat = std::numeric_limits<double>::infinity();
+				return;
+			}
+
+			double nlon = lon - dlon, nlat = lat - dlat;
+			bool done = std::abs(nlon - glon) < 1e-12 && std::abs(nlat - glat) < 1e-12;
+
+			glon = nlon;
+			glat = nlat;
+
+			if (done)
+				break;
+		}
+
+		olon = glon;
+		olat = glat;
+	}
+
+	static inline void ntv2_apply(const ntv2_shift& p, double lon, double lat,
+			double& olon, double& olat) {
+		if (p.direction == grid_direction::forward)
+			ntv2_forward(*p.grid, lon, lat, olon, olat);
+		else
+			ntv2_inverse(*p.grid, lon, lat, olon, olat);
+	}
+
+	template<>
+	void do_op<ntv2_shift, double, double>(const ntv2_shift& p,
+			const double& x, const double& y, double& ox, double& oy) {
+		ntv2_apply(p, x, y, ox, oy);
+	}
+
+	template<>
+	void do_batch_op<ntv2_shift, double, double>(const ntv2_shift& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const grids::ntv2& g = *p.grid;
+
+		if (count < min_bucketed_batch || p.direction == grid_direction::inverse) {
+			for (size_t i = 0 ; i < count ; i ++)
+				ntv2_apply(p, x[i], y[i], ox[i], oy[i]);
+			return;
+		}
+
+		// work out every point's sub-grid and bucket, then interpolate bucket by bucket
+		std::vector<uint32_t> keys(count), subgrid(count), order;
+
+		for (size_t i = 0 ; i < count ; i ++) {
+			double lat_s = y[i] * 3600., lon_w = -x[i] * 3600.;
+			size_t s = g.locate(lat_s, lon_w);
+
+			subgrid[i] = static_cast<uint32_t>(s);
+			keys[i] = static_cast<uint32_t>(s == grids::ntv2::npos ?
+					g.bucket_count() : g.bucket(s, lat_s, lon_w));
+		}
+
+		bucket_order(keys, g.bucket_count(), order);
+
+		for (uint32_t i : order) {
+			if (keys[i] == g.bucket_count()) {
+				ox[i] = oy[i] = std::numeric_limits<double>::infinity();
+				continue;
+			}
+
+			double dlon, dlat;
+			g.interpolate(subgrid[i], y[i] * 3600., -x[i] * 3600., dlon, dlat);
+
+			ox[i] = x[i] + dlon;
+			oy[i] = y[i] + dlat;
+		}
+	}
+
+	static inline void gtx_apply(const gtx_shift& p, double lon, double lat, double h,
+			double& olon, double& olat, double& oh) {
+		double v;
+
+		olon = lon;
+		olat = lat;
+
+		if (!p.grid->value(lon, lat, v))
+			oh = std::numeric_limits<double>::infinity();
+		else
+			oh = (p.direction == grid_direction::forward) ? h + v : h - v;
+	}
+
+	template<>
+	void do_op3<gtx_shift, double, double>(const gtx_shift& p,
+			const double& x, const double& y, const double& z, double& ox, double& oy, double& oz) {
+		gtx_apply(p, x, y, z, ox, oy, oz);
+	}
+
+	template<>
+	void do_batch_op3<gtx_shift, double, double>(const gtx_shift& p,
+			const double *x, const double *y, const double *z,
+			double *ox, double *oy, double *oz, size_t count) {
+		const grids::gtx& g = *p.grid;
+
+		if (count < min_bucketed_batch) {
+			for (size_t i = 0 ; i < count ; i ++)
+				gtx_apply(p, x[i], y[i], z[i], ox[i], oy[i], oz[i]);
+			return;
+		}
+
+		std::vector<uint32_t> keys(count), order;
+		for (size_t i = 0 ; i < count ; i ++)
+			keys[i] = static_cast<uint32_t>(g.bucket(x[i], y[i]));
+
+		bucket_order(keys, g.bucket_count(), order);
+
+		for (uint32_t i : order)
+			gtx_apply(p, x[i], y[i], z[i], ox[i], oy[i], oz[i]);
+	}
+}
@@ -0,0 +1,183 @@
+// grids.cpp
+// Grid shift file mapping and parsing
+//
+
+#include "transform/grids.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <stdexcept>
+
+namespace transform {
+	namespace grids {
+		mapped_file::mapped_file(const std::string& path) : data_(NULL), size_(0) {
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error("Could not open grid file: " + path);
+
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				close(fd);
+				throw std::runtime_error("Could not read grid file: " + path);
+			}
+
+			void *p = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+			close(fd);
+
+			if (p == MAP_FAILED)
+				throw std::runtime_error("Could not map grid file: " + path);
+
+			data_ = static_cast<const unsigned char *>(p);
+			size_ = static_cast<size_t>(st.st_size);
+		}
+
+		mapped_file::~mapped_file() {
+			if (data_)
+				munmap(const_cast<unsigned char *>(data_), size_);
+		}
+
+		static bool host_is_little_endian() {
+			uint16_t v = 1;
+			unsigned char b;
+			std::memcpy(&b, &v, 1);
+
+			return b == 1;
+		}
+
+		static uint32_t load_u32(const unsigned char *p, bool swap) {
+			uint32_t v;
+			std::memcpy(&v, p, sizeof(v));
+
+			return swap ? detail::swap32(v) : v;
+		}
+
+		static double load_double(const unsigned char *p, bool swap) {
+			unsigned char b[8];
+			std::memcpy(b, p, 8);
+			if (swap)
+				std::reverse(b, b + 8);
+
+			double d;
+			std::memcpy(&d, b, sizeof(d));
+			return d;
+		}
+
+		// NTv2 records are an 8 character key followed by an 8 byte value
+		static std::string record_text(const unsigned char *record) {
+			std::string s(reinterpret_cast<const char *>(record + 8), 8);
+			return s.substr(0, s.find_last_not_of(' ') + 1);
+		}
+
+		static std::string record_key(const unsigned char *record) {
+			std::string s(reinterpret_cast<const char *>(record), 8);
+			return s.substr(0, s.find_last_not_of(' ') + 1);
+		}
+
+		ntv2::ntv2(const std::string& path) : file_(path), bucket_count_(0) {
+			const unsigned char *base = file_.data(), *end = base + file_.size();
+
+			if (file_.size() < 16 * 11 || record_key(base) != "NUM_OREC")
+				throw std::runtime_error("Not an NTv2 grid file: " + path);
+
+			// the overview header has 11 records, whichever byte order reads that back is
+			// the file's
+			swap_ = load_u32(base + 8, false) != 11;
+			if (load_u32(base + 8, swap_) != 11)
+				throw std::runtime_error("Unsupported NTv2 header: " + path);
+
+			size_t orec = 11,
+				   srec = load_u32(base + 16 + 8, swap_),
+				   count = load_u32(base + 32 + 8, swap_);
+
+			// shifts are read as arc seconds, what published grids use.  The format also
+			// allows MINUTES and DEGREES, those are refused rather than misread.
+			std::string units = record_text(base + 48);
+			if (units != "SECONDS")
+				throw std::runtime_error("Unsupported NTv2 units (" + units + "): " + path);
+
+			std::map<std::string, size_t> by_name;
+			const unsigned char *p = base + orec * 16;
+
+			for (size_t i = 0 ; i < count ; i ++) {
+				if (p + srec * 16 > end)
+					throw std::runtime_error("Truncated NTv2 grid file: " + path);
+
+				ntv2_subgrid s;
+
+				s.name = record_text(p);
+				s.parent = record_text(p + 16);
+				s.s_lat = load_double(p + 4 * 16 + 8, swap_);
+				s.n_lat = load_double(p + 5 * 16 + 8, swap_);
+				s.e_lon = load_double(p + 6 * 16 + 8, swap_);
+				s.w_lon = load_double(p + 7 * 16 + 8, swap_);
+				s.lat_inc = load_double(p + 8 * 16 + 8, swap_);
+				s.lon_inc = load_double(p + 9 * 16 + 8, swap_);
+
+				size_t nodes = load_u32(p + 10 * 16 + 8, swap_);
+
+				// before the casts, a zero, negative or NaN increment or extent would make
+				// them overflow
+				double rows = (s.n_lat - s.s_lat) / s.lat_inc + 0.5,
+					   cols = (s.w_lon - s.e_lon) / s.lon_inc + 0.5;
+				if (!(s.lat_inc > 0.) || !(s.lon_inc > 0.) ||
+						!(rows >= 1.) || !(rows <= nodes) || !(cols >= 1.) || !(cols <= nodes))
+					throw std::runtime_error("Malformed NTv2 sub-grid " + s.name + ": " + path);
+
+				s.rows = static_cast<size_t>(rows) + 1;
+				s.cols = static_cast<size_t>(cols) + 1;
+				s.nodes = p + srec * 16;
+
+				if (s.rows < 2 || s.cols < 2 || s.rows * s.cols != nodes ||
+						s.nodes + nodes * 16 > end)
+					throw std::runtime_error("Malformed NTv2 sub-grid " + s.name + ": " + path);
+
+				s.buckets_x = (s.cols - 1 + bucket_cells - 1) / bucket_cells;
+				s.bucket_base = bucket_count_;
+				bucket_count_ += s.buckets_x * ((s.rows - 1 + bucket_cells - 1) / bucket_cells);
+
+				by_name[s.name] = subgrids_.size();
+				subgrids_.push_back(s);
+
+				p = s.nodes + nodes * 16;
+			}
+
+			for (size_t i = 0 ; i < subgrids_.size() ; i ++) {
+				auto parent = by_name.find(subgrids_[i].parent);
+
+				if (subgrids_[i].parent == "NONE" || parent == by_name.end() || parent->second == i)
+					roots_.push_back(i);
+				else
+					subgrids_[parent->second].children.push_back(i);
+			}
+		}
+
+		gtx::gtx(const std::string& path) : file_(path) {
+			const unsigned char *base = file_.data();
+
+			if (file_.size() < 40)
+				throw std::runtime_error("Not a GTX grid file: " + path);
+
+			swap_ = host_is_little_endian();
+
+			lat_origin = load_double(base, swap_);
+			lon_origin = load_double(base + 8, swap_);
+			lat_inc = load_double(base + 16, swap_);
+			lon_inc = load_double(base + 24, swap_);
+			rows = load_u32(base + 32, swap_);
+			cols = load_u32(base + 36, swap_);
+
+			if (rows < 2 || cols < 2 || !(lat_inc > 0.) || !(lon_inc > 0.) ||
+					40 + rows * cols * 4 > file_.size())
+				throw std::runtime_error("Malformed GTX grid file: " + path);
+
+			data_ = base + 40;
+
+			buckets_x_ = (cols - 1 + bucket_cells - 1) / bucket_cells;
+			bucket_count_ = buckets_x_ * ((rows - 1 + bucket_cells - 1) / bucket_cells);
+		}
+	}
+}
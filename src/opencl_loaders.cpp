@@ -5,12 +5,16 @@
 
 #include "transform/backends/opencl.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 // some helper functions to ease up loading source
 static std::pair<cl_program, cl_kernel> load_program(
 		cl_context ctx, cl_device_id dev,
-		const std::string& source, const std::string& kernel_name) {
+		const std::string& source, const std::string& kernel_name, const std::string& options) {
 	const char *psource = source.c_str();
 	int err;
 
@@ -20,7 +24,7 @@ static std::pair<cl_program, cl_kernel> load_program(
 		throw std::runtime_error("Failed to create program from source");
 
 	// try and build the program
-	err = clBuildProgram(p, 0, NULL, NULL, NULL, NULL);
+	err = clBuildProgram(p, 0, NULL, options.c_str(), NULL, NULL);
 	if (err != CL_SUCCESS) {
 		size_t len = 0;
 		clGetProgramBuildInfo(p, dev, CL_PROGRAM_BUILD_LOG, 0, NULL, &len);
@@ -33,6 +37,7 @@ static std::pair<cl_program, cl_kernel> load_program(
 		std::string error(buffer);
 		delete[] buffer;
 
+		clReleaseProgram(p);
 		throw std::runtime_error(error);
 	}
 
@@ -49,248 +54,245 @@ namespace transform {
 	namespace backends {
 		namespace detail {
 			std::pair<cl_program, cl_kernel>
-			kernel<transforms::scale<double>>::load_transform(cl_context ctx, cl_device_id dev) {
+			kernel<transforms::thin_plate_spline<double>>::load_transform(cl_context ctx, cl_device_id dev,
+					const std::string& options) {
 				const std::string source = R"code(
 					#pragma OPENCL EXTENSION cl_khr_fp64 : enable
 
-					__kernel void scale(
-					__global double* x,
-					__global double* y,
+					__kernel void thin_plate_spline(
+					__global double* x_in,
+					__global double* y_in,
 					__global double* x_out,
 					__global double* y_out,
 					const unsigned int count,
-					const double scaleWith) {
-					   int i = get_global_id(0);
-
-					   x_out[i] = x[i] * scaleWith;
-					   y_out[i] = y[i] * scaleWith;
+					__global const double4* controls,
+					const unsigned int n,
+					const double x0, const double y0, const double scale,
+					const double ax0, const double ax1, const double ax2,
+					const double ay0, const double ay1, const double ay2) {
+						for (unsigned int i = get_global_id(0) ; i < count ; i += get_global_size(0)) {
+							double u = (x_in[i] - x0) * scale, v = (y_in[i] - y0) * scale;
+							double sx = ax0 + ax1 * u + ax2 * v,
+								   sy = ay0 + ay1 * u + ay2 * v;
+
+							for (unsigned int k = 0 ; k < n ; k ++) {
+								double4 c = controls[k];
+								double du = u - c.x, dv = v - c.y;
+								double d2 = du * du + dv * dv;
+								double f = (d2 > 0.0) ? 0.5 * d2 * log(d2) : 0.0;
+
+								sx += c.z * f;
+								sy += c.w * f;
+							}
+
+							x_out[i] = sx;
+							y_out[i] = sy;
+						}
 					}
 				)code";
 
-				return load_program(ctx, dev,
-							source, "scale");
+				return load_program(ctx, dev, source, name(), options);
 			}
 
 			void
-			kernel<transforms::scale<double>>::configure_transform(
-					const transforms::scale<double>& s, 
-					cl_kernel kernel,
+			kernel<transforms::thin_plate_spline<double>>::configure_transform(
+					const transforms::thin_plate_spline<double>& s,
+					cl_kernel kernel, cl_mem controls,
 					cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements) {
+				const transforms::thin_plate_spline<double>::model& m = *s.m;
+
 				int err = 0;
-				cl_uint size = static_cast<cl_uint>(num_elements);
+				cl_uint size = static_cast<cl_uint>(num_elements),
+						n = static_cast<cl_uint>(m.cx.size());
+				cl_double x0 = m.x0, y0 = m.y0, scale = m.scale;
 
-				// set the parameters
 				err |= clSetKernelArg(kernel, 0, sizeof(cl_mem), &x_in);
 				err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &y_in);
 				err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &x_out);
 				err |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &y_out);
 				err |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &size);
-				err |= clSetKernelArg(kernel, 5, sizeof(cl_double), &s.s);
+				err |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &controls);
+				err |= clSetKernelArg(kernel, 6, sizeof(cl_uint), &n);
+				err |= clSetKernelArg(kernel, 7, sizeof(cl_double), &x0);
+				err |= clSetKernelArg(kernel, 8, sizeof(cl_double), &y0);
+				err |= clSetKernelArg(kernel, 9, sizeof(cl_double), &scale);
+
+				for (cl_uint i = 0 ; i < 3 ; i ++) {
+					cl_double ax = m.ax[i], ay = m.ay[i];
+					err |= clSetKernelArg(kernel, 10 + i, sizeof(cl_double), &ax);
+					err |= clSetKernelArg(kernel, 13 + i, sizeof(cl_double), &ay);
+				}
 
 				if (err != CL_SUCCESS)
 					throw std::runtime_error("Failed to configure kernel");
 			}
 
-			typedef transforms::projection<cartographic::projections::latlong,
-					cartographic::projections::tmerc<cartographic::ellipsoids::sphere, double>>
-				proj_latlong_to_tmerc_sphere_d;
-
+			// calls the device function with the constants struct for every point, striding
+			// by the global size so a work-item can take several (see kernel_tuning).  Every
+			// kernel takes z buffers, 2D transforms ignore them and 3D transforms run with
+			// NULL ones (heights of 0, dropped) on 2D runs.
 			std::pair<cl_program, cl_kernel>
-			kernel<proj_latlong_to_tmerc_sphere_d>::load_transform(cl_context ctx, cl_device_id dev) {
-				const std::string source = R"code(
-					#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+			load_device_program(cl_context ctx, cl_device_id dev,
+					const std::string& source, const char *function, const char *constants_name,
+					bool three_d, const std::string& options) {
+				std::string call = three_d ?
+					std::string("double x, y, z;\n") +
+						function + "(&c, x_in[i], y_in[i], z_in ? z_in[i] : 0.0, &x, &y, &z);\n"
+						"if (z_out) z_out[i] = z;\n" :
+					std::string("double x, y;\n") +
+						function + "(&c, x_in[i], y_in[i], &x, &y);\n";
+
+				std::string program =
+					"#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
+					"#define TRANSFORM_DEVICE\n"
+					"#ifdef TRANSFORM_NATIVE_MATH\n"
+					"#define sin(v) ((double)native_sin((float)(v)))\n"
+					"#define cos(v) ((double)native_cos((float)(v)))\n"
+					"#endif\n" + source + "\n"
+					"__kernel void " + function + "_kernel(\n"
+					"__global const double* x_in,\n"
+					"__global const double* y_in,\n"
+					"__global const double* z_in,\n"
+					"__global double* x_out,\n"
+					"__global double* y_out,\n"
+					"__global double* z_out,\n"
+					"const unsigned int count,\n"
+					"const " + constants_name + " c) {\n"
+					"for (unsigned int i = get_global_id(0) ; i < count ; i += get_global_size(0)) {\n" +
+					call +
+					"x_out[i] = x;\n"
+					"y_out[i] = y;\n"
+					"}\n"
+					"}\n";
+
+				// named after the function so profiles tell the transforms apart
+				return load_program(ctx, dev, program, std::string(function) + "_kernel", options);
+			}
 
-					__kernel void tmerc(
-					__global double* x_in,
-					__global double* y_in,
-					__global double* x_out,
-					__global double* y_out,
-					const unsigned int count,
-					const double scale,
-					const double x0,
-					const double y0) {
-					   unsigned int i = get_global_id(0);
+			void configure_device_program(cl_kernel kernel,
+					const void *constants, size_t constants_size,
+					cl_mem x_in, cl_mem y_in, const cl_mem *z_in,
+					cl_mem x_out, cl_mem y_out, const cl_mem *z_out, size_t num_elements) {
+				int err = 0;
+				cl_uint size = static_cast<cl_uint>(num_elements);
 
-					   double lambda = radians(x_in[i]);
-					   double phi    = radians(y_in[i]);
+				// a NULL arg_value makes a NULL buffer argument
+				err |= clSetKernelArg(kernel, 0, sizeof(cl_mem), &x_in);
+				err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &y_in);
+				err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), z_in);
+				err |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &x_out);
+				err |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &y_out);
+				err |= clSetKernelArg(kernel, 5, sizeof(cl_mem), z_out);
+				err |= clSetKernelArg(kernel, 6, sizeof(cl_uint), &size);
+				err |= clSetKernelArg(kernel, 7, constants_size, constants);
 
-					   double x, y, b, cosPhi, sinLambda, cosLambda;
+				if (err != CL_SUCCESS)
+					throw std::runtime_error("Failed to configure kernel");
+			}
 
-					   cosPhi = cos(phi);
-					   sinLambda = sincos(lambda, &cosLambda);
+			void enqueue_kernel(cl_command_queue queue, cl_kernel kernel, size_t count,
+					const kernel_tuning& t, cl_event *evt) {
+				if (evt)
+					*evt = NULL;
 
-					   b = cosPhi * sinLambda;
-					   x = 0.5 * log((1.0 + b) / (1.0 - b));
-					   y = cosPhi * cosLambda / sqrt(1.0 - b * b);
-					   y = select(acos(y), 0.0, (ulong)(fabs(y) >= 1.0));
-					   y = select(y, -y, (ulong)(phi < 0.0));
-					   y = y;
+				if (count == 0)
+					return;
 
-					   x_out[i] = x0 + scale * x;
-					   y_out[i] = y0 + scale * y;
-					}
-				)code";
+				size_t global = (count + t.points_per_item - 1) / t.points_per_item;
+				if (t.local_size > 0)
+					global = ((global + t.local_size - 1) / t.local_size) * t.local_size;
 
-				return load_program(ctx, dev,
-							source, "tmerc");
+				int err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global,
+						t.local_size > 0 ? &t.local_size : NULL, 0, NULL, evt);
+				if (err != CL_SUCCESS)
+					throw std::runtime_error("Failed to execute kernel");
 			}
 
-			void
-			kernel<proj_latlong_to_tmerc_sphere_d>::configure_transform(
-					const proj_latlong_to_tmerc_sphere_d& s,
-					cl_kernel kernel,
-					cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements) {
-				int err = 0;
-				cl_uint size = static_cast<cl_uint>(num_elements);
+			kernel_tuning tune_kernel(cl_command_queue queue, cl_device_id dev, cl_kernel kernel,
+					size_t count) {
+				typedef std::chrono::high_resolution_clock clock;
 
-				cl_double scale = 6370997.0;
-				cl_double x0 = s.to.offset.first;
-				cl_double y0 = s.to.offset.second;
+				size_t max_local = 0;
+				if (clGetKernelWorkGroupInfo(kernel, dev, CL_KERNEL_WORK_GROUP_SIZE,
+							sizeof(max_local), &max_local, NULL) != CL_SUCCESS)
+					max_local = 0;
 
-				err |= clSetKernelArg(kernel, 0, sizeof(cl_mem), &x_in);
-				err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &y_in);
-				err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &x_out);
-				err |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &y_out);
-				err |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &size);
-				err |= clSetKernelArg(kernel, 5, sizeof(cl_double), &scale);
-				err |= clSetKernelArg(kernel, 6, sizeof(cl_double), &x0);
-				err |= clSetKernelArg(kernel, 7, sizeof(cl_double), &y0);
+				static const size_t local_sizes[] = { 0, 32, 64, 128, 256 };
+				static const unsigned per_item[] = { 1, 2, 4, 8 };
 
-				if (err != CL_SUCCESS)
-					throw std::runtime_error("Failed to configure kernel");
-			};
+				kernel_tuning best = { 0, 1 };
+				double best_time = HUGE_VAL;
 
-			typedef transforms::projection<cartographic::projections::latlong,
-					cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>>
-				proj_latlong_to_tmerc_wgs84_d;
+				// first launches pay for lazy setup in some runtimes, keep that out of the timings
+				enqueue_kernel(queue, kernel, count, best);
+				clFinish(queue);
 
-			std::pair<cl_program, cl_kernel>
-			kernel<proj_latlong_to_tmerc_wgs84_d>::load_transform(cl_context ctx, cl_device_id dev) {
-				const std::string source = R"code(
-					#pragma OPENCL EXTENSION cl_khr_fp64 : enable
-					#define FC1 1.0
-					#define FC2 .5
-					#define FC3 .16666666666666666666
-					#define FC4 .08333333333333333333
-					#define FC5 .05
-					#define FC6 .03333333333333333333
-					#define FC7 .02380952380952380952
-					#define FC8 .01785714285714285714
-
-					__kernel void tmerc_e (
-							__global double* x_in,
-							__global double* y_in,
-							__global double* x_out,
-							__global double* y_out,
-							const unsigned int count,
-
-							double ecc,
-							double ecc2,
-							double one_ecc2,
-
-							double scale, double x0, double y0,
-							double phi0,
-							double lambda0,
-							double ml0,
-							double8 en
-							) {
-						int i = get_global_id(0);
-
-						double lambda = radians(x_in[i]) - lambda0;
-						double phi    = radians(y_in[i]);
-
-						double sinPhi, cosPhi, t, al, als, n, x, y, ml;
-
-						sinPhi = sincos(phi, &cosPhi);
-						t = select(sinPhi/cosPhi, 0.0, (long)(fabs(cosPhi) < 1.0e-10));
-						t *= t;
-						al = cosPhi * lambda;
-						als = al * al;
-						al /= sqrt(1.f - ecc2 * sinPhi * sinPhi);
-						n = ecc2 / one_ecc2 * cosPhi * cosPhi;
-
-						double cphi, sphi;
-
-						cphi = cosPhi * sinPhi;
-						sphi = sinPhi * sinPhi;
-						ml = (en.s0 * phi - cphi * (en.s1 + sphi*(en.s2 + sphi*(en.s3 + sphi*en.s4))));
-
-						x = al * (FC1 +
-								FC3 * als * (1.f - t + n +
-									FC5 * als * (5.f + t * (t - 18.f) + n * (14.f - 58.f * t)
-										+ FC7 * als * (61.f + t * ( t * (179.f - t) - 479.f ) )
-										)));
-						y = (ml - ml0 +
-								sinPhi * al * lambda * FC2 * ( 1.f +
-									FC4 * als * (5.f - t + n * (9.f + 4.f * n) +
-										FC6 * als * (61.f + t * (t - 58.f) + n * (270.f - 330.f * t)
-											+ FC8 * als * (1385.f + t * ( t * (543.f - t) - 3111.f) )
-											))));
-
-						x_out[i] = x0 + scale * x;
-						y_out[i] = y0 + scale * y;
-					}
-				)code";
+				for (size_t local : local_sizes) {
+					if (local > max_local)
+						continue;
 
-				return load_program(ctx, dev,
-							source, "tmerc_e");
-			}
+					for (unsigned points : per_item) {
+						kernel_tuning t = { local, points };
 
-			void
-			kernel<proj_latlong_to_tmerc_wgs84_d>::configure_transform(
-					const proj_latlong_to_tmerc_wgs84_d& s,
-					cl_kernel kernel,
-					cl_mem x_in, cl_mem y_in, cl_mem x_out, cl_mem y_out, size_t num_elements) {
-				int err = 0;
-				cl_uint size = static_cast<cl_uint>(num_elements);
+						clock::time_point start = clock::now();
+						enqueue_kernel(queue, kernel, count, t);
+						clFinish(queue);
+						double elapsed = std::chrono::duration<double>(clock::now() - start).count();
 
-				typedef cartographic::ellipsoids::WGS84 wgs84;;
-				typedef wgs84::params					wgs84params;
+						if (elapsed < best_time) {
+							best_time = elapsed;
+							best = t;
+						}
+					}
+				}
 
-				cl_double scale = wgs84params::major_axis;
-				cl_double ecc = wgs84params::ecc;
-				cl_double ecc2 = wgs84params::ecc2;
-				cl_double one_ecc2 = wgs84params::one_ecc2;
+				return best;
+			}
 
-				// TODO: try and understand what these values do and get them here somehow
-				cl_double phi0 = 0.0;
-				cl_double lambda0 = 0.0;
+			std::string build_options(opencl_precision precision) {
+				switch (precision) {
+				case opencl_precision::relaxed:
+					return "-cl-mad-enable -cl-no-signed-zeros";
+				case opencl_precision::fast:
+					return "-cl-fast-relaxed-math";
+				case opencl_precision::native:
+					return "-cl-fast-relaxed-math -DTRANSFORM_NATIVE_MATH";
+				default:
+					return std::string();
+				}
+			}
 
-				cl_double ml0 = util::projection::mlfn<wgs84>(phi0, std::sin(phi0), std::cos(phi0));
-				cl_double en[8] = {
-					wgs84params::en0,
-					wgs84params::en1,
-					wgs84params::en2,
-					wgs84params::en3,
-					wgs84params::en4,
-					0.0, 0.0, 0.0 };
+			void wait_for_events(const cl_event *events, size_t count) {
+				std::vector<cl_event> pending;
+				for (size_t i = 0 ; i < count ; i ++)
+					if (events[i])
+						pending.push_back(events[i]);
 
-				cl_double x0 = s.to.offset.first;
-				cl_double y0 = s.to.offset.second;
+				if (!pending.empty())
+					clWaitForEvents(static_cast<cl_uint>(pending.size()), &pending[0]);
+			}
 
-				err |= clSetKernelArg(kernel, 0, sizeof(cl_mem), &x_in);
-				err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &y_in);
-				err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &x_out);
-				err |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &y_out);
-				err |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &size);
+			std::string device_name(cl_device_id dev) {
+				size_t len = 0;
+				if (clGetDeviceInfo(dev, CL_DEVICE_NAME, 0, NULL, &len) != CL_SUCCESS || len == 0)
+					return std::string();
 
-				err |= clSetKernelArg(kernel, 5, sizeof(cl_double), &ecc);
-				err |= clSetKernelArg(kernel, 6, sizeof(cl_double), &ecc2);
-				err |= clSetKernelArg(kernel, 7, sizeof(cl_double), &one_ecc2);
+				std::vector<char> name(len);
+				clGetDeviceInfo(dev, CL_DEVICE_NAME, len, &name[0], NULL);
 
-				err |= clSetKernelArg(kernel, 8, sizeof(cl_double), &scale);
-				err |= clSetKernelArg(kernel, 9, sizeof(cl_double), &x0);
-				err |= clSetKernelArg(kernel, 10, sizeof(cl_double), &y0);
+				return std::string(name.begin(), std::find(name.begin(), name.end(), '\0'));
+			}
 
-				err |= clSetKernelArg(kernel, 11, sizeof(cl_double), &phi0);
-				err |= clSetKernelArg(kernel, 12, sizeof(cl_double), &lambda0);
+			std::string kernel_name(cl_kernel kernel) {
+				size_t len = 0;
+				if (clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, 0, NULL, &len) != CL_SUCCESS || len == 0)
+					throw std::runtime_error("Failed to query kernel name");
 
-				err |= clSetKernelArg(kernel, 13, sizeof(cl_double), &ml0);
-				err |= clSetKernelArg(kernel, 14, sizeof(cl_double) * 8, en);
+				std::vector<char> name(len);
+				clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, len, &name[0], NULL);
 
-				if (err != CL_SUCCESS)
-					throw std::runtime_error("Failed to configure kernel");
-			};
+				return std::string(name.begin(), std::find(name.begin(), name.end(), '\0'));
+			}
 		}
 	}
 }
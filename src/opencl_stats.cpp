@@ -0,0 +1,94 @@
+// opencl_stats.cpp
+// Chrome trace output for OpenCL run timings
+//
+
+#include "transform/backends/opencl_stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+namespace transform {
+	namespace backends {
+		static void write_json_string(std::ostream& os, const std::string& s) {
+			os << '"';
+			for (char c : s) {
+				if (c == '"' || c == '\\')
+					os << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20)
+					os << ' ';
+				else
+					os << c;
+			}
+			os << '"';
+		}
+
+		void write_chrome_trace(std::ostream& os, const std::vector<opencl_run_stats>& runs) {
+			// a process id and time origin per device, in order of appearance
+			std::map<std::string, unsigned> pids;
+			std::vector<cl_ulong> origins;
+
+			for (const opencl_run_stats& r : runs) {
+				auto p = pids.insert(std::make_pair(r.device, static_cast<unsigned>(pids.size())));
+				if (p.second)
+					origins.push_back(~cl_ulong(0));
+
+				cl_ulong& origin = origins[p.first->second];
+				for (const opencl_event_stats& e : r.events)
+					origin = std::min(origin, e.queued);
+			}
+
+			// microseconds to the nanosecond, default formatting goes to exponents on long
+			// traces which some viewers don't read
+			std::ios_base::fmtflags flags = os.flags();
+			std::streamsize precision = os.precision();
+			os << std::fixed << std::setprecision(3);
+
+			os << "{\"traceEvents\":[";
+
+			bool first = true;
+			auto next = [&os, &first]() {
+				os << (first ? "\n" : ",\n");
+				first = false;
+			};
+
+			for (const auto& p : pids) {
+				next();
+				os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << p.second
+				   << ",\"args\":{\"name\":";
+				write_json_string(os, p.first);
+				os << "}}";
+			}
+
+			for (size_t run = 0 ; run < runs.size() ; run ++) {
+				const opencl_run_stats& r = runs[run];
+
+				unsigned pid = pids[r.device];
+				cl_ulong origin = origins[pid];
+
+				// trace times are in microseconds
+				auto us = [origin](cl_ulong ns) { return (ns - origin) * 1e-3; };
+
+				for (const opencl_event_stats& e : r.events) {
+					next();
+					os << "{\"name\":";
+					write_json_string(os, e.name);
+					os << ",\"cat\":";
+					write_json_string(os, e.category);
+					os << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << r.queue
+					   << ",\"ts\":" << us(e.started)
+					   << ",\"dur\":" << (e.ended - e.started) * 1e-3
+					   << ",\"args\":{\"run\":" << run
+					   << ",\"points\":" << r.points
+					   << ",\"queued\":" << us(e.queued)
+					   << ",\"submitted\":" << us(e.submitted) << "}}";
+				}
+			}
+
+			os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+			os.flags(flags);
+			os.precision(precision);
+		}
+	}
+}
@@ -0,0 +1,219 @@
+// thin_plate_spline_cpu.cpp
+// CPU batch evaluation of thin-plate splines
+//
+
+#include "transform/transforms/thin_plate_spline.hpp"
+#include "transform/cpu_op.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace transform {
+	using namespace transforms;
+
+	typedef thin_plate_spline<double> tps;
+
+	// points summed together against each control point, small enough for the partial sums
+	// to stay in registers and L1
+	static const size_t direct_block = 64;
+
+	// tiles with this many points or fewer are always evaluated directly
+	static const size_t min_tile_points = 64;
+
+	// subdivision stops here, whatever is left is evaluated directly
+	static const int max_tile_depth = 16;
+
+	// direct sum over every control point for normalized inputs
+	static void tps_direct(const tps::model& s, const double *u, const double *v,
+			double *ox, double *oy, size_t count) {
+		const size_t n = s.cx.size();
+		const double *cx = &s.cx[0], *cy = &s.cy[0], *wx = &s.wx[0], *wy = &s.wy[0];
+
+		for (size_t b = 0 ; b < count ; b += direct_block) {
+			size_t e = std::min(count, b + direct_block), len = e - b;
+			double sx[direct_block], sy[direct_block];
+
+			TRANSFORM_SIMD_LOOP
+			for (size_t j = 0 ; j < len ; j ++) {
+				sx[j] = s.ax[0] + s.ax[1] * u[b + j] + s.ax[2] * v[b + j];
+				sy[j] = s.ay[0] + s.ay[1] * u[b + j] + s.ay[2] * v[b + j];
+			}
+
+			for (size_t i = 0 ; i < n ; i ++) {
+				const double ci = cx[i], di = cy[i], wxi = wx[i], wyi = wy[i];
+
+				TRANSFORM_SIMD_LOOP
+				for (size_t j = 0 ; j < len ; j ++) {
+					double du = u[b + j] - ci, dv = v[b + j] - di;
+					double d2 = du * du + dv * dv;
+					double k = (d2 > 0.) ? 0.5 * d2 * std::log(d2) : 0.;
+
+					sx[j] += wxi * k;
+					sy[j] += wyi * k;
+				}
+			}
+
+			std::copy(sx, sx + len, ox + b);
+			std::copy(sy, sy + len, oy + b);
+		}
+	}
+
+	namespace {
+		// adaptive tiled evaluation of the points listed in index, all normalized
+		struct tps_tiler {
+			const tps::model& s;
+			double max_error;
+
+			const double *u, *v;
+			double *ox, *oy;
+
+			std::vector<double> gu, gv, gx, gy;
+
+			tps_tiler(const tps::model& s_, double max_error_,
+					const double *u_, const double *v_, double *ox_, double *oy_) :
+				s(s_), max_error(max_error_), u(u_), v(v_), ox(ox_), oy(oy_) { }
+
+			void direct(const size_t *index, size_t count) {
+				gu.resize(count); gv.resize(count);
+				gx.resize(count); gy.resize(count);
+
+				for (size_t i = 0 ; i < count ; i ++) {
+					gu[i] = u[index[i]];
+					gv[i] = v[index[i]];
+				}
+
+				tps_direct(s, &gu[0], &gv[0], &gx[0], &gy[0], count);
+
+				for (size_t i = 0 ; i < count ; i ++) {
+					ox[index[i]] = gx[i];
+					oy[index[i]] = gy[i];
+				}
+			}
+
+			void refine(size_t *index, size_t count,
+					double u0, double v0, double u1, double v1, int depth) {
+				if (count <= min_tile_points || depth >= max_tile_depth) {
+					direct(index, count);
+					return;
+				}
+
+				// exact values on a 3x3 lattice plus four check points at the quarters
+				double lu[13], lv[13], lx[13], ly[13];
+				const double us[3] = { u0, 0.5 * (u0 + u1), u1 }, vs[3] = { v0, 0.5 * (v0 + v1), v1 };
+				for (int r = 0 ; r < 3 ; r ++) {
+					for (int c = 0 ; c < 3 ; c ++) {
+						lu[r * 3 + c] = us[c];
+						lv[r * 3 + c] = vs[r];
+					}
+				}
+
+				static const double checks[4][2] = { { .25, .25 }, { .75, .25 }, { .25, .75 }, { .75, .75 } };
+				for (int i = 0 ; i < 4 ; i ++) {
+					lu[9 + i] = u0 + (u1 - u0) * checks[i][0];
+					lv[9 + i] = v0 + (v1 - v0) * checks[i][1];
+				}
+
+				tps_direct(s, lu, lv, lx, ly, 13);
+
+				double err = 0.;
+				for (int i = 0 ; i < 4 ; i ++) {
+					double wu[3], wv[3];
+					weights(checks[i][0], wu);
+					weights(checks[i][1], wv);
+
+					err = std::max(err,
+							std::abs(biquadratic(lx, wu, wv) - lx[9 + i]) +
+							std::abs(biquadratic(ly, wu, wv) - ly[9 + i]));
+				}
+
+				// negated so NaNs get subdivided
+				if (!(err > max_error)) {
+					double su = (u1 > u0) ? 1. / (u1 - u0) : 0., sv = (v1 > v0) ? 1. / (v1 - v0) : 0.;
+
+					for (size_t i = 0 ; i < count ; i ++) {
+						size_t p = index[i];
+
+						double wu[3], wv[3];
+						weights((u[p] - u0) * su, wu);
+						weights((v[p] - v0) * sv, wv);
+
+						ox[p] = biquadratic(lx, wu, wv);
+						oy[p] = biquadratic(ly, wu, wv);
+					}
+
+					return;
+				}
+
+				// split into quadrants, points on the midlines go to the upper ones
+				double um = us[1], vm = vs[1];
+
+				size_t *lower = std::partition(index, index + count, [&](size_t p) { return v[p] < vm; });
+				size_t *ll = std::partition(index, lower, [&](size_t p) { return u[p] < um; });
+				size_t *ul = std::partition(lower, index + count, [&](size_t p) { return u[p] < um; });
+
+				refine(index, ll - index, u0, v0, um, vm, depth + 1);
+				refine(ll, lower - ll, um, v0, u1, vm, depth + 1);
+				refine(lower, ul - lower, u0, vm, um, v1, depth + 1);
+				refine(ul, index + count - ul, um, vm, u1, v1, depth + 1);
+			}
+
+			// Lagrange weights for nodes at 0, 0.5 and 1
+			static void weights(double t, double *w) {
+				w[0] = 2. * (t - .5) * (t - 1.);
+				w[1] = -4. * t * (t - 1.);
+				w[2] = 2. * t * (t - .5);
+			}
+
+			static double biquadratic(const double *l, const double *wu, const double *wv) {
+				double sum = 0.;
+				for (int r = 0 ; r < 3 ; r ++)
+					sum += wv[r] * (wu[0] * l[r * 3] + wu[1] * l[r * 3 + 1] + wu[2] * l[r * 3 + 2]);
+
+				return sum;
+			}
+		};
+	}
+
+	template<>
+	void do_batch_op<tps, double, double>(const tps& p,
+			const double *x, const double *y, double *ox, double *oy, size_t count) {
+		const tps::model& s = *p.m;
+
+		std::vector<double> u(count), v(count);
+
+		TRANSFORM_SIMD_LOOP
+		for (size_t i = 0 ; i < count ; i ++) {
+			u[i] = (x[i] - s.x0) * s.scale;
+			v[i] = (y[i] - s.y0) * s.scale;
+		}
+
+		if (p.max_error <= 0. || count <= min_tile_points) {
+			tps_direct(s, &u[0], &v[0], ox, oy, count);
+			return;
+		}
+
+		// points which can't be placed in a tile get evaluated directly
+		std::vector<size_t> index, loose;
+		index.reserve(count);
+
+		double u0 = HUGE_VAL, v0 = HUGE_VAL, u1 = -HUGE_VAL, v1 = -HUGE_VAL;
+		for (size_t i = 0 ; i < count ; i ++) {
+			if (!std::isfinite(u[i]) || !std::isfinite(v[i])) {
+				loose.push_back(i);
+				continue;
+			}
+
+			index.push_back(i);
+			u0 = std::min(u0, u[i]); u1 = std::max(u1, u[i]);
+			v0 = std::min(v0, v[i]); v1 = std::max(v1, v[i]);
+		}
+
+		tps_tiler t(s, p.max_error, &u[0], &v[0], ox, oy);
+
+		if (!index.empty())
+			t.refine(&index[0], index.size(), u0, v0, u1, v1, 0);
+
+		if (!loose.empty())
+			t.direct(&loose[0], loose.size());
+	}
+}
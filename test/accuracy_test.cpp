@@ -0,0 +1,129 @@
+// accuracy_test.cpp
+// measuring backends against the CPU backend
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+#include <limits>
+
+// the CPU results with the first point's x moved by an error
+struct offset_backend {
+	double error;
+
+	template<
+		typename TTransform,
+		typename ForwardIterableInputRange,
+		typename ForwardIterableOutputRange
+	>
+	void run(const TTransform& p,
+		const ForwardIterableInputRange& x,
+		const ForwardIterableInputRange& y,
+		ForwardIterableOutputRange& out_x,
+		ForwardIterableOutputRange& out_y) const {
+		transform::backends::cpu().run(p, x, y, out_x, out_y);
+		out_x[0] += error;
+	}
+};
+
+// the CPU results with points out of the domain clamped to the largest double, like a
+// device which doesn't keep infinities
+struct unmasked_backend {
+	template<
+		typename TTransform,
+		typename ForwardIterableInputRange,
+		typename ForwardIterableOutputRange
+	>
+	void run(const TTransform& p,
+		const ForwardIterableInputRange& x,
+		const ForwardIterableInputRange& y,
+		ForwardIterableOutputRange& out_x,
+		ForwardIterableOutputRange& out_y) const {
+		transform::backends::cpu().run(p, x, y, out_x, out_y);
+
+		for (size_t i = 0 ; i < out_x.size() ; i ++) {
+			if (!std::isfinite(out_x[i]))
+				out_x[i] = std::numeric_limits<double>::max();
+			if (!std::isfinite(out_y[i]))
+				out_y[i] = std::numeric_limits<double>::max();
+		}
+	}
+};
+
+BOOST_AUTO_TEST_SUITE(accuracy_test)
+
+BOOST_AUTO_TEST_CASE(same_math_has_no_error)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::tmerc<ellipsoids::WGS84, double>> forward;
+	forward p = forward(projections::latlong(), projections::utm<ellipsoids::WGS84, double>(33));
+
+	std::vector<double> x(1000), y(1000);
+	for (size_t i = 0 ; i < x.size() ; i ++) {
+		x.at(i) = 12.0 + 6.0 * i / x.size();
+		y.at(i) = -80.0 + 160.0 * i / x.size();
+	}
+
+	accuracy_report r = measure_accuracy(backends::multi_cpu<4>(), p, x, y);
+
+	BOOST_CHECK_EQUAL(r.points, 1000u);
+	BOOST_CHECK_EQUAL(r.max_error, 0.);
+	BOOST_CHECK_EQUAL(r.rms_error, 0.);
+	BOOST_CHECK_EQUAL(r.max_ulps, 0.);
+	BOOST_CHECK_EQUAL(r.mask_mismatches, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(errors_in_output_units_and_ulps)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+
+	std::vector<double> x = { 1.0, 2.0, 3.0, 4.0 }, y = { 1.0, 1.0, 1.0, 1.0 };
+
+	offset_backend b = { 0.25 };
+	accuracy_report r = measure_accuracy(b, scale<double>(2.0), x, y);
+
+	BOOST_CHECK_EQUAL(r.points, 4u);
+	BOOST_CHECK_EQUAL(r.max_error, 0.25);
+	BOOST_CHECK_CLOSE(r.rms_error, 0.25 / std::sqrt(8.0), 1e-9);
+
+	// the ulp of 2.0 is 2^-51
+	BOOST_CHECK_EQUAL(r.max_ulps, 0.25 * std::ldexp(1.0, 51));
+
+	offset_backend broken = { std::numeric_limits<double>::quiet_NaN() };
+	r = measure_accuracy(broken, scale<double>(2.0), x, y);
+
+	BOOST_CHECK(std::isinf(r.max_error));
+	BOOST_CHECK(std::isinf(r.max_ulps));
+}
+
+BOOST_AUTO_TEST_CASE(points_the_cpu_cannot_transform_are_skipped)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::webmerc> forward;
+	forward p = forward(projections::latlong(), projections::webmerc());
+
+	// the poles are out of web mercator's range
+	std::vector<double> x = { 0.0, 10.0, 20.0 }, y = { 90.0, 45.0, -90.0 };
+
+	accuracy_report r = measure_accuracy(backends::cpu(), p, x, y);
+
+	BOOST_CHECK_EQUAL(r.points, 1u);
+	BOOST_CHECK_EQUAL(r.max_error, 0.);
+	BOOST_CHECK_EQUAL(r.mask_mismatches, 0u);
+
+	// but finite results for them are counted
+	r = measure_accuracy(unmasked_backend(), p, x, y);
+
+	BOOST_CHECK_EQUAL(r.points, 1u);
+	BOOST_CHECK_EQUAL(r.max_error, 0.);
+	BOOST_CHECK_EQUAL(r.mask_mismatches, 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+// approximate_test.cpp
+// approximate transformer tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+static void gen_latlong_raster(std::vector<double>& x, std::vector<double>& y,
+		size_t width, size_t height,
+		double x0, double y0, double dx, double dy) {
+	x.resize(width * height);
+	y.resize(width * height);
+
+	for (size_t r = 0 ; r < height ; r ++) {
+		for (size_t c = 0 ; c < width ; c ++) {
+			x.at(r * width + c) = x0 + (c + 0.5) * dx;
+			y.at(r * width + c) = y0 + (r + 0.5) * dy;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(approximate_test)
+
+BOOST_AUTO_TEST_CASE(wgs84_tmerc_within_error)
+{
+	std::vector<double> x, y;
+
+	const size_t WIDTH = 512, HEIGHT = 64;
+
+	gen_latlong_raster(x, y, WIDTH, HEIGHT, -3.0, 40.0, 0.001, -0.001);
+
+	std::vector<double> out_x(x.size()), out_y(x.size()),
+		std_x(x.size()), std_y(x.size());
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	projection_to;
+
+	projection<projection_from, projection_to> p(
+			projection_from(),
+			projection_to(projection_to::offset_t(0.0, 0.0)));
+
+	const double max_error = 1.0;
+
+	transformer<cpu> t;
+	t.run(p, x, y, std_x, std_y);
+
+	approximate_transformer<full_concurrency_multi_cpu> at(max_error);
+	at.run(p, x, y, out_x, out_y, WIDTH);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_LE(std::abs(std_x.at(i) - out_x.at(i)) +
+				std::abs(std_y.at(i) - out_y.at(i)), max_error);
+	}
+
+	BOOST_CHECK_LT(at.exact_points(), x.size() / 4);
+}
+
+BOOST_AUTO_TEST_CASE(does_not_interpolate_across_failures)
+{
+	std::vector<double> x, y;
+
+	const size_t WIDTH = 256, HEIGHT = 4;
+
+	// sphere tmerc fails beyond 90 degrees of longitude from the central meridian
+	gen_latlong_raster(x, y, WIDTH, HEIGHT, 80.0, 10.0, 0.1, -0.1);
+
+	std::vector<double> out_x(x.size()), out_y(x.size()),
+		std_x(x.size()), std_y(x.size());
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::tmerc<ellipsoids::sphere, double>	projection_to;
+
+	projection<projection_from, projection_to> p(
+			projection_from(),
+			projection_to(projection_to::offset_t(0.0, 0.0)));
+
+	transformer<cpu> t;
+	t.run(p, x, y, std_x, std_y);
+
+	approximate_transformer<cpu> at(0.125);
+	at.run(p, x, y, out_x, out_y, WIDTH);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		if (std::isfinite(std_x.at(i))) {
+			BOOST_CHECK_LE(std::abs(std_x.at(i) - out_x.at(i)) +
+					std::abs(std_y.at(i) - out_y.at(i)), 0.125);
+		}
+		else {
+			BOOST_CHECK(!std::isfinite(out_x.at(i)));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
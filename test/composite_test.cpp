@@ -0,0 +1,145 @@
+// composite_test.cpp
+// affine, homography and composite transform tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+static void gen_pixel_points(std::vector<double>& x, std::vector<double>& y, size_t count) {
+	x.resize(count);
+	y.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = 2000.0 * (0.5 + 0.5 * sin(2 * M_PI * i / count));
+		y.at(i) = 1500.0 * (0.5 + 0.5 * cos(6 * M_PI * i / count));
+	}
+}
+
+static transform::transforms::homography<double> tilted_plane() {
+	const double h[8] = { 1.2, 0.1, 30.0, -0.05, 0.9, 12.0, 1e-4, -2e-4 };
+	return transform::transforms::homography<double>(h);
+}
+
+BOOST_AUTO_TEST_SUITE(composite_test)
+
+BOOST_AUTO_TEST_CASE(affine_known_values_and_inverse)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	// a north up geotransform with a little rotation
+	affine<double> gt(440720.0, 60.0, 0.5, 3751320.0, 0.25, -60.0);
+
+	std::vector<double> x = { 0.0, 10.0, 2.5 }, y = { 0.0, 20.0, 7.5 };
+	std::vector<double> wx(3), wy(3), px(3), py(3);
+
+	transformer<cpu> t;
+	t.run(gt, x, y, wx, wy);
+
+	BOOST_CHECK_CLOSE(wx.at(0), 440720.0, 1e-12);
+	BOOST_CHECK_CLOSE(wy.at(0), 3751320.0, 1e-12);
+	BOOST_CHECK_CLOSE(wx.at(1), 440720.0 + 600.0 + 10.0, 1e-12);
+	BOOST_CHECK_CLOSE(wy.at(1), 3751320.0 + 2.5 - 1200.0, 1e-12);
+
+	t.run(gt.inverse(), wx, wy, px, py);
+
+	for (size_t i = 0 ; i < x.size() ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - px.at(i), 1e-8);
+		BOOST_CHECK_SMALL(y.at(i) - py.at(i), 1e-8);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(homography_round_trip)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10000;
+	gen_pixel_points(x, y, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	homography<double> h = tilted_plane();
+
+	std::vector<double> hx(SIZE), hy(SIZE), back_x(SIZE), back_y(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(h, x, y, hx, hy);
+	t.run(h.inverse(), hx, hy, back_x, back_y);
+
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		double w = 1e-4 * x.at(i) - 2e-4 * y.at(i) + 1.0;
+		BOOST_CHECK_CLOSE(hx.at(i), (1.2 * x.at(i) + 0.1 * y.at(i) + 30.0) / w, 1e-10);
+		BOOST_CHECK_CLOSE(hy.at(i), (-0.05 * x.at(i) + 0.9 * y.at(i) + 12.0) / w, 1e-10);
+
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-8);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-8);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10001;
+	gen_pixel_points(x, y, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	affine<double> a(440720.0, 60.0, 0.5, 3751320.0, 0.25, -60.0);
+	homography<double> h = tilted_plane();
+
+	check_batch_matches_op(a, x, y, 1e-12);
+	check_batch_matches_op(h, x, y, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(pixel_to_latlong_in_one_pass)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10001;
+	gen_pixel_points(x, y, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	tmerc;
+
+	affine<double> gt(440720.0, 60.0, 0.0, 3751320.0, 0.0, -60.0);
+
+	// the projection is a temporary, the composite keeps its own copy
+	auto pixel_to_latlong = compose(homography<double>(tilted_plane()),
+			compose(gt, projection<tmerc, latlong>(
+					projections::utm<ellipsoids::WGS84, double>(11, false), latlong())));
+
+	projection<tmerc, latlong> inv = projection<tmerc, latlong>(
+			projections::utm<ellipsoids::WGS84, double>(11, false), latlong());
+
+	std::vector<double> hx(SIZE), hy(SIZE), wx(SIZE), wy(SIZE), std_x(SIZE), std_y(SIZE),
+		out_x(SIZE), out_y(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(tilted_plane(), x, y, hx, hy);
+	t.run(gt, hx, hy, wx, wy);
+	t.run(inv, wx, wy, std_x, std_y);
+
+	t.run(pixel_to_latlong, x, y, out_x, out_y);
+
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_EQUAL(std_x.at(i), out_x.at(i));
+		BOOST_CHECK_EQUAL(std_y.at(i), out_y.at(i));
+	}
+
+	// and against the composite visited point by point
+	check_batch_matches_op(pixel_to_latlong, x, y);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+// datum_test.cpp
+// helmert and datum shift tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+// ED50 to WGS84, EPSG:1133 (coordinate frame rotations)
+static transform::transforms::helmert<double> ed50_to_wgs84() {
+	return transform::transforms::helmert<double>(-81.07, -89.36, -115.75,
+			0.485, 0.024, 0.413, -0.54,
+			transform::transforms::rotation_convention::coordinate_frame);
+}
+
+BOOST_AUTO_TEST_SUITE(datum_test)
+
+BOOST_AUTO_TEST_CASE(helmert_known_values)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	// the WGS72 to WGS84 example from the EPSG guidance note 7-2 (published to the
+	// centimeter), in both conventions
+	helmert<double> pv(0.0, 0.0, 4.5, 0.0, 0.0, 0.554, 0.219),
+		cf(0.0, 0.0, 4.5, 0.0, 0.0, -0.554, 0.219, rotation_convention::coordinate_frame);
+
+	std::vector<double> x = { 3657660.66 }, y = { 255768.55 }, z = { 5201382.11 };
+	std::vector<double> out_x(1), out_y(1), out_z(1);
+
+	transformer<cpu> t;
+
+	t.run(pv, x, y, z, out_x, out_y, out_z);
+	BOOST_CHECK_SMALL(out_x.at(0) - 3657660.78, 1e-2);
+	BOOST_CHECK_SMALL(out_y.at(0) - 255778.43, 1e-2);
+	BOOST_CHECK_SMALL(out_z.at(0) - 5201387.75, 1e-2);
+
+	t.run(cf, x, y, z, out_x, out_y, out_z);
+	BOOST_CHECK_SMALL(out_x.at(0) - 3657660.78, 1e-2);
+	BOOST_CHECK_SMALL(out_y.at(0) - 255778.43, 1e-2);
+	BOOST_CHECK_SMALL(out_z.at(0) - 5201387.75, 1e-2);
+}
+
+BOOST_AUTO_TEST_CASE(datum_shift_matches_separate_steps)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 10000;
+	gen_circle_height_points(x, y, z, 179.0, 89.0, 0.0, 3000.0, 3, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::geocent<ellipsoids::WGS84, double>	geocent;
+
+	// WGS84 on both sides so every step exists as a separate transform
+	ellipsoids::runtime wgs84 = ellipsoids::runtime::of<ellipsoids::WGS84>();
+	datum_shift<double> ds(wgs84, ed50_to_wgs84(), wgs84);
+
+	std::vector<double> gx(SIZE), gy(SIZE), gz(SIZE), hx(SIZE), hy(SIZE), hz(SIZE),
+		std_x(SIZE), std_y(SIZE), std_z(SIZE), out_x(SIZE), out_y(SIZE), out_z(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(projection<latlong, geocent>(latlong(), geocent()), x, y, z, gx, gy, gz);
+	t.run(ed50_to_wgs84(), gx, gy, gz, hx, hy, hz);
+	t.run(projection<geocent, latlong>(geocent(), latlong()), hx, hy, hz, std_x, std_y, std_z);
+
+	t.run(ds, x, y, z, out_x, out_y, out_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_z.at(i) - out_z.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(datum_shift_round_trip)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 10000;
+	gen_circle_height_points(x, y, z, 179.0, 89.0, 0.0, 3000.0, 3, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	ellipsoids::runtime intl(6378388.0, 297.0),
+		wgs84 = ellipsoids::runtime::of<ellipsoids::WGS84>();
+
+	helmert<double> h = ed50_to_wgs84();
+	helmert<double> back(-h.tx, -h.ty, -h.tz, -h.rx, -h.ry, -h.rz, -h.s, h.convention);
+
+	datum_shift<double> forward(intl, h, wgs84), reverse(wgs84, back, intl);
+
+	std::vector<double> sx(SIZE), sy(SIZE), sz(SIZE),
+		back_x(SIZE), back_y(SIZE), back_z(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(forward, x, y, z, sx, sy, sz);
+	t.run(reverse, sx, sy, sz, back_x, back_y, back_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		// a shift of roughly 100 meters
+		BOOST_CHECK_GT(std::abs(x.at(i) - sx.at(i)) + std::abs(y.at(i) - sy.at(i)), 1e-5);
+
+		// negating the parameters is only exact to first order, good to a few millimeters
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+		BOOST_CHECK_SMALL(z.at(i) - back_z.at(i), 1e-2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(datum_shift_batch_matches_per_point)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 10001;
+	gen_circle_height_points(x, y, z, 179.0, 89.0, 0.0, 3000.0, 3, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	datum_shift<double> ds(ellipsoids::runtime(6378388.0, 297.0), ed50_to_wgs84(),
+			ellipsoids::runtime::of<ellipsoids::WGS84>());
+
+	check_batch_matches_op(ds, x, y, z);
+
+	// and 2D runs are 3D runs at height 0
+	std::vector<double> zero(SIZE, 0.0), out_x(SIZE), out_y(SIZE), out_z(SIZE),
+		flat_x(SIZE), flat_y(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+
+	t.run(ds, x, y, zero, out_x, out_y, out_z);
+	t.run(ds, x, y, flat_x, flat_y);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_EQUAL(flat_x.at(i), out_x.at(i));
+		BOOST_CHECK_EQUAL(flat_y.at(i), out_y.at(i));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
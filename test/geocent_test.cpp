@@ -0,0 +1,161 @@
+// geocent_test.cpp
+// geodetic <-> geocentric and 3D transform tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(geocent_test)
+
+BOOST_AUTO_TEST_CASE(known_values)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::geocent<ellipsoids::WGS84, double>	geocent;
+
+	// on the equator, at the north pole and the EPSG guidance note example
+	std::vector<double> x = { 0.0, 90.0, 0.0, 2.1295500000000000 },
+		y = { 0.0, 0.0, 90.0, 53.809394444444443 },
+		z = { 0.0, 100.0, 0.0, 73.0 };
+	std::vector<double> out_x(x.size()), out_y(x.size()), out_z(x.size());
+
+	transformer<cpu> t;
+	t.run(projection<latlong, geocent>(latlong(), geocent()), x, y, z, out_x, out_y, out_z);
+
+	BOOST_CHECK_CLOSE(out_x.at(0), 6378137.0, 1e-12);
+	BOOST_CHECK_SMALL(out_y.at(0), 1e-9);
+	BOOST_CHECK_SMALL(out_z.at(0), 1e-9);
+
+	BOOST_CHECK_SMALL(out_x.at(1), 1e-6);
+	BOOST_CHECK_CLOSE(out_y.at(1), 6378237.0, 1e-12);
+
+	BOOST_CHECK_SMALL(out_x.at(2), 1e-6);
+	BOOST_CHECK_CLOSE(out_z.at(2), 6356752.314245179, 1e-9);
+
+	BOOST_CHECK_SMALL(out_x.at(3) - 3771793.968, 1e-3);
+	BOOST_CHECK_SMALL(out_y.at(3) - 140253.342, 1e-3);
+	BOOST_CHECK_SMALL(out_z.at(3) - 5124304.349, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 10000;
+	gen_circle_height_points(x, y, z, 179.0, 89.9, 4600.0, 5000.0, 5, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::geocent<ellipsoids::WGS84, double>	geocent;
+
+	std::vector<double> gx(SIZE), gy(SIZE), gz(SIZE),
+		back_x(SIZE), back_y(SIZE), back_z(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(projection<latlong, geocent>(latlong(), geocent()), x, y, z, gx, gy, gz);
+	t.run(projection<geocent, latlong>(geocent(), latlong()), gx, gy, gz, back_x, back_y, back_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-9);
+		BOOST_CHECK_SMALL(z.at(i) - back_z.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(sphere_round_trip)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 1000;
+	gen_circle_height_points(x, y, z, 179.0, 89.9, 4600.0, 5000.0, 5, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::geocent<ellipsoids::sphere, double>	geocent;
+
+	std::vector<double> gx(SIZE), gy(SIZE), gz(SIZE),
+		back_x(SIZE), back_y(SIZE), back_z(SIZE);
+
+	transformer<cpu> t;
+	t.run(projection<latlong, geocent>(latlong(), geocent()), x, y, z, gx, gy, gz);
+	t.run(projection<geocent, latlong>(geocent(), latlong()), gx, gy, gz, back_x, back_y, back_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		// on a sphere every point is simply radius + height away from the centre
+		double r = std::sqrt(gx.at(i) * gx.at(i) + gy.at(i) * gy.at(i) + gz.at(i) * gz.at(i));
+		BOOST_CHECK_SMALL(r - (ellipsoids::sphere::params::major_axis + z.at(i)), 1e-6);
+
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-9);
+		BOOST_CHECK_SMALL(z.at(i) - back_z.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 10001;
+	gen_circle_height_points(x, y, z, 179.0, 89.9, 4600.0, 5000.0, 5, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::geocent<ellipsoids::WGS84, double>	geocent;
+
+	projection<latlong, geocent> p = projection<latlong, geocent>(latlong(), geocent());
+
+	check_batch_matches_op(p, x, y, z);
+}
+
+BOOST_AUTO_TEST_CASE(planar_transforms_pass_heights_through)
+{
+	std::vector<double> x, y, z;
+
+	const size_t SIZE = 1000;
+	gen_circle_height_points(x, y, z, 179.0, 89.9, 4600.0, 5000.0, 5, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	latlong;
+	typedef projections::webmerc	webmerc;
+
+	for (size_t i = 0 ; i < SIZE ; i ++)
+		y.at(i) *= 0.9;
+
+	projection<latlong, webmerc> p = projection<latlong, webmerc>(latlong(), webmerc());
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), out_z(SIZE),
+		std_x(SIZE), std_y(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, z, out_x, out_y, out_z);
+	t.run(p, x, y, std_x, std_y);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_EQUAL(std_x.at(i), out_x.at(i));
+		BOOST_CHECK_EQUAL(std_y.at(i), out_y.at(i));
+		BOOST_CHECK_EQUAL(z.at(i), out_z.at(i));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
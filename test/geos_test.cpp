@@ -0,0 +1,220 @@
+// geos_test.cpp
+// geostationary satellite view tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+// GOES-16 (GOES East) and Himawari 8 as described in their product files
+static const double goes_h = 35786023.0;
+static const double himawari_h = 35785831.0;
+
+// points on the disk the satellite over lon0 sees
+static void gen_visible_points(std::vector<double>& x, std::vector<double>& y,
+		double lon0, size_t count) {
+	x.resize(count);
+	y.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = lon0 + 70.0 * sin(2 * M_PI * i / count);
+		y.at(i) = 70.0 * cos(6 * M_PI * i / count) * (0.5 + 0.5 * cos(2 * M_PI * i / count));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(geos_test)
+
+BOOST_AUTO_TEST_CASE(known_values)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::geos<ellipsoids::WGS84, double>	geos_type;
+
+	// from the PROJ test suite (GRS80, which is within a millimeter of WGS84 here)
+	geos_type g(geos_type::offset_t(0.0, 0.0), himawari_h, 0.0);
+
+	double x, y, lon, lat;
+	projection<latlong, geos_type>(latlong(), g).op(2.0, 1.0, x, y);
+
+	BOOST_CHECK_SMALL(x - 222527.070365800, 1e-3);
+	BOOST_CHECK_SMALL(y - 110551.303413329, 1e-3);
+
+	projection<geos_type, latlong>(g, latlong()).op(x, y, lon, lat);
+
+	BOOST_CHECK_SMALL(lon - 2.0, 1e-9);
+	BOOST_CHECK_SMALL(lat - 1.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(off_disk_is_masked)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::geos<ellipsoids::WGS84, double>	geos_type;
+
+	geos_type g(geos_type::offset_t(0.0, 0.0), goes_h, -75.0, projections::sweep_axis::x);
+
+	// the far side of the earth and the poles can't be seen, scan angles of 0.16 rad
+	// look past the limb
+	std::vector<double> lon = { 105.0, -75.0, -75.0, -75.0 },
+		lat = { 0.0, 90.0, -90.0, 40.0 };
+	std::vector<double> x(lon.size()), y(lon.size());
+
+	transformer<cpu> t;
+	t.run(projection<latlong, geos_type>(latlong(), g), lon, lat, x, y);
+
+	for (size_t i = 0 ; i < 3 ; i ++) {
+		BOOST_CHECK(std::isinf(x.at(i)));
+		BOOST_CHECK(std::isinf(y.at(i)));
+	}
+
+	BOOST_CHECK(std::isfinite(x.at(3)));
+	BOOST_CHECK(std::isfinite(y.at(3)));
+
+	std::vector<double> sx = { 0.16 * goes_h, 0.0, 0.12 * goes_h, 0.0 },
+		sy = { 0.0, -0.16 * goes_h, 0.12 * goes_h, 0.0 };
+	std::vector<double> olon(sx.size()), olat(sx.size());
+
+	t.run(projection<geos_type, latlong>(g, latlong()), sx, sy, olon, olat);
+
+	for (size_t i = 0 ; i < 3 ; i ++) {
+		BOOST_CHECK(std::isinf(olon.at(i)));
+		BOOST_CHECK(std::isinf(olat.at(i)));
+	}
+
+	BOOST_CHECK_SMALL(olon.at(3) + 75.0, 1e-9);
+	BOOST_CHECK_SMALL(olat.at(3), 1e-9);
+}
+
+template<typename TEllipsoid>
+static void check_geos_round_trip(transform::cartographic::projections::sweep_axis sweep) {
+	typedef transform::cartographic::projections::geos<TEllipsoid, double> geos_type;
+
+	std::vector<double> x, y;
+	gen_visible_points(x, y, 140.7, 10000);
+
+	check_round_trip(geos_type(typename geos_type::offset_t(0.0, 0.0), himawari_h, 140.7, sweep), x, y);
+}
+
+BOOST_AUTO_TEST_CASE(sphere_round_trip)
+{
+	using namespace transform::cartographic;
+	check_geos_round_trip<ellipsoids::sphere>(projections::sweep_axis::y);
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_round_trip)
+{
+	using namespace transform::cartographic;
+	check_geos_round_trip<ellipsoids::WGS84>(projections::sweep_axis::y);
+	check_geos_round_trip<ellipsoids::WGS84>(projections::sweep_axis::x);
+}
+
+BOOST_AUTO_TEST_CASE(full_disk_grid_matches_points)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::geos<ellipsoids::WGS84, double>	geos_type;
+
+	geos_type g(geos_type::offset_t(0.0, 0.0), goes_h, -75.0, projections::sweep_axis::x);
+
+	// a coarse full disk scan, the corners are off the earth
+	const size_t COLS = 300, ROWS = 300;
+	const double extent = 0.151872 * goes_h;
+
+	std::vector<double> gx(COLS), gy(ROWS);
+	for (size_t c = 0 ; c < COLS ; c ++) gx.at(c) = -extent + (c + 0.5) * 2 * extent / COLS;
+	for (size_t r = 0 ; r < ROWS ; r ++) gy.at(r) = extent - (r + 0.5) * 2 * extent / ROWS;
+
+	std::vector<double> x, y;
+	for (size_t r = 0 ; r < ROWS ; r ++) {
+		for (size_t c = 0 ; c < COLS ; c ++) {
+			x.push_back(gx.at(c));
+			y.push_back(gy.at(r));
+		}
+	}
+
+	projection<geos_type, latlong> inv(g, latlong());
+
+	std::vector<double> out_x(x.size()), out_y(x.size()),
+		std_x(x.size()), std_y(x.size());
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(inv, x, y, std_x, std_y);
+	t.run_grid(inv, gx, gy, out_x, out_y);
+
+	size_t off_disk = 0;
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		if (std::isinf(std_x.at(i))) {
+			off_disk ++;
+			BOOST_CHECK(std::isinf(out_x.at(i)));
+			continue;
+		}
+
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-9);
+	}
+
+	// about 1 - pi / 4 of the square misses the earth
+	BOOST_CHECK(off_disk > x.size() / 6);
+	BOOST_CHECK(off_disk < x.size() / 4);
+
+	// and forward over a latlong box which crosses the limb
+	std::vector<double> lon(COLS), lat(ROWS);
+	for (size_t c = 0 ; c < COLS ; c ++) lon.at(c) = -175.0 + c * 0.6;
+	for (size_t r = 0 ; r < ROWS ; r ++) lat.at(r) = 89.0 - r * 0.6;
+
+	x.clear(); y.clear();
+	for (size_t r = 0 ; r < ROWS ; r ++) {
+		for (size_t c = 0 ; c < COLS ; c ++) {
+			x.push_back(lon.at(c));
+			y.push_back(lat.at(r));
+		}
+	}
+
+	projection<latlong, geos_type> fwd(latlong(), g);
+
+	t.run(fwd, x, y, std_x, std_y);
+	t.run_grid(fwd, lon, lat, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		if (std::isinf(std_x.at(i))) {
+			BOOST_CHECK(std::isinf(out_x.at(i)));
+			continue;
+		}
+
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10001;
+	gen_visible_points(x, y, 0.0, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::geos<ellipsoids::WGS84, double>	geos_type;
+
+	projection<latlong, geos_type> p(latlong(), geos_type(geos_type::offset_t(0.0, 0.0), himawari_h, 0.0));
+
+	check_batch_matches_op(p, x, y);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,269 @@
+// grid_shift_test.cpp
+// NTv2 and GTX grid shift tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+#include <cstdio>
+#include <deque>
+#include <memory>
+
+static void gen_points(std::vector<double>& x, std::vector<double>& y, size_t count,
+		double lon0, double lon1, double lat0, double lat1) {
+	x.resize(count);
+	y.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = lon0 + (lon1 - lon0) * (0.5 + 0.5 * sin(2 * M_PI * i / count));
+		y.at(i) = lat0 + (lat1 - lat0) * (0.5 + 0.5 * cos(14 * M_PI * i / count));
+	}
+}
+
+static void expected_shift(double lon, double lat, double& olon, double& olat) {
+	double lat_s = lat * 3600., lon_w = -lon * 3600.;
+	bool child = lon >= 0.0 && lon <= 2.0 && lat >= 44.0 && lat <= 46.0;
+	double offset = child ? child_offset() : 0.0;
+
+	olat = lat + (root_lat_shift(lat_s, lon_w) + offset) / 3600.;
+	olon = lon - (root_lon_shift(lat_s, lon_w) + offset) / 3600.;
+}
+
+BOOST_AUTO_TEST_SUITE(grid_shift_test)
+
+BOOST_AUTO_TEST_CASE(ntv2_interpolates_nested_subgrids)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::string le = write_ntv2("grid_shift_test_le.gsb", false),
+		be = write_ntv2("grid_shift_test_be.gsb", true);
+
+	{
+		std::shared_ptr<const grids::ntv2> little(new grids::ntv2(le)), big(new grids::ntv2(be));
+
+		BOOST_CHECK_EQUAL(little->subgrids().size(), 2u);
+		BOOST_CHECK_EQUAL(little->subgrids().at(0).children.size(), 1u);
+
+		std::vector<double> x, y;
+		gen_points(x, y, 1000, -9.9, 9.9, 40.1, 49.9);
+
+		std::vector<double> lx(x.size()), ly(x.size()), bx(x.size()), by(x.size());
+
+		transformer<cpu> t;
+		t.run(ntv2_shift(little), x, y, lx, ly);
+		t.run(ntv2_shift(big), x, y, bx, by);
+
+		for (size_t i = 0 ; i < x.size() ; i ++) {
+			double ex, ey;
+			expected_shift(x.at(i), y.at(i), ex, ey);
+
+			BOOST_CHECK_SMALL(lx.at(i) - ex, 1e-9);
+			BOOST_CHECK_SMALL(ly.at(i) - ey, 1e-9);
+			BOOST_CHECK_EQUAL(lx.at(i), bx.at(i));
+			BOOST_CHECK_EQUAL(ly.at(i), by.at(i));
+		}
+
+		// off the grid
+		std::vector<double> ox = { 20.0, 0.0 }, oy = { 45.0, 60.0 }, rx(2), ry(2);
+		t.run(ntv2_shift(little), ox, oy, rx, ry);
+
+		BOOST_CHECK(std::isinf(rx.at(0)) && std::isinf(ry.at(0)));
+		BOOST_CHECK(std::isinf(rx.at(1)) && std::isinf(ry.at(1)));
+	}
+
+	std::remove(le.c_str());
+	std::remove(be.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(ntv2_inverse_round_trip)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::string path = write_ntv2("grid_shift_test_inv.gsb", false);
+
+	{
+		std::shared_ptr<const grids::ntv2> g(new grids::ntv2(path));
+
+		std::vector<double> x, y;
+		gen_points(x, y, 10000, -9.5, 9.5, 40.5, 49.5);
+
+		std::vector<double> sx(x.size()), sy(x.size()), back_x(x.size()), back_y(x.size());
+
+		transformer<full_concurrency_multi_cpu> t;
+		t.run(ntv2_shift(g), x, y, sx, sy);
+		t.run(ntv2_shift(g, grid_direction::inverse), sx, sy, back_x, back_y);
+
+		for (size_t i = 0 ; i < x.size() ; i ++) {
+			BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-10);
+			BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-10);
+		}
+	}
+
+	std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(ntv2_bucketed_batch_matches_per_point)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::string path = write_ntv2("grid_shift_test_batch.gsb", false);
+
+	{
+		std::shared_ptr<const grids::ntv2> g(new grids::ntv2(path));
+
+		// some points fall off the grid on purpose
+		std::vector<double> x, y;
+		gen_points(x, y, 50001, -11.0, 11.0, 39.0, 51.0);
+
+		ntv2_shift p(g);
+
+		// vectors go straight to the bucketed batch kernel and deques through staging
+		// buffers, both are checked against the transform visited point by point
+		std::vector<double> out_x(x.size()), out_y(x.size()), std_x(x.size()), std_y(x.size());
+		std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()),
+			deque_x(x.size()), deque_y(x.size());
+
+		for (size_t i = 0 ; i < x.size() ; i ++)
+			p.op(x.at(i), y.at(i), std_x.at(i), std_y.at(i));
+
+		transformer<multi_cpu<2>> t;
+		t.run(p, x, y, out_x, out_y);
+		t.run(p, dx, dy, deque_x, deque_y);
+
+		for (size_t i = 0 ; i < x.size() ; i ++) {
+			BOOST_CHECK_EQUAL(std_x.at(i), out_x.at(i));
+			BOOST_CHECK_EQUAL(std_y.at(i), out_y.at(i));
+			BOOST_CHECK_EQUAL(std_x.at(i), deque_x.at(i));
+			BOOST_CHECK_EQUAL(std_y.at(i), deque_y.at(i));
+		}
+	}
+
+	std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(gtx_shifts_heights)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::string path = write_gtx("grid_shift_test.gtx");
+
+	{
+		std::shared_ptr<const grids::gtx> g(new grids::gtx(path));
+
+		std::vector<double> x, y;
+		gen_points(x, y, 20001, -19.9, 19.9, 32.1, 59.9);
+
+		std::vector<double> z(x.size(), 100.0);
+		std::vector<double> ox(x.size()), oy(x.size()), oz(x.size()),
+			back_x(x.size()), back_y(x.size()), back_z(x.size());
+
+		transformer<full_concurrency_multi_cpu> t;
+		t.run(gtx_shift(g), x, y, z, ox, oy, oz);
+		t.run(gtx_shift(g, grid_direction::inverse), ox, oy, oz, back_x, back_y, back_z);
+
+		for (size_t i = 0 ; i < x.size() ; i ++) {
+			BOOST_CHECK_EQUAL(x.at(i), ox.at(i));
+			BOOST_CHECK_EQUAL(y.at(i), oy.at(i));
+			BOOST_CHECK_SMALL(oz.at(i) - (100.0 + geoid(x.at(i), y.at(i))), 1e-4);
+			BOOST_CHECK_SMALL(back_z.at(i) - 100.0, 1e-9);
+		}
+
+		// the bucketed batch kernel, straight from vectors and staged from deques, matches
+		// the transform visited point by point
+		gtx_shift s(g);
+		std::vector<double> std_x(x.size()), std_y(x.size()), std_z(x.size());
+		std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()), dz(z.begin(), z.end()),
+			deque_x(x.size()), deque_y(x.size()), deque_z(x.size());
+
+		for (size_t i = 0 ; i < x.size() ; i ++)
+			s.op(x.at(i), y.at(i), z.at(i), std_x.at(i), std_y.at(i), std_z.at(i));
+
+		t.run(s, dx, dy, dz, deque_x, deque_y, deque_z);
+
+		for (size_t i = 0 ; i < x.size() ; i ++) {
+			BOOST_CHECK_EQUAL(std_z.at(i), oz.at(i));
+			BOOST_CHECK_EQUAL(std_z.at(i), deque_z.at(i));
+		}
+
+		// no data, off the grid to the east and wrapped around from 340E
+		std::vector<double> px = { 0.0, 25.0, 345.0 }, py = { 31.0, 45.0, 45.0 },
+			pz(3, 0.0), rx(3), ry(3), rz(3);
+		t.run(gtx_shift(g), px, py, pz, rx, ry, rz);
+
+		BOOST_CHECK(std::isinf(rz.at(0)));
+		BOOST_CHECK(std::isinf(rz.at(1)));
+		BOOST_CHECK_SMALL(rz.at(2) - geoid(-15.0, 45.0), 1e-4);
+	}
+
+	std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(malformed_grids_throw)
+{
+	using namespace transform;
+
+	BOOST_CHECK_THROW(grids::ntv2("grid_shift_test_missing.gsb"), std::runtime_error);
+
+	grid_writer w(false);
+	w.key("NUM_OREC"); w.i32(11);
+	w.save("grid_shift_test_short.gsb");
+
+	BOOST_CHECK_THROW(grids::ntv2("grid_shift_test_short.gsb"), std::runtime_error);
+	BOOST_CHECK_THROW(grids::gtx("grid_shift_test_short.gsb"), std::runtime_error);
+
+	std::remove("grid_shift_test_short.gsb");
+
+	// a sub-grid with a zero latitude increment, and one in minutes
+	const char *units[] = { "SECONDS", "MINUTES" };
+	const double lat_inc[] = { 0.0, 1800.0 };
+
+	for (int i = 0 ; i < 2 ; i ++) {
+		grid_writer g(false);
+
+		g.key("NUM_OREC"); g.i32(11);
+		g.key("NUM_SREC"); g.i32(11);
+		g.key("NUM_FILE"); g.i32(1);
+		g.text("GS_TYPE", units[i]);
+		g.text("VERSION", "NTv2.0");
+		g.text("SYSTEM_F", "TEST_F");
+		g.text("SYSTEM_T", "TEST_T");
+		g.key("MAJOR_F"); g.f64(6378388.0);
+		g.key("MINOR_F"); g.f64(6356911.946);
+		g.key("MAJOR_T"); g.f64(6378137.0);
+		g.key("MINOR_T"); g.f64(6356752.314);
+
+		g.text("SUB_NAME", "ROOT");
+		g.text("PARENT", "NONE");
+		g.text("CREATED", "");
+		g.text("UPDATED", "");
+		g.key("S_LAT"); g.f64(0.0);
+		g.key("N_LAT"); g.f64(1800.0);
+		g.key("E_LONG"); g.f64(0.0);
+		g.key("W_LONG"); g.f64(1800.0);
+		g.key("LAT_INC"); g.f64(lat_inc[i]);
+		g.key("LONG_INC"); g.f64(1800.0);
+		g.key("GS_COUNT"); g.i32(4);
+
+		for (int n = 0 ; n < 16 ; n ++)
+			g.f32(0.0f);
+
+		g.key("END");
+		g.raw(0, 8);
+		g.save("grid_shift_test_bad.gsb");
+
+		BOOST_CHECK_THROW(grids::ntv2("grid_shift_test_bad.gsb"), std::runtime_error);
+	}
+
+	std::remove("grid_shift_test_bad.gsb");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
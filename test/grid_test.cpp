@@ -0,0 +1,110 @@
+// grid_test.cpp
+// grid mode transform tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+static void gen_axes(std::vector<double>& lon, std::vector<double>& lat,
+		size_t cols, size_t rows) {
+	lon.resize(cols);
+	lat.resize(rows);
+
+	for (size_t c = 0 ; c < cols ; c ++)
+		lon.at(c) = -80.0 + 160.0 * c / (cols - 1);
+	for (size_t r = 0 ; r < rows ; r ++)
+		lat.at(r) = 85.0 - 170.0 * r / (rows - 1);
+}
+
+// run the same transform point by point over the expanded grid
+template<typename TTransform>
+static void expand_and_run(const TTransform& p,
+		const std::vector<double>& lon, const std::vector<double>& lat,
+		std::vector<double>& out_x, std::vector<double>& out_y) {
+	std::vector<double> x, y;
+
+	for (size_t r = 0 ; r < lat.size() ; r ++) {
+		for (size_t c = 0 ; c < lon.size() ; c ++) {
+			x.push_back(lon.at(c));
+			y.push_back(lat.at(r));
+		}
+	}
+
+	out_x.resize(x.size());
+	out_y.resize(y.size());
+
+	transform::transformer<transform::backends::cpu> t;
+	t.run(p, x, y, out_x, out_y);
+}
+
+template<typename TEllipsoid, typename TBackend>
+static void check_grid_matches_points() {
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong					projection_from;
+	typedef projections::tmerc<TEllipsoid, double>	projection_to;
+
+	projection<projection_from, projection_to> p(
+			projection_from(),
+			projection_to(typename projection_to::offset_t(100.0, -200.0)));
+
+	std::vector<double> lon, lat;
+	gen_axes(lon, lat, 123, 77);
+
+	std::vector<double> std_x, std_y;
+	expand_and_run(p, lon, lat, std_x, std_y);
+
+	std::vector<double> out_x(std_x.size()), out_y(std_y.size());
+
+	transformer<TBackend> t;
+	t.run_grid(p, lon, lat, out_x, out_y);
+
+	for(size_t i = 0, il = std_x.size() ; i < il ; i ++) {
+		if (std::isfinite(std_x.at(i))) {
+			BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+			BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+		}
+		else {
+			BOOST_CHECK(!std::isfinite(out_x.at(i)));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(grid_test)
+
+BOOST_AUTO_TEST_CASE(sphere_tmerc_grid)
+{
+	check_grid_matches_points<transform::cartographic::ellipsoids::sphere,
+		transform::backends::full_concurrency_multi_cpu>();
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_tmerc_grid)
+{
+	check_grid_matches_points<transform::cartographic::ellipsoids::WGS84,
+		transform::backends::full_concurrency_multi_cpu>();
+}
+
+BOOST_AUTO_TEST_CASE(generic_transform_grid)
+{
+	using namespace transform;
+
+	std::vector<double> lon, lat;
+	gen_axes(lon, lat, 10, 20);
+
+	std::vector<double> std_x, std_y;
+	expand_and_run(transforms::scale<double>(2.0), lon, lat, std_x, std_y);
+
+	std::vector<double> out_x(std_x.size()), out_y(std_y.size());
+
+	transformer<backends::cpu> t;
+	t.run_grid(transforms::scale<double>(2.0), lon, lat, out_x, out_y);
+
+	for(size_t i = 0, il = std_x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// lcc_test.cpp
+// lambert conformal conic tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(lcc_test)
+
+BOOST_AUTO_TEST_CASE(wgs84_2sp_round_trip)
+{
+	using namespace transform::cartographic;
+	typedef projections::lcc<ellipsoids::WGS84, double> lcc_type;
+
+	std::vector<double> x, y;
+	gen_circle_points(x, y, -96.0, 35.0, 20.0, 20.0, 10000);
+
+	check_round_trip(lcc_type(lcc_type::offset_t(0.0, 0.0), 33.0, 45.0, 23.0, -96.0), x, y);
+}
+
+BOOST_AUTO_TEST_CASE(sphere_1sp_round_trip)
+{
+	using namespace transform::cartographic;
+	typedef projections::lcc<ellipsoids::sphere, double> lcc_type;
+
+	std::vector<double> x, y;
+	gen_circle_points(x, y, -77.0, 25.0, 20.0, 20.0, 10000);
+
+	check_round_trip(projections::lcc_1sp<ellipsoids::sphere, double>(
+				lcc_type::offset_t(250000.0, 150000.0), 18.0, -77.0, 1.0), x, y);
+}
+
+BOOST_AUTO_TEST_CASE(southern_cone_round_trip)
+{
+	using namespace transform::cartographic;
+	typedef projections::lcc<ellipsoids::WGS84, double> lcc_type;
+
+	std::vector<double> x, y;
+	gen_circle_points(x, y, 135.0, -30.0, 20.0, 20.0, 10000);
+
+	// both standard parallels in the south make the cone open the other way
+	check_round_trip(lcc_type(lcc_type::offset_t(1000000.0, 10000000.0), -18.0, -36.0, -32.0, 135.0),
+			x, y);
+}
+
+BOOST_AUTO_TEST_CASE(standard_parallels_are_true_scale)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong						latlong;
+	typedef projections::lcc<ellipsoids::WGS84, double>	lcc_type;
+
+	lcc_type l(lcc_type::offset_t(0.0, 0.0), 33.0, 45.0, 23.0, -96.0);
+	projection<latlong, lcc_type> p(latlong(), l);
+
+	const double a = 6378137.0, es = 0.0066943799917598135;
+
+	// a short step along each standard parallel covers the same distance on the map as
+	// on the ellipsoid
+	const double lats[] = { 33.0, 45.0 };
+	for (double lat : lats) {
+		double x0, y0, x1, y1;
+		p.op(-96.0, lat, x0, y0);
+		p.op(-95.999, lat, x1, y1);
+
+		double s = std::sin(lat * util::TO_RADIANS), c = std::cos(lat * util::TO_RADIANS);
+		double ground = a * c / std::sqrt(1.0 - es * s * s) * 0.001 * util::TO_RADIANS;
+
+		BOOST_CHECK_CLOSE(std::hypot(x1 - x0, y1 - y0), ground, 1e-4);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong						latlong;
+	typedef projections::lcc<ellipsoids::WGS84, double>	lcc_type;
+
+	const size_t SIZE = 10001;
+
+	std::vector<double> x, y;
+	gen_circle_points(x, y, -96.0, 35.0, 20.0, 20.0, SIZE);
+
+	lcc_type l(lcc_type::offset_t(0.0, 0.0), 33.0, 45.0, 23.0, -96.0);
+	projection<latlong, lcc_type> p(latlong(), l);
+
+	check_batch_matches_op(p, x, y);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
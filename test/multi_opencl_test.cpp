@@ -0,0 +1,76 @@
+// multi_opencl_test.cpp
+// splitting batches among OpenCL devices
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+#include <numeric>
+
+using transform::backends::detail::shard_sizes;
+
+static size_t total(const std::vector<size_t>& sizes) {
+	return std::accumulate(sizes.begin(), sizes.end(), size_t(0));
+}
+
+BOOST_AUTO_TEST_SUITE(multi_opencl_test)
+
+BOOST_AUTO_TEST_CASE(unmeasured_devices_split_evenly)
+{
+	std::vector<size_t> s = shard_sizes(std::vector<double>(3, 0.), 300000, 1000);
+
+	BOOST_CHECK_EQUAL(total(s), 300000u);
+	BOOST_CHECK_EQUAL(s[0], 100000u);
+	BOOST_CHECK_EQUAL(s[1], 100000u);
+	BOOST_CHECK_EQUAL(s[2], 100000u);
+}
+
+BOOST_AUTO_TEST_CASE(split_follows_throughput)
+{
+	std::vector<double> t = { 1e6, 3e6 };
+	std::vector<size_t> s = shard_sizes(t, 400001, 1000);
+
+	BOOST_CHECK_EQUAL(total(s), 400001u);
+	BOOST_CHECK_EQUAL(s[0], 100000u);
+
+	// the fastest device takes the rounding remainder
+	BOOST_CHECK_EQUAL(s[1], 300001u);
+}
+
+BOOST_AUTO_TEST_CASE(unmeasured_devices_count_as_average)
+{
+	std::vector<double> t = { 1e6, 0., 3e6 };
+	std::vector<size_t> s = shard_sizes(t, 600000, 1000);
+
+	BOOST_CHECK_EQUAL(total(s), 600000u);
+	BOOST_CHECK_EQUAL(s[0], 100000u);
+	BOOST_CHECK_EQUAL(s[1], 200000u);
+	BOOST_CHECK_EQUAL(s[2], 300000u);
+}
+
+BOOST_AUTO_TEST_CASE(small_batches_go_to_the_fastest_devices)
+{
+	std::vector<double> t = { 1e6, 4e6, 2e6 };
+
+	std::vector<size_t> s = shard_sizes(t, 500, 1000);
+	BOOST_CHECK_EQUAL(s[0], 0u);
+	BOOST_CHECK_EQUAL(s[1], 500u);
+	BOOST_CHECK_EQUAL(s[2], 0u);
+
+	s = shard_sizes(t, 2500, 1000);
+	BOOST_CHECK_EQUAL(total(s), 2500u);
+	BOOST_CHECK_EQUAL(s[0], 0u);
+	BOOST_CHECK_EQUAL(s[2], 833u);
+	BOOST_CHECK_EQUAL(s[1], 1667u);
+}
+
+BOOST_AUTO_TEST_CASE(empty_batches_and_no_devices)
+{
+	std::vector<size_t> s = shard_sizes(std::vector<double>(2, 1e6), 0, 1000);
+	BOOST_CHECK_EQUAL(total(s), 0u);
+	BOOST_CHECK_EQUAL(s.size(), 2u);
+
+	BOOST_CHECK(shard_sizes(std::vector<double>(), 1000, 1000).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,11 @@
 
 #include "transform.hpp"
 
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <thread>
+
 static void gen_latlong_points(std::vector<double>& x, std::vector<double>& y, 
 		size_t count) {
 	x.resize(count);
@@ -121,4 +126,999 @@ BOOST_AUTO_TEST_CASE(gpu_device_computes_spherical_tmerc)
 	}
 }
 
+template<typename TEllipsoid>
+static void check_inverse_tmerc() {
+	const size_t SIZE = 10000;
+
+	// a UTM zone and some way beyond it
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 8.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 84.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong					latlong;
+	typedef projections::tmerc<TEllipsoid, double>	tmerc_type;
+
+	tmerc_type z = projections::utm<TEllipsoid, double>(33);
+
+	std::vector<double> px(SIZE), py(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(projection<latlong, tmerc_type>(latlong(), z), x, y, px, py);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	projection<tmerc_type, latlong> inv(z, latlong());
+	tc.run(inv, px, py, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(inv, px, py, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_spherical_inverse_tmerc)
+{
+	check_inverse_tmerc<transform::cartographic::ellipsoids::sphere>();
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_wgs84_inverse_tmerc)
+{
+	check_inverse_tmerc<transform::cartographic::ellipsoids::WGS84>();
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_runtime_inverse_tmerc)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 8.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 84.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::tmerc<ellipsoids::runtime, double>	tmerc_type;
+
+	// International 1924
+	tmerc_type z = projections::utm<double>(ellipsoids::runtime(6378388.0, 297.0), 33);
+
+	std::vector<double> px(SIZE), py(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(projection<latlong, tmerc_type>(latlong(), z), x, y, px, py);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	projection<tmerc_type, latlong> inv(z, latlong());
+	tc.run(inv, px, py, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(inv, px, py, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_webmerc)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10000;
+
+	gen_latlong_points(x, y, SIZE);
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	projection_from;
+	typedef projections::webmerc	projection_to;
+
+	projection<projection_from, projection_to> p =
+		projection<projection_from, projection_to>(projection_from(), projection_to());
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE);
+	t.run(projection<projection_to, projection_from>(projection_to(), projection_from()),
+			out_x, out_y, back_x, back_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_wgs84_lcc)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10000;
+
+	gen_latlong_points(x, y, SIZE);
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::lcc<ellipsoids::WGS84, double>		projection_to;
+
+	projection_to l(projection_to::offset_t(0.0, 0.0), 33.0, 45.0, 23.0, 0.0);
+	projection<projection_from, projection_to> p(projection_from(), l);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE);
+	t.run(projection<projection_to, projection_from>(l, projection_from()),
+			out_x, out_y, back_x, back_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_wgs84_stere)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = -60.0 - 25.0 * (0.5 + 0.5 * cos(14 * M_PI * i / SIZE));
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::stere<ellipsoids::WGS84, double>	projection_to;
+
+	projection_to s(projection_to::offset_t(0.0, 0.0), -90.0, -71.0, 0.0);
+	projection<projection_from, projection_to> p(projection_from(), s);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-4);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-4);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE);
+	t.run(projection<projection_to, projection_from>(s, projection_from()),
+			out_x, out_y, back_x, back_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_wgs84_sinu)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 89.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::sinu<ellipsoids::WGS84, double>	projection_to;
+
+	projection_to s(projection_to::offset_t(0.0, 0.0), 0.0);
+	projection<projection_from, projection_to> p(projection_from(), s);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-4);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-4);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE);
+	t.run(projection<projection_to, projection_from>(s, projection_from()),
+			out_x, out_y, back_x, back_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_wgs84_geos)
+{
+	const size_t SIZE = 10000;
+
+	// the whole globe, roughly half of it can't be seen
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 89.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::geos<ellipsoids::WGS84, double>	projection_to;
+
+	projection_to s(projection_to::offset_t(0.0, 0.0), 35786023.0, -75.0, projections::sweep_axis::x);
+	projection<projection_from, projection_to> p(projection_from(), s);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_EQUAL(std::isinf(std_x.at(i)), std::isinf(out_x.at(i)));
+		if (std::isinf(std_x.at(i)))
+			continue;
+
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-4);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-4);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE);
+	t.run(projection<projection_to, projection_from>(s, projection_from()),
+			out_x, out_y, back_x, back_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		if (std::isinf(out_x.at(i)))
+			continue;
+
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_wgs84_geocent)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE), z(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 89.0 * cos(2 * M_PI * i / SIZE);
+		z.at(i) = 5000.0 * sin(6 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), out_z(SIZE),
+		std_x(SIZE), std_y(SIZE), std_z(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								projection_from;
+	typedef projections::geocent<ellipsoids::WGS84, double>	projection_to;
+
+	projection<projection_from, projection_to> p = projection<projection_from, projection_to>(
+			projection_from(), projection_to());
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, z, std_x, std_y, std_z);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, z, out_x, out_y, out_z);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-4);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-4);
+		BOOST_CHECK_SMALL(std_z.at(i) - out_z.at(i), 1e-4);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE), back_z(SIZE);
+	t.run(projection<projection_to, projection_from>(projection_to(), projection_from()),
+			out_x, out_y, out_z, back_x, back_y, back_z);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-7);
+		BOOST_CHECK_SMALL(z.at(i) - back_z.at(i), 1e-4);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_datum_shift)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE), z(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 89.0 * cos(2 * M_PI * i / SIZE);
+		z.at(i) = 5000.0 * sin(6 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), out_z(SIZE),
+		std_x(SIZE), std_y(SIZE), std_z(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	datum_shift<double> ds(ellipsoids::runtime(6378388.0, 297.0),
+			helmert<double>(-81.07, -89.36, -115.75, 0.485, 0.024, 0.413, -0.54,
+				rotation_convention::coordinate_frame),
+			ellipsoids::runtime::of<ellipsoids::WGS84>());
+
+	transformer<cpu> tc;
+	tc.run(ds, x, y, z, std_x, std_y, std_z);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(ds, x, y, z, out_x, out_y, out_z);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-7);
+		BOOST_CHECK_SMALL(std_z.at(i) - out_z.at(i), 1e-4);
+	}
+
+	// without heights
+	tc.run(ds, x, y, std_x, std_y);
+	t.run(ds, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-7);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-7);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_composite)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 2000.0 * (0.5 + 0.5 * sin(2 * M_PI * i / SIZE));
+		y.at(i) = 1500.0 * (0.5 + 0.5 * cos(6 * M_PI * i / SIZE));
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	const double hc[8] = { 1.2, 0.1, 30.0, -0.05, 0.9, 12.0, 1e-4, -2e-4 };
+	homography<double> h(hc);
+	affine<double> gt(440720.0, 60.0, 0.5, 3751320.0, 0.25, -60.0);
+
+	auto p = compose(h, gt);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_polynomial)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 2000.0 * (0.5 + 0.5 * sin(2 * M_PI * i / SIZE));
+		y.at(i) = 1500.0 * (0.5 + 0.5 * cos(6 * M_PI * i / SIZE));
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	// order 2 terms are 1, x, x^2, y, xy, y^2
+	const double cx[6] = { 440720.0, 60.0, -2e-4, 0.5, 1e-3, 0.0 },
+		  cy[6] = { 3751320.0, 0.25, 0.0, -60.0, 0.0, 3e-4 };
+	polynomial<double> p(2, cx, cy);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_computes_thin_plate_spline)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 2000.0 * (0.5 + 0.5 * sin(2 * M_PI * i / SIZE));
+		y.at(i) = 1500.0 * (0.5 + 0.5 * cos(6 * M_PI * i / SIZE));
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::vector<double> sx, sy, dx, dy;
+	for (size_t r = 0 ; r < 20 ; r ++) {
+		for (size_t c = 0 ; c < 20 ; c ++) {
+			double px = c * 2000.0 / 19, py = r * 1500.0 / 19;
+
+			sx.push_back(px);
+			sy.push_back(py);
+			dx.push_back(440720.0 + 60.0 * px + 40.0 * sin(px / 300.0) * cos(py / 250.0));
+			dy.push_back(3751320.0 - 60.0 * py + 25.0 * cos(px / 400.0 + py / 350.0));
+		}
+	}
+
+	thin_plate_spline<double> tps(sx, sy, dx, dy);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(tps, x, y, std_x, std_y);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(tps, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(multi_device_computes_wgs84_tmerc)
+{
+	// large enough to be split when there are several devices
+	const size_t SIZE = 200000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 3.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 80.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::tmerc<ellipsoids::WGS84, double>> forward;
+
+	forward p(projections::latlong(), projections::utm<ellipsoids::WGS84, double>(33));
+
+	std::vector<double> std_x(SIZE), std_y(SIZE), out_x(SIZE), out_y(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	// twice, the second run is split by measured throughput
+	transformer<multi_opencl<any_device>> t;
+	for (int run = 0 ; run < 2 ; run ++) {
+		std::fill(out_x.begin(), out_x.end(), 0.);
+		std::fill(out_y.begin(), out_y.end(), 0.);
+
+		t.run(p, x, y, out_x, out_y);
+
+		for(size_t i = 0 ; i < SIZE ; i ++) {
+			BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+			BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+		}
+	}
+
+	// the first run built and tuned its kernels, the second was timed.  Throughput is
+	// kept per transform.
+	std::vector<double> measured = t.backend().throughput<forward>();
+	BOOST_CHECK(*std::max_element(measured.begin(), measured.end()) > 0.);
+
+	std::vector<double> other = t.backend().throughput<scale<double>>();
+	BOOST_CHECK_EQUAL(other.size(), measured.size());
+	BOOST_CHECK_EQUAL(*std::max_element(other.begin(), other.end()), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(multi_device_computes_datum_shift)
+{
+	const size_t SIZE = 100000;
+
+	std::vector<double> lon(SIZE), lat(SIZE), h(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		lon.at(i) = -10.0 + 40.0 * i / SIZE;
+		lat.at(i) = 35.0 + 30.0 * sin(2 * M_PI * i / SIZE);
+		h.at(i) = 100.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	// ED50 to WGS84
+	datum_shift<double> ds(ellipsoids::runtime(6378388.0, 297.0),
+			helmert<double>(-87, -98, -121, 0, 0, 0, 0),
+			ellipsoids::runtime::of<ellipsoids::WGS84>());
+
+	std::vector<double> std_x(SIZE), std_y(SIZE), std_z(SIZE),
+		out_x(SIZE), out_y(SIZE), out_z(SIZE);
+
+	transformer<cpu> tc;
+	tc.run(ds, lon, lat, h, std_x, std_y, std_z);
+
+	transformer<multi_opencl<any_device>> t;
+	t.run(ds, lon, lat, h, out_x, out_y, out_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_z.at(i) - out_z.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_covers_every_point_with_any_tuning)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	// not a multiple of anything the launches use
+	const size_t SIZE = 10007;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = i;
+		y.at(i) = -1.0 * i;
+	}
+
+	opencl<gpu_device> b;
+
+	const kernel_tuning tunings[] = { { 0, 1 }, { 64, 1 }, { 32, 3 }, { 128, 8 }, { 0, 5 } };
+	for (const kernel_tuning& t : tunings) {
+		b.set_tuning<scale<double>>(t);
+
+		std::vector<double> out_x(SIZE, 0.), out_y(SIZE, 0.);
+		b.run(scale<double>(2.0), x, y, out_x, out_y);
+
+		for (size_t i = 0 ; i < SIZE ; i ++) {
+			BOOST_CHECK_EQUAL(out_x.at(i), 2.0 * i);
+			BOOST_CHECK_EQUAL(out_y.at(i), -2.0 * i);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_tunes_large_batches_and_saves_tunings)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::webmerc> forward;
+
+	const size_t SIZE = opencl<gpu_device>::autotune_min_points + 1;
+
+	std::vector<double> x(SIZE), y(SIZE), std_x(SIZE), std_y(SIZE), out_x(SIZE), out_y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = -180.0 + 360.0 * i / SIZE;
+		y.at(i) = 80.0 * sin(2 * M_PI * i / SIZE);
+	}
+
+	forward p = forward(projections::latlong(), projections::webmerc());
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	std::stringstream saved;
+	kernel_tuning tuned;
+	{
+		opencl<gpu_device> b;
+		b.run(p, x, y, out_x, out_y);
+
+		for (size_t i = 0 ; i < SIZE ; i ++) {
+			BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+			BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+		}
+
+		tuned = b.tuning<forward>();
+		BOOST_CHECK(tuned.points_per_item >= 1);
+		b.save_tuning(saved);
+	}
+
+	opencl<gpu_device> b;
+	kernel_tuning before = b.tuning<forward>();
+	BOOST_CHECK_EQUAL(before.local_size, 0u);
+	BOOST_CHECK_EQUAL(before.points_per_item, 1u);
+
+	// lines are the device's name and the kernel function
+	const std::string line = backends::detail::device_name(b.device()) + "\twebmerc_forward_kernel\t";
+	BOOST_CHECK_EQUAL(saved.str().find(line), 0u);
+
+	b.load_tuning(saved);
+	kernel_tuning after = b.tuning<forward>();
+	BOOST_CHECK_EQUAL(after.local_size, tuned.local_size);
+	BOOST_CHECK_EQUAL(after.points_per_item, tuned.points_per_item);
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_instances_and_threads_are_independent)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::tmerc<ellipsoids::WGS84, double>> forward;
+
+	const size_t SIZE = 50000;
+	const unsigned THREADS = 4;
+
+	std::vector<double> x(SIZE), y(SIZE), std_x(SIZE), std_y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 3.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 70.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<forward> zones;
+	for (unsigned t = 0 ; t < THREADS ; t ++)
+		zones.push_back(forward(projections::latlong(), projections::utm<ellipsoids::WGS84, double>(31 + t)));
+
+	std::unique_ptr<opencl<gpu_device>> other(new opencl<gpu_device>());
+	opencl<gpu_device> b;
+
+	// a second instance going away leaves the first one's kernels alone
+	other.reset();
+
+	// every thread runs its own zone on the shared backend
+	std::vector<std::vector<double>> out_x(THREADS, std::vector<double>(SIZE)),
+		out_y(THREADS, std::vector<double>(SIZE));
+
+	std::vector<std::thread> threads;
+	for (unsigned t = 0 ; t < THREADS ; t ++) {
+		threads.push_back(std::thread([&, t]() {
+			for (int run = 0 ; run < 3 ; run ++)
+				b.run(zones[t], x, y, out_x[t], out_y[t]);
+		}));
+	}
+
+	for (std::thread& t : threads)
+		t.join();
+
+	transformer<cpu> tc;
+	for (unsigned t = 0 ; t < THREADS ; t ++) {
+		tc.run(zones[t], x, y, std_x, std_y);
+
+		for (size_t i = 0 ; i < SIZE ; i ++) {
+			BOOST_CHECK_SMALL(std_x.at(i) - out_x[t].at(i), 1e-6);
+			BOOST_CHECK_SMALL(std_y.at(i) - out_y[t].at(i), 1e-6);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_builds_programs_on_first_use)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::webmerc> forward;
+	typedef projection<projections::webmerc, projections::latlong> inverse;
+
+	const size_t SIZE = 20000;
+	const unsigned THREADS = 4;
+
+	std::vector<double> x, y, std_x(SIZE), std_y(SIZE);
+	gen_latlong_points(x, y, SIZE);
+
+	forward p = forward(projections::latlong(), projections::webmerc());
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	// every thread's first run wants the same program
+	opencl<gpu_device> b;
+
+	std::vector<std::vector<double>> out_x(THREADS, std::vector<double>(SIZE)),
+		out_y(THREADS, std::vector<double>(SIZE));
+
+	std::vector<std::thread> threads;
+	for (unsigned t = 0 ; t < THREADS ; t ++)
+		threads.push_back(std::thread([&, t]() { b.run(p, x, y, out_x[t], out_y[t]); }));
+
+	for (std::thread& t : threads)
+		t.join();
+
+	for (unsigned t = 0 ; t < THREADS ; t ++) {
+		for (size_t i = 0 ; i < SIZE ; i ++) {
+			BOOST_CHECK_SMALL(std_x.at(i) - out_x[t].at(i), 1e-6);
+			BOOST_CHECK_SMALL(std_y.at(i) - out_y[t].at(i), 1e-6);
+		}
+	}
+
+	// warmed up programs run the same
+	opencl<gpu_device> warm;
+	warm.warm_up<forward, composite<forward, inverse>>();
+
+	std::vector<double> round_x(SIZE), round_y(SIZE);
+	warm.run(composite<forward, inverse>(p, inverse(projections::webmerc(), projections::latlong())),
+			x, y, round_x, round_y);
+
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - round_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(y.at(i) - round_y.at(i), 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_profiles_uploads_kernels_and_downloads)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::tmerc<ellipsoids::WGS84, double>> forward;
+
+	const size_t SIZE = 10000;
+
+	std::vector<double> x, y, out_x(SIZE), out_y(SIZE);
+	gen_latlong_points(x, y, SIZE);
+
+	opencl_options options;
+	options.profiling = true;
+
+	transformer<opencl<gpu_device>> t(options);
+	BOOST_CHECK(t.backend().take_run_stats().empty());
+
+	forward p = forward(projections::latlong(), projections::utm<ellipsoids::WGS84, double>(33));
+
+	t.run(p, x, y, out_x, out_y);
+	t.run(p, x, y, out_x, out_y);
+
+	std::vector<opencl_run_stats> stats = t.backend().take_run_stats();
+	BOOST_REQUIRE_EQUAL(stats.size(), 2u);
+	BOOST_CHECK(t.backend().take_run_stats().empty());
+
+	const opencl_run_stats& s = stats[0];
+	BOOST_CHECK_EQUAL(s.points, SIZE);
+	BOOST_REQUIRE_EQUAL(s.events.size(), 5u);
+	BOOST_CHECK_EQUAL(s.events[0].category, "upload");
+	BOOST_CHECK_EQUAL(s.events[2].category, "kernel");
+	BOOST_CHECK_EQUAL(s.events[2].name, "tmerc_forward_kernel");
+	BOOST_CHECK_EQUAL(s.events[4].category, "download");
+
+	for (const opencl_event_stats& e : s.events) {
+		BOOST_CHECK(e.queued <= e.submitted);
+		BOOST_CHECK(e.submitted <= e.started);
+		BOOST_CHECK(e.started <= e.ended);
+	}
+
+	BOOST_CHECK(s.device_seconds("kernel") > 0.);
+	BOOST_CHECK(s.device_seconds("kernel") <= s.host_seconds);
+
+	std::ostringstream trace;
+	write_chrome_trace(trace, stats);
+	BOOST_CHECK(trace.str().find("\"tmerc_forward_kernel\"") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_precision_profiles_stay_within_their_errors)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::tmerc<ellipsoids::WGS84, double>> forward;
+	forward p = forward(projections::latlong(), projections::utm<ellipsoids::WGS84, double>(33));
+
+	const size_t SIZE = 100000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 3.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 80.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	// web mercator from pole to pole, both poles are out of its domain
+	typedef projection<projections::latlong, projections::webmerc> webmerc_forward;
+	webmerc_forward wp = webmerc_forward(projections::latlong(), projections::webmerc());
+
+	std::vector<double> wx(SIZE), wy(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		wx.at(i) = -180.0 + 360.0 * i / SIZE;
+		wy.at(i) = -90.0 + 180.0 * i / (SIZE - 1);
+	}
+
+	// meters, loose bounds, the measured errors are reported for the device at hand.
+	// fast and native may drop infinities, so their mask mismatches are only reported.
+	const struct {
+		const char *name;
+		opencl_precision precision;
+		double max_error;
+		bool keeps_infinities;
+	} profiles[] = {
+		{ "strict", opencl_precision::strict, 1e-6, true },
+		{ "relaxed", opencl_precision::relaxed, 1e-6, true },
+		{ "fast", opencl_precision::fast, 1e-6, false },
+		{ "native", opencl_precision::native, 10.0, false }
+	};
+
+	for (const auto& profile : profiles) {
+		opencl_options options;
+		options.precision = profile.precision;
+
+		transformer<opencl<gpu_device>> t(options);
+		accuracy_report r = measure_accuracy(t.backend(), p, x, y);
+		accuracy_report w = measure_accuracy(t.backend(), wp, wx, wy);
+
+		BOOST_TEST_MESSAGE(profile.name << ": max " << r.max_error << " m, rms "
+				<< r.rms_error << " m, " << r.max_ulps << " ulps, "
+				<< w.mask_mismatches << " web mercator mask mismatches");
+
+		BOOST_CHECK_EQUAL(r.points, SIZE);
+		BOOST_CHECK(r.max_error < profile.max_error);
+		BOOST_CHECK(r.rms_error <= r.max_error);
+		BOOST_CHECK_EQUAL(r.mask_mismatches, 0u);
+
+		BOOST_CHECK_EQUAL(w.points + 2, SIZE);
+		if (profile.keeps_infinities)
+			BOOST_CHECK_EQUAL(w.mask_mismatches, 0u);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gpu_device_stages_deques_and_takes_pointers)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projection<projections::latlong, projections::tmerc<ellipsoids::WGS84, double>> forward;
+	forward p = forward(projections::latlong(), projections::utm<ellipsoids::WGS84, double>(33));
+
+	// more points than one staging buffer holds
+	const size_t SIZE = backends::detail::staging_points * 3 + 7;
+
+	std::vector<double> x, y, std_x(SIZE), std_y(SIZE);
+	gen_latlong_points(x, y, SIZE);
+
+	transformer<cpu> tc;
+	tc.run(p, x, y, std_x, std_y);
+
+	std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()),
+		out_x(SIZE), out_y(SIZE);
+
+	transformer<opencl<gpu_device>> t;
+	t.run(p, dx, dy, out_x, out_y);
+
+	std::vector<double> px(SIZE), py(SIZE);
+	t.run(p, &x[0], &y[0], SIZE, &px[0], &py[0]);
+
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_x.at(i) - px.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - py.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(chrome_trace_has_a_process_per_device)
+{
+	using namespace transform::backends;
+
+	opencl_event_stats kernel = { "kernel", "tmerc_forward_kernel", 1000, 2000, 3000, 7000 };
+	opencl_event_stats upload = { "upload", "upload \"x\"", 5000, 5000, 6000, 6500 };
+	opencl_event_stats download = { "download", "download x",
+		3600000001000ull, 3600000001000ull, 3600000001000ull, 3600000002500ull };
+
+	opencl_run_stats a;
+	a.device = "first";
+	a.points = 10;
+	a.queue = 1;
+	a.host_seconds = 1e-5;
+	a.events.push_back(kernel);
+
+	opencl_run_stats b = a;
+	b.device = "second";
+	b.queue = 0;
+	b.events.push_back(upload);
+	b.events.push_back(download);
+
+	BOOST_CHECK_CLOSE(b.device_seconds("kernel"), 4e-6, 1e-9);
+	BOOST_CHECK_CLOSE(b.device_seconds("upload"), 5e-7, 1e-9);
+	BOOST_CHECK_EQUAL(a.device_seconds("download"), 0.);
+
+	std::ostringstream os;
+	write_chrome_trace(os, std::vector<opencl_run_stats>{ a, b });
+	const std::string trace = os.str();
+
+	BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0u);
+	BOOST_CHECK(trace.find("\"args\":{\"name\":\"first\"}") != std::string::npos);
+	BOOST_CHECK(trace.find("\"args\":{\"name\":\"second\"}") != std::string::npos);
+
+	// times are in microseconds from each device's first queued command, fixed point
+	// however long the trace runs
+	BOOST_CHECK(trace.find("\"pid\":0,\"tid\":1,\"ts\":2.000,\"dur\":4.000") != std::string::npos);
+	BOOST_CHECK(trace.find("\"pid\":1,\"tid\":0,\"ts\":2.000,\"dur\":4.000") != std::string::npos);
+	BOOST_CHECK(trace.find("\"ts\":3600000000.000,\"dur\":1.500") != std::string::npos);
+	BOOST_CHECK(trace.find("\"upload \\\"x\\\"\"") != std::string::npos);
+
+	// and the stream's own format is left as it was
+	BOOST_CHECK_EQUAL(os.flags() & std::ios_base::floatfield, std::ios_base::fmtflags(0));
+	BOOST_CHECK_EQUAL(os.precision(), 6);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+// polynomial_test.cpp
+// fitted polynomial transform tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+// a smooth, mildly non linear pixel to world mapping, the kind a GCP warp approximates
+static void warped(double x, double y, double& xo, double& yo) {
+	xo = 440720.0 + 60.0 * x + 0.5 * y + 1e-3 * x * y - 2e-4 * x * x + 1e-7 * x * x * y;
+	yo = 3751320.0 + 0.25 * x - 60.0 * y + 3e-4 * y * y - 5e-8 * y * y * y;
+}
+
+static void gen_gcps(std::vector<double>& sx, std::vector<double>& sy,
+		std::vector<double>& dx, std::vector<double>& dy, size_t side) {
+	for (size_t r = 0 ; r < side ; r ++) {
+		for (size_t c = 0 ; c < side ; c ++) {
+			double x = 2000.0 * c / (side - 1), y = 1500.0 * r / (side - 1), xo, yo;
+			warped(x, y, xo, yo);
+
+			sx.push_back(x);
+			sy.push_back(y);
+			dx.push_back(xo);
+			dy.push_back(yo);
+		}
+	}
+}
+
+static void gen_pixel_points(std::vector<double>& x, std::vector<double>& y, size_t count) {
+	x.resize(count);
+	y.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = 2000.0 * (0.5 + 0.5 * sin(2 * M_PI * i / count));
+		y.at(i) = 1500.0 * (0.5 + 0.5 * cos(6 * M_PI * i / count));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(polynomial_test)
+
+BOOST_AUTO_TEST_CASE(explicit_coefficients)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	// order 2 terms are 1, x, x^2, y, xy, y^2
+	const double cx[6] = { 1.0, 2.0, 0.5, -1.0, 0.25, 0.0 },
+		  cy[6] = { 0.0, 0.0, 0.0, 1.0, 0.0, 0.1 };
+	polynomial<double> p(2, cx, cy);
+
+	std::vector<double> x = { 0.0, 2.0, -1.0 }, y = { 0.0, 3.0, 4.0 };
+	std::vector<double> out_x(3), out_y(3);
+
+	transformer<cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for (size_t i = 0 ; i < x.size() ; i ++) {
+		double px = x.at(i), py = y.at(i);
+		BOOST_CHECK_CLOSE(out_x.at(i) + 10.0, 10.0 + 1.0 + 2.0 * px + 0.5 * px * px - py + 0.25 * px * py, 1e-12);
+		BOOST_CHECK_CLOSE(out_y.at(i) + 10.0, 10.0 + py + 0.1 * py * py, 1e-12);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(fit_reproduces_exact_polynomials)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_gcps(sx, sy, dx, dy, 6);
+
+	// the mapping is exactly cubic, so an order 3 fit reproduces it anywhere
+	polynomial<double> p = polynomial<double>::fit(3, sx, sy, dx, dy);
+
+	std::vector<double> x, y;
+	gen_pixel_points(x, y, 1000);
+
+	std::vector<double> out_x(x.size()), out_y(x.size());
+
+	transformer<cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for (size_t i = 0 ; i < x.size() ; i ++) {
+		double ex, ey;
+		warped(x.at(i), y.at(i), ex, ey);
+
+		BOOST_CHECK_SMALL(out_x.at(i) - ex, 1e-6);
+		BOOST_CHECK_SMALL(out_y.at(i) - ey, 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(first_order_fit_is_affine)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	affine<double> gt(440720.0, 60.0, 0.5, 3751320.0, 0.25, -60.0);
+
+	std::vector<double> sx = { 0.0, 2000.0, 0.0, 2000.0, 1000.0 },
+		sy = { 0.0, 0.0, 1500.0, 1500.0, 750.0 },
+		dx(sx.size()), dy(sx.size());
+
+	transformer<cpu> t;
+	t.run(gt, sx, sy, dx, dy);
+
+	polynomial<double> p = polynomial<double>::fit(1, sx, sy, dx, dy);
+
+	std::vector<double> x, y;
+	gen_pixel_points(x, y, 1000);
+
+	std::vector<double> px(x.size()), py(x.size()), ax(x.size()), ay(x.size());
+	t.run(p, x, y, px, py);
+	t.run(gt, x, y, ax, ay);
+
+	for (size_t i = 0 ; i < x.size() ; i ++) {
+		BOOST_CHECK_SMALL(px.at(i) - ax.at(i), 1e-6);
+		BOOST_CHECK_SMALL(py.at(i) - ay.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(lower_order_fit_minimizes_residuals)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_gcps(sx, sy, dx, dy, 8);
+
+	double max_r[4] = { 0 };
+	for (int order = 1 ; order <= 3 ; order ++) {
+		polynomial<double> p = polynomial<double>::fit(order, sx, sy, dx, dy);
+
+		// residuals of a least squares fit are orthogonal to every term, in particular
+		// they sum to zero
+		double sum_x = 0, sum_y = 0;
+		for (size_t i = 0 ; i < sx.size() ; i ++) {
+			double ox, oy;
+			p.op(sx.at(i), sy.at(i), ox, oy);
+
+			sum_x += ox - dx.at(i);
+			sum_y += oy - dy.at(i);
+			max_r[order] = std::max(max_r[order],
+					std::max(std::abs(ox - dx.at(i)), std::abs(oy - dy.at(i))));
+		}
+
+		BOOST_CHECK_SMALL(sum_x, 1e-6);
+		BOOST_CHECK_SMALL(sum_y, 1e-6);
+	}
+
+	// every extra order captures more of the mapping, the cubic one all of it
+	BOOST_CHECK(max_r[1] > max_r[2]);
+	BOOST_CHECK(max_r[2] > max_r[3]);
+	BOOST_CHECK_SMALL(max_r[3], 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(bad_gcps_throw)
+{
+	using namespace transform::transforms;
+
+	std::vector<double> sx = { 0.0, 1.0, 2.0, 3.0 }, sy = { 0.0, 1.0, 2.0, 3.0 },
+		dx = { 0.0, 1.0, 2.0, 3.0 }, dy = { 5.0, 6.0, 7.0, 8.0 };
+
+	// too few points for the order, collinear points and mismatched arrays
+	BOOST_CHECK_THROW(polynomial<double>::fit(2, sx, sy, dx, dy), std::invalid_argument);
+	BOOST_CHECK_THROW(polynomial<double>::fit(1, sx, sy, dx, dy), std::invalid_argument);
+	BOOST_CHECK_THROW(polynomial<double>::fit(4, sx, sy, dx, dy), std::invalid_argument);
+
+	dy.pop_back();
+	BOOST_CHECK_THROW(polynomial<double>::fit(1, sx, sy, dx, dy), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	using namespace transform::transforms;
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_gcps(sx, sy, dx, dy, 6);
+
+	std::vector<double> x, y;
+	gen_pixel_points(x, y, 10001);
+
+	for (int order = 1 ; order <= 3 ; order ++)
+		check_batch_matches_op(polynomial<double>::fit(order, sx, sy, dx, dy), x, y);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
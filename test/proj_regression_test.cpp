@@ -0,0 +1,624 @@
+// proj_regression_test.cpp
+// accuracy and throughput of every projection, datum shift and backend against PROJ, checked
+// against the thresholds stored in proj_regression_thresholds.txt
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifndef TRANSFORM_TEST_DATA_DIR
+#define TRANSFORM_TEST_DATA_DIR "."
+#endif
+
+namespace {
+	typedef std::chrono::high_resolution_clock timer;
+
+	const size_t POINTS = 20000;
+	const int REPEATS = 5;
+
+	const double EARTH_RADIUS = 6378137.0;
+	const double TO_RADIANS = 0.017453292519943295769236907684886;
+
+	// a box of lon/lat (degrees) to sample, adversarial sets are narrow boxes at the places
+	// where projections get into trouble
+	struct dataset {
+		const char *name;
+		double lon_min, lon_max, lat_min, lat_max;
+	};
+
+	// how coordinates are compared, errors are always in millimeters
+	enum class coordinates {
+		planar,			// meters, distance in the plane
+		geodetic,		// degrees, distance on the ground plus height
+		geocentric		// meters, distance in space
+	};
+
+	struct point_set {
+		std::vector<double> x, y, z;
+
+		explicit point_set(size_t n = 0) : x(n), y(n), z(n) { }
+		size_t size() const { return x.size(); }
+	};
+
+	// stored limits per projection, direction, backend and dataset
+	struct threshold {
+		double max_mm, rms_mm, min_speedup;
+	};
+
+	struct measurement {
+		size_t points;
+		double max_mm, rms_mm;
+		double points_per_second, proj_points_per_second;
+	};
+
+	class threshold_store {
+		public:
+		explicit threshold_store(const std::string& path) : path_(path) {
+			std::ifstream is(path.c_str());
+
+			std::string line;
+			while (std::getline(is, line)) {
+				if (line.empty() || line[0] == '#')
+					continue;
+
+				std::istringstream ls(line);
+				std::string projection, direction, backend, set;
+				threshold t;
+
+				if (ls >> projection >> direction >> backend >> set >> t.max_mm >> t.rms_mm >> t.min_speedup)
+					thresholds_[key(projection, direction, backend, set)] = t;
+			}
+		}
+
+		const threshold *find(const std::string& k) const {
+			auto i = thresholds_.find(k);
+			return (i == thresholds_.end()) ? NULL : &i->second;
+		}
+
+		// measured values with headroom, noise shouldn't fail the next run.  Timings of runs
+		// this short vary by close to 2x between runs, so speed only fails on a 3x slowdown.
+		void record(const std::string& k, const measurement& m) {
+			threshold t;
+			t.max_mm = std::max(1e-6, 2. * m.max_mm);
+			t.rms_mm = std::max(1e-6, 2. * m.rms_mm);
+			t.min_speedup = m.points_per_second / m.proj_points_per_second / 3.;
+
+			thresholds_[k] = t;
+		}
+
+		void save() const {
+			std::ofstream os(path_.c_str());
+
+			os << "# projection\tdirection\tbackend\tdataset\tmax_mm\trms_mm\tmin_speedup\n"
+			   << "# errors against PROJ in millimeters, speedup is points per second over PROJ's\n";
+
+			for (const auto& t : thresholds_)
+				os << t.first << '\t' << t.second.max_mm << '\t' << t.second.rms_mm << '\t'
+				   << t.second.min_speedup << '\n';
+		}
+
+		static std::string key(const std::string& projection, const std::string& direction,
+				const std::string& backend, const std::string& set) {
+			return projection + '\t' + direction + '\t' + backend + '\t' + set;
+		}
+
+		private:
+		std::string path_;
+		std::map<std::string, threshold> thresholds_;
+	};
+
+	threshold_store& stored_thresholds() {
+		static threshold_store store(std::string(TRANSFORM_TEST_DATA_DIR) + "/proj_regression_thresholds.txt");
+		return store;
+	}
+
+	// backends whose combinations may go without a stored row
+	bool report_only(const std::string& backend_name) {
+		return backend_name == "opencl";
+	}
+
+	// TRANSFORM_UPDATE_THRESHOLDS=1 rewrites the stored thresholds from this run instead of
+	// checking them, for after a change which is meant to move them
+	bool updating_thresholds() {
+		const char *v = std::getenv("TRANSFORM_UPDATE_THRESHOLDS");
+		return v != NULL && std::string(v) == "1";
+	}
+
+	point_set sample(const dataset& d, unsigned seed) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<double>
+			lon(d.lon_min, d.lon_max), lat(d.lat_min, d.lat_max), height(-100., 9000.);
+
+		point_set p(POINTS);
+		for (size_t i = 0 ; i < POINTS ; i ++) {
+			p.x[i] = lon(rng);
+			p.y[i] = lat(rng);
+			p.z[i] = height(rng);
+		}
+
+		return p;
+	}
+
+	// PROJ's result for p between two definitions, geodetic sides are in degrees
+	double proj_transform(const std::string& from, coordinates from_type,
+			const std::string& to, coordinates to_type, point_set& p, int repeats) {
+		projPJ pj_from = pj_init_plus(from.c_str()), pj_to = pj_init_plus(to.c_str());
+		BOOST_REQUIRE(pj_from != NULL);
+		BOOST_REQUIRE(pj_to != NULL);
+
+		if (from_type == coordinates::geodetic) {
+			for (size_t i = 0 ; i < p.size() ; i ++) {
+				p.x[i] *= TO_RADIANS;
+				p.y[i] *= TO_RADIANS;
+			}
+		}
+
+		// timed on copies, pj_transform works in place
+		double best = HUGE_VAL;
+		point_set in = p;
+
+		for (int r = 0 ; r < repeats ; r ++) {
+			p = in;
+
+			timer::time_point start = timer::now();
+			pj_transform(pj_from, pj_to, static_cast<long>(p.size()), 1, &p.x[0], &p.y[0], &p.z[0]);
+			best = std::min(best, std::chrono::duration<double>(timer::now() - start).count());
+		}
+
+		pj_free(pj_from);
+		pj_free(pj_to);
+
+		if (to_type == coordinates::geodetic) {
+			for (size_t i = 0 ; i < p.size() ; i ++) {
+				p.x[i] /= TO_RADIANS;
+				p.y[i] /= TO_RADIANS;
+			}
+		}
+
+		return best;
+	}
+
+	// keep the points with a finite result
+	void keep_finite(point_set& in, point_set& out) {
+		point_set kept_in, kept_out;
+
+		for (size_t i = 0 ; i < out.size() ; i ++) {
+			if (!std::isfinite(out.x[i]) || !std::isfinite(out.y[i]) || !std::isfinite(out.z[i]))
+				continue;
+
+			kept_in.x.push_back(in.x[i]); kept_in.y.push_back(in.y[i]); kept_in.z.push_back(in.z[i]);
+			kept_out.x.push_back(out.x[i]); kept_out.y.push_back(out.y[i]); kept_out.z.push_back(out.z[i]);
+		}
+
+		in = kept_in;
+		out = kept_out;
+	}
+
+	double error_mm(coordinates type, const point_set& expected, const point_set& actual, size_t i) {
+		if (!std::isfinite(actual.x[i]) || !std::isfinite(actual.y[i]) || !std::isfinite(actual.z[i]))
+			return std::numeric_limits<double>::infinity();
+
+		double dx = actual.x[i] - expected.x[i],
+			   dy = actual.y[i] - expected.y[i],
+			   dz = actual.z[i] - expected.z[i];
+
+		if (type == coordinates::planar)
+			dz = 0.;
+
+		if (type == coordinates::geodetic) {
+			// -180 and 180 are the same meridian
+			dx = std::remainder(dx, 360.);
+
+			dx *= TO_RADIANS * EARTH_RADIUS * std::cos(expected.y[i] * TO_RADIANS);
+			dy *= TO_RADIANS * EARTH_RADIUS;
+		}
+
+		return 1000. * std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+	// one direction of a projection, its inputs and PROJ's answers for every dataset
+	struct reference {
+		std::string projection, direction, set;
+		coordinates output;
+
+		point_set in, expected;
+		double proj_seconds;
+	};
+
+	template<typename TBackend, typename TTransform>
+	void check_backend(const std::string& backend_name, const TBackend& b, const TTransform& t,
+			const reference& ref) {
+		point_set out(ref.in.size());
+
+		double best = HUGE_VAL;
+		for (int r = 0 ; r < REPEATS ; r ++) {
+			timer::time_point start = timer::now();
+			b.run(t, ref.in.x, ref.in.y, ref.in.z, out.x, out.y, out.z);
+			best = std::min(best, std::chrono::duration<double>(timer::now() - start).count());
+		}
+
+		measurement m = { ref.in.size(), 0., 0., 0., 0. };
+
+		double sum = 0.;
+		for (size_t i = 0 ; i < out.size() ; i ++) {
+			double e = error_mm(ref.output, ref.expected, out, i);
+
+			m.max_mm = std::max(m.max_mm, e);
+			sum += e * e;
+		}
+
+		if (m.points > 0)
+			m.rms_mm = std::sqrt(sum / m.points);
+
+		m.points_per_second = m.points / std::max(best, 1e-9);
+		m.proj_points_per_second = m.points / std::max(ref.proj_seconds, 1e-9);
+
+		BOOST_TEST_MESSAGE(ref.projection << ' ' << ref.direction << ' ' << backend_name << ' ' << ref.set
+				<< ": " << m.points << " points, max " << m.max_mm << " mm, rms " << m.rms_mm << " mm, "
+				<< m.points_per_second << " points/s (PROJ " << m.proj_points_per_second << ")");
+
+		const std::string k = threshold_store::key(ref.projection, ref.direction, backend_name, ref.set);
+
+		if (updating_thresholds()) {
+			stored_thresholds().record(k, m);
+			return;
+		}
+
+		// every measured cpu combination has a row, a missing one means the file is out of
+		// date.  OpenCL ones are only reported until recorded on a device with double
+		// precision, there's no reference device for them.
+		const threshold *th = stored_thresholds().find(k);
+		if (!th && report_only(backend_name)) {
+			BOOST_TEST_MESSAGE(k << ": no stored threshold, reported only");
+			return;
+		}
+
+		if (!th) {
+			BOOST_ERROR(k << ": no stored threshold, run with TRANSFORM_UPDATE_THRESHOLDS=1");
+			return;
+		}
+
+		BOOST_CHECK_MESSAGE(m.max_mm <= th->max_mm,
+				k << ": max error " << m.max_mm << " mm over " << th->max_mm << " mm");
+		BOOST_CHECK_MESSAGE(m.rms_mm <= th->rms_mm,
+				k << ": rms error " << m.rms_mm << " mm over " << th->rms_mm << " mm");
+		BOOST_CHECK_MESSAGE(m.points_per_second >= th->min_speedup * m.proj_points_per_second,
+				k << ": " << m.points_per_second / m.proj_points_per_second
+				<< " times PROJ's throughput, under " << th->min_speedup);
+	}
+
+	// transforms without OpenCL kernels only run on the cpu backends
+	template<typename TTransform>
+	void check_backends(const TTransform& t, const reference& ref, std::false_type) {
+		using namespace transform::backends;
+
+		check_backend("cpu", cpu(), t, ref);
+		check_backend("multi_cpu", full_concurrency_multi_cpu(), t, ref);
+	}
+
+	template<typename TTransform>
+	void check_backends(const TTransform& t, const reference& ref, std::true_type) {
+		using namespace transform::backends;
+
+		check_backends(t, ref, std::false_type());
+
+		// only where there's a device with double precision
+		std::unique_ptr<opencl<any_device>> device;
+		try {
+			if (opencl<any_device>::supports_double_precision())
+				device.reset(new opencl<any_device>());
+		}
+		catch(const std::runtime_error&) {
+		}
+
+		if (device)
+			check_backend("opencl", *device, t, ref);
+		else
+			BOOST_TEST_MESSAGE(ref.projection << ' ' << ref.direction << " opencl " << ref.set
+					<< ": no OpenCL device");
+	}
+
+	// check forward (from -> to) and inverse (to -> from) over every dataset, from and to
+	// are the PROJ definitions of either side.  The datasets are geodetic, so from has to be.
+	template<typename TForward, typename TInverse, typename TOnDevice>
+	void check_transform(const std::string& name, const TForward& forward, const TInverse& inverse,
+			const std::string& from, const std::string& to, coordinates to_type,
+			const std::vector<dataset>& sets, TOnDevice on_device) {
+		unsigned seed = 1;
+		for (const dataset& d : sets) {
+			reference f;
+			f.projection = name;
+			f.direction = "forward";
+			f.set = d.name;
+			f.output = to_type;
+			f.in = sample(d, seed ++);
+			f.expected = f.in;
+			f.proj_seconds = proj_transform(from, coordinates::geodetic, to, to_type,
+					f.expected, REPEATS);
+
+			keep_finite(f.in, f.expected);
+			BOOST_REQUIRE_MESSAGE(f.in.size() > 0, name << ' ' << d.name << " has no points PROJ transforms");
+
+			check_backends(forward, f, on_device);
+
+			// the inverse starts from PROJ's forward results
+			reference i;
+			i.projection = name;
+			i.direction = "inverse";
+			i.set = d.name;
+			i.output = coordinates::geodetic;
+			i.in = f.expected;
+			i.expected = i.in;
+			i.proj_seconds = proj_transform(to, to_type, from, coordinates::geodetic,
+					i.expected, REPEATS);
+
+			keep_finite(i.in, i.expected);
+
+			check_backends(inverse, i, on_device);
+		}
+
+		if (updating_thresholds())
+			stored_thresholds().save();
+	}
+
+	// latlong to TProjection and back.  proj is the PROJ definition of the projection and
+	// geodetic the matching latlong one (the same ellipsoid, so PROJ doesn't shift datums).
+	template<typename TProjection>
+	void check_projection(const std::string& name, const TProjection& p,
+			const std::string& geodetic, const std::string& proj, coordinates projected,
+			const std::vector<dataset>& sets) {
+		using namespace transform::transforms;
+		using namespace transform::cartographic;
+
+		check_transform(name,
+				projection<projections::latlong, TProjection>(projections::latlong(), p),
+				projection<TProjection, projections::latlong>(p, projections::latlong()),
+				geodetic, proj, projected, sets, std::true_type());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(proj_regression_test)
+
+BOOST_AUTO_TEST_CASE(utm_zone_33)
+{
+	using namespace transform::cartographic;
+
+	// far from the meridian stays within 6 degrees of it, the series tmerc is meant for
+	// zones and their overlaps.  PROJ 9 uses the exact algorithm, which the series drifts
+	// away from by meters 10 degrees out and kilometers 30 degrees out.
+	std::vector<dataset> sets = {
+		{ "random", 12.0, 18.0, -80.0, 84.0 },
+		{ "zone_edges", 11.0, 12.0, -80.0, 84.0 },
+		{ "far_from_meridian", 18.0, 21.0, -60.0, 60.0 },
+		{ "poles", 12.0, 18.0, 89.0, 90.0 }
+	};
+
+	check_projection("utm33", projections::utm<ellipsoids::WGS84, double>(33),
+			"+proj=latlong +ellps=WGS84",
+			"+proj=tmerc +lat_0=0 +lon_0=15 +k=0.9996 +x_0=500000 +y_0=0 +ellps=WGS84",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(utm_zone_60)
+{
+	using namespace transform::cartographic;
+
+	std::vector<dataset> sets = {
+		{ "random", 174.0, 180.0, -80.0, 84.0 },
+		{ "antimeridian_east", 179.9, 180.0, -80.0, 84.0 },
+		{ "antimeridian_west", -180.0, -179.9, -80.0, 84.0 }
+	};
+
+	check_projection("utm60", projections::utm<ellipsoids::WGS84, double>(60),
+			"+proj=latlong +ellps=WGS84",
+			"+proj=tmerc +lat_0=0 +lon_0=177 +k=0.9996 +x_0=500000 +y_0=0 +ellps=WGS84",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(spherical_tmerc)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::tmerc<ellipsoids::sphere, double> tmerc_type;
+
+	std::vector<dataset> sets = {
+		{ "random", -3.0, 3.0, -80.0, 80.0 },
+		{ "far_from_meridian", 30.0, 60.0, -60.0, 60.0 }
+	};
+
+	check_projection("tmerc_sphere", tmerc_type(tmerc_type::offset_t(0.0, 0.0)),
+			"+proj=latlong +ellps=sphere", "+proj=tmerc +ellps=sphere",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(web_mercator)
+{
+	using namespace transform::cartographic;
+
+	std::vector<dataset> sets = {
+		{ "random", -180.0, 180.0, -85.0, 85.0 },
+		{ "antimeridian", 179.9, 180.0, -85.0, 85.0 },
+		{ "latitude_limit", -180.0, 180.0, 85.0, 85.0511 }
+	};
+
+	check_projection("webmerc", projections::webmerc(),
+			"+proj=latlong +a=6378137 +b=6378137",
+			"+proj=merc +a=6378137 +b=6378137 +lat_ts=0 +lon_0=0 +k=1 +x_0=0 +y_0=0",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(lambert_conformal_conic)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::lcc<ellipsoids::WGS84, double> lcc_type;
+
+	std::vector<dataset> sets = {
+		{ "random", -130.0, -60.0, 15.0, 70.0 },
+		{ "far_from_meridian", 150.0, 180.0, 0.0, 60.0 },
+		{ "poles", -180.0, 180.0, 89.0, 90.0 }
+	};
+
+	check_projection("lcc", lcc_type(lcc_type::offset_t(0.0, 0.0), 33.0, 45.0, 39.0, -96.0),
+			"+proj=latlong +ellps=WGS84",
+			"+proj=lcc +lat_1=33 +lat_2=45 +lat_0=39 +lon_0=-96 +x_0=0 +y_0=0 +ellps=WGS84",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(polar_stereographic)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::stere<ellipsoids::WGS84, double> stere_type;
+
+	std::vector<dataset> sets = {
+		{ "random", -180.0, 180.0, 60.0, 90.0 },
+		{ "poles", -180.0, 180.0, 89.9, 90.0 },
+		{ "far_from_pole", -180.0, 180.0, 0.0, 10.0 }
+	};
+
+	check_projection("stere", stere_type(stere_type::offset_t(2000000.0, 2000000.0), 90.0, 90.0, 0.0, 0.994),
+			"+proj=latlong +ellps=WGS84",
+			"+proj=stere +lat_0=90 +lat_ts=90 +lon_0=0 +k=0.994 +x_0=2000000 +y_0=2000000 +ellps=WGS84",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(sinusoidal)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::sinu<ellipsoids::WGS84, double> sinu_type;
+
+	std::vector<dataset> sets = {
+		{ "random", -180.0, 180.0, -90.0, 90.0 },
+		{ "antimeridian", 179.9, 180.0, -80.0, 80.0 },
+		{ "poles", -180.0, 180.0, 89.0, 90.0 }
+	};
+
+	check_projection("sinu", sinu_type(sinu_type::offset_t(0.0, 0.0), 0.0),
+			"+proj=latlong +ellps=WGS84", "+proj=sinu +lon_0=0 +ellps=WGS84",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(geostationary)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::geos<ellipsoids::WGS84, double> geos_type;
+
+	std::vector<dataset> sets = {
+		{ "random", -60.0, 60.0, -60.0, 60.0 },
+		{ "limb", 70.0, 81.0, -10.0, 10.0 }
+	};
+
+	check_projection("geos", geos_type(geos_type::offset_t(0.0, 0.0), 35785831.0, 0.0),
+			"+proj=latlong +ellps=WGS84", "+proj=geos +h=35785831 +lon_0=0 +ellps=WGS84",
+			coordinates::planar, sets);
+}
+
+BOOST_AUTO_TEST_CASE(geocentric)
+{
+	using namespace transform::cartographic;
+
+	std::vector<dataset> sets = {
+		{ "random", -180.0, 180.0, -90.0, 90.0 },
+		{ "poles", -180.0, 180.0, 89.9, 90.0 },
+		{ "antimeridian", 179.9, 180.0, -80.0, 80.0 }
+	};
+
+	check_projection("geocent", projections::geocent<ellipsoids::WGS84, double>(),
+			"+proj=latlong +ellps=WGS84", "+proj=geocent +ellps=WGS84",
+			coordinates::geocentric, sets);
+}
+
+BOOST_AUTO_TEST_CASE(helmert_datum_shift)
+{
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	// ED50 to WGS84 with the EPSG:1133 parameters as position vector rotations, the
+	// convention of PROJ's +towgs84
+	ellipsoids::runtime intl(6378388.0, 297.0), wgs84 = ellipsoids::runtime::of<ellipsoids::WGS84>();
+	helmert<double> to_wgs84(-81.07, -89.36, -115.75, -0.485, -0.024, -0.413, -0.54),
+		from_wgs84(81.07, 89.36, 115.75, 0.485, 0.024, 0.413, 0.54);
+
+	std::vector<dataset> sets = {
+		{ "random", -180.0, 180.0, -90.0, 90.0 },
+		{ "europe", -10.0, 30.0, 35.0, 70.0 },
+		{ "poles", -180.0, 180.0, 89.9, 90.0 },
+		{ "antimeridian", 179.9, 180.0, -80.0, 80.0 }
+	};
+
+	check_transform("helmert",
+			datum_shift<double>(intl, to_wgs84, wgs84), datum_shift<double>(wgs84, from_wgs84, intl),
+			"+proj=latlong +ellps=intl +towgs84=-81.07,-89.36,-115.75,-0.485,-0.024,-0.413,-0.54",
+			"+proj=latlong +datum=WGS84", coordinates::geodetic, sets, std::true_type());
+}
+
+BOOST_AUTO_TEST_CASE(ntv2_grid_shift)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+
+	// PROJ only takes paths starting with ./ as relative to the working directory
+	std::string path = write_ntv2("./proj_regression_test.gsb", false);
+
+	{
+		std::shared_ptr<const grids::ntv2> g(new grids::ntv2(path));
+
+		// inside the root grid, and inside its child where both cover the points
+		std::vector<dataset> sets = {
+			{ "random", -9.9, 9.9, 40.1, 49.9 },
+			{ "subgrid", 0.1, 1.9, 44.1, 45.9 }
+		};
+
+		check_transform("ntv2", ntv2_shift(g), ntv2_shift(g, grid_direction::inverse),
+				"+proj=latlong +ellps=WGS84 +nadgrids=" + path, "+proj=latlong +datum=WGS84",
+				coordinates::geodetic, sets, std::false_type());
+	}
+
+	std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(gtx_grid_shift)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+
+	std::string path = write_gtx("./proj_regression_test.gtx");
+
+	{
+		std::shared_ptr<const grids::gtx> g(new grids::gtx(path));
+
+		// PROJ's +geoidgrids side has heights above the geoid, so its forward adds the
+		// grid like gtx_shift's
+		std::vector<dataset> sets = {
+			{ "random", -19.9, 19.9, 32.1, 59.9 }
+		};
+
+		check_transform("gtx", gtx_shift(g), gtx_shift(g, grid_direction::inverse),
+				"+proj=latlong +datum=WGS84 +geoidgrids=" + path, "+proj=latlong +datum=WGS84",
+				coordinates::geodetic, sets, std::false_type());
+	}
+
+	std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
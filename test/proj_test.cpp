@@ -448,4 +448,465 @@ BOOST_AUTO_TEST_CASE(wgs84_cpu_inv_tmerc)
 }
 
 
+BOOST_AUTO_TEST_CASE(wgs84_cpu_utm_matches_proj)
+{
+	const size_t SIZE = 10000;
+
+	// points inside zone 33 north
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 2.9 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 45.0 + 30.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_from;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	projection_to;
+
+	projection<projection_from, projection_to> p(
+			projection_from(),
+			projections::utm<ellipsoids::WGS84, double>(33));
+
+	transformer<proj> tp;
+	tp.run(p, x, y, std_x, std_y);
+
+	transformer<cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(runtime_cpu_tmerc_matches_proj)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = -2.0 + 5.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 55.0 + 6.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								projection_from;
+	typedef projections::tmerc<ellipsoids::runtime, double>		projection_to;
+
+	// british national grid on airy 1830
+	projection<projection_from, projection_to> p(
+			projection_from(),
+			projection_to(ellipsoids::runtime(6377563.396, 299.3249646),
+				projection_to::offset_t(400000.0, -100000.0), 49.0, -2.0, 0.9996012717));
+
+	transformer<proj> tp;
+	tp.run(p, x, y, std_x, std_y);
+
+	transformer<cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(cpu_webmerc_matches_proj)
+{
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 85.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	projection_from;
+	typedef projections::webmerc	projection_to;
+
+	projection<projection_from, projection_to> p =
+		projection<projection_from, projection_to>(projection_from(), projection_to());
+
+	transformer<proj> tp;
+	tp.run(p, x, y, std_x, std_y);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+}
+
+template<typename TEllipsoid>
+static void check_lcc_matches_proj(const transform::cartographic::projections::lcc<TEllipsoid, double>& l,
+		double lon0, double lat0) {
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = lon0 + 20.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = lat0 + 20.0 * cos(2 * M_PI * i / SIZE);
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong					latlong;
+	typedef projections::lcc<TEllipsoid, double>	lcc_type;
+
+	projection<latlong, lcc_type> p(latlong(), l);
+
+	transformer<proj> tp;
+	tp.run(p, x, y, std_x, std_y);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-3);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-3);
+	}
+
+	// and back again
+	projection<lcc_type, latlong> inv(l, latlong());
+
+	tp.run(inv, std_x, std_y, x, y);
+	t.run(inv, std_x, std_y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(y.at(i) - out_y.at(i), 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_cpu_lcc_2sp_matches_proj)
+{
+	using namespace transform::cartographic;
+	typedef projections::lcc<ellipsoids::WGS84, double> lcc_type;
+
+	// the usual parameters for the contiguous US
+	check_lcc_matches_proj(lcc_type(lcc_type::offset_t(0.0, 0.0), 33.0, 45.0, 23.0, -96.0),
+			-96.0, 35.0);
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_cpu_lcc_2sp_south_matches_proj)
+{
+	using namespace transform::cartographic;
+	typedef projections::lcc<ellipsoids::WGS84, double> lcc_type;
+
+	check_lcc_matches_proj(lcc_type(lcc_type::offset_t(1000000.0, 10000000.0), -18.0, -36.0, -32.0, 135.0),
+			135.0, -30.0);
+}
+
+BOOST_AUTO_TEST_CASE(sphere_cpu_lcc_1sp_matches_proj)
+{
+	using namespace transform::cartographic;
+	typedef projections::lcc<ellipsoids::sphere, double> lcc_type;
+
+	check_lcc_matches_proj(projections::lcc_1sp<ellipsoids::sphere, double>(
+				lcc_type::offset_t(250000.0, 150000.0), 18.0, -77.0, 0.9996), -77.0, 25.0);
+}
+
+template<typename TEllipsoid>
+static void check_stere_matches_proj(const transform::cartographic::projections::stere<TEllipsoid, double>& st,
+		double lat0) {
+	const size_t SIZE = 10000;
+
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = lat0 + 25.0 * (0.5 + 0.5 * cos(14 * M_PI * i / SIZE));
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong					latlong;
+	typedef projections::stere<TEllipsoid, double>	stere_type;
+
+	projection<latlong, stere_type> p(latlong(), st);
+
+	transformer<proj> tp;
+	tp.run(p, x, y, std_x, std_y);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-3);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-3);
+	}
+
+	projection<stere_type, latlong> inv(st, latlong());
+
+	tp.run(inv, std_x, std_y, x, y);
+	t.run(inv, std_x, std_y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(y.at(i) - out_y.at(i), 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_cpu_north_stere_matches_proj)
+{
+	using namespace transform::cartographic;
+	typedef projections::stere<ellipsoids::WGS84, double> stere_type;
+
+	// NSIDC sea ice polar stereographic north
+	check_stere_matches_proj(stere_type(stere_type::offset_t(0.0, 0.0), 90.0, 70.0, -45.0), 60.0);
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_cpu_south_stere_matches_proj)
+{
+	using namespace transform::cartographic;
+	typedef projections::stere<ellipsoids::WGS84, double> stere_type;
+
+	// antarctic polar stereographic
+	check_stere_matches_proj(stere_type(stere_type::offset_t(0.0, 0.0), -90.0, -71.0, 0.0), -85.0);
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_cpu_ups_matches_proj)
+{
+	using namespace transform::cartographic;
+	typedef projections::stere<ellipsoids::WGS84, double> stere_type;
+
+	// universal polar stereographic north, scale set at the pole
+	check_stere_matches_proj(stere_type(stere_type::offset_t(2000000.0, 2000000.0), 90.0, 90.0, 0.0, 0.994), 60.0);
+}
+
+BOOST_AUTO_TEST_CASE(cpu_sinu_matches_proj)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10000;
+	gen_latlong_points(x, y, SIZE);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::sinu<ellipsoids::WGS84, double>	sinu_type;
+	typedef projections::sinu<ellipsoids::sphere, double>	modis_type;
+
+	transformer<proj> tp;
+	transformer<full_concurrency_multi_cpu> t;
+
+	projection<latlong, sinu_type> p(latlong(), sinu_type(sinu_type::offset_t(500.0, -500.0), 10.0));
+	projection<latlong, modis_type> m(latlong(), projections::modis_sinu<double>());
+
+	tp.run(p, x, y, std_x, std_y);
+	t.run(p, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-3);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-3);
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE), proj_x(SIZE), proj_y(SIZE);
+
+	projection<sinu_type, latlong> inv(p.to, latlong());
+	tp.run(inv, std_x, std_y, proj_x, proj_y);
+	t.run(inv, std_x, std_y, back_x, back_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(proj_x.at(i) - back_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(proj_y.at(i) - back_y.at(i), 1e-9);
+	}
+
+	tp.run(m, x, y, std_x, std_y);
+	t.run(m, x, y, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-3);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-3);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(cpu_geos_matches_proj)
+{
+	const size_t SIZE = 10000;
+
+	// points the satellite can see
+	std::vector<double> x(SIZE), y(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 140.7 + 70.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 70.0 * cos(6 * M_PI * i / SIZE) * (0.5 + 0.5 * cos(2 * M_PI * i / SIZE));
+	}
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::geos<ellipsoids::WGS84, double>	geos_type;
+
+	transformer<proj> tp;
+	transformer<full_concurrency_multi_cpu> t;
+
+	for (auto sweep : { projections::sweep_axis::x, projections::sweep_axis::y }) {
+		geos_type g(geos_type::offset_t(0.0, 0.0), 35785831.0, 140.7, sweep);
+		projection<latlong, geos_type> p(latlong(), g);
+
+		tp.run(p, x, y, std_x, std_y);
+		t.run(p, x, y, out_x, out_y);
+
+		for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+			BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-3);
+			BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-3);
+		}
+
+		std::vector<double> back_x(SIZE), back_y(SIZE), proj_x(SIZE), proj_y(SIZE);
+
+		projection<geos_type, latlong> inv(g, latlong());
+		tp.run(inv, std_x, std_y, proj_x, proj_y);
+		t.run(inv, std_x, std_y, back_x, back_y);
+
+		for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+			BOOST_CHECK_SMALL(proj_x.at(i) - back_x.at(i), 1e-9);
+			BOOST_CHECK_SMALL(proj_y.at(i) - back_y.at(i), 1e-9);
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(wgs84_cpu_geocent_matches_proj)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10000;
+	gen_latlong_points(x, y, SIZE);
+
+	std::vector<double> z(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++)
+		z.at(i) = -100.0 + 9000.0 * (0.5 + 0.5 * sin(6 * M_PI * i / SIZE));
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::geocent<ellipsoids::WGS84, double>	geocent;
+
+	projection<latlong, geocent> p = projection<latlong, geocent>(latlong(), geocent());
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), out_z(SIZE),
+		std_x(SIZE), std_y(SIZE), std_z(SIZE);
+
+	transformer<proj> tp;
+	tp.run(p, x, y, z, std_x, std_y, std_z);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, z, out_x, out_y, out_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_z.at(i) - out_z.at(i), 1e-6);
+	}
+
+	projection<geocent, latlong> inv = projection<geocent, latlong>(geocent(), latlong());
+
+	tp.run(inv, std_x, std_y, std_z, x, y, z);
+	t.run(inv, std_x, std_y, std_z, out_x, out_y, out_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(y.at(i) - out_y.at(i), 1e-9);
+		BOOST_CHECK_SMALL(z.at(i) - out_z.at(i), 1e-4);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(cpu_datum_shift_matches_proj)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10000;
+	gen_latlong_points(x, y, SIZE);
+
+	std::vector<double> z(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++)
+		z.at(i) = 2000.0 * sin(6 * M_PI * i / SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	// ED50 to WGS84 (EPSG:1133), towgs84 takes position vector rotations
+	datum_shift<double> ds(ellipsoids::runtime(6378388.0, 297.0),
+			helmert<double>(-81.07, -89.36, -115.75, 0.485, 0.024, 0.413, -0.54,
+				rotation_convention::coordinate_frame),
+			ellipsoids::runtime::of<ellipsoids::WGS84>());
+
+	std::vector<double> out_x(SIZE), out_y(SIZE), out_z(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(ds, x, y, z, out_x, out_y, out_z);
+
+	projPJ pj_in = pj_init_plus("+proj=latlong +ellps=intl "
+			"+towgs84=-81.07,-89.36,-115.75,-0.485,-0.024,-0.413,-0.54"),
+		   pj_out = pj_init_plus("+proj=latlong +datum=WGS84");
+
+	assert(pj_in != NULL);
+	assert(pj_out != NULL);
+
+	std::vector<double> std_x(x), std_y(y), std_z(z);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		std_x.at(i) *= TO_RADIAN;
+		std_y.at(i) *= TO_RADIAN;
+	}
+
+	int error = pj_transform(pj_in, pj_out, SIZE, 1, &std_x[0], &std_y[0], &std_z[0]);
+	BOOST_CHECK_EQUAL(error, 0);
+
+	pj_free(pj_in);
+	pj_free(pj_out);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) * TO_DEGS - out_x.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_y.at(i) * TO_DEGS - out_y.at(i), 1e-9);
+		BOOST_CHECK_SMALL(std_z.at(i) - out_z.at(i), 1e-4);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+// runtime_test.cpp
+// runtime parameterized projection tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+// compile time and runtime ellipsoids have to give the same answers
+template<typename TEllipsoid>
+static void check_runtime_matches_static() {
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::tmerc<TEllipsoid, double>				tmerc_s;
+	typedef projections::tmerc<ellipsoids::runtime, double>		tmerc_r;
+
+	const size_t SIZE = 10000;
+
+	std::vector<double> x, y;
+	gen_circle_points(x, y, 10.0, 30.0, 10.0, 10.0, SIZE);
+
+	tmerc_s ts(typename tmerc_s::offset_t(500000.0, 100.0), 20.0, 12.0, 0.9996);
+	tmerc_r tr(ellipsoids::runtime::of<TEllipsoid>(),
+			typename tmerc_r::offset_t(500000.0, 100.0), 20.0, 12.0, 0.9996);
+
+	std::vector<double> std_x(SIZE), std_y(SIZE), out_x(SIZE), out_y(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(projection<latlong, tmerc_s>(latlong(), ts), x, y, std_x, std_y);
+	t.run(projection<latlong, tmerc_r>(latlong(), tr), x, y, out_x, out_y);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		if (std::isfinite(std_x.at(i))) {
+			BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+			BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+		}
+	}
+
+	std::vector<double> back_x(SIZE), back_y(SIZE);
+	t.run(projection<tmerc_r, latlong>(tr, latlong()), out_x, out_y, back_x, back_y);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		if (std::isfinite(std_x.at(i))) {
+			BOOST_CHECK_SMALL(x.at(i) - back_x.at(i), 1e-6);
+			BOOST_CHECK_SMALL(y.at(i) - back_y.at(i), 1e-6);
+		}
+	}
+}
+
+// grid and batch runs of a runtime tmerc against the transform visited point by point
+static void check_runtime_grid_and_batch(const transform::cartographic::projections::tmerc<
+		transform::cartographic::ellipsoids::runtime, double>& tr,
+		double lon0, double lon1, double lat0, double lat1) {
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong								latlong;
+	typedef projections::tmerc<ellipsoids::runtime, double>		tmerc_r;
+
+	projection<latlong, tmerc_r> p(latlong(), tr);
+
+	std::vector<double> lon, lat, x, y;
+	for (double l = lon0 ; l <= lon1 ; l += 0.25) lon.push_back(l);
+	for (double l = lat1 ; l >= lat0 ; l -= 0.25) lat.push_back(l);
+
+	for (double la : lat) {
+		for (double lo : lon) {
+			x.push_back(lo);
+			y.push_back(la);
+		}
+	}
+
+	std::vector<double> std_x(x.size()), std_y(x.size()), out_x(x.size()), out_y(x.size());
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++)
+		p.op(x.at(i), y.at(i), std_x.at(i), std_y.at(i));
+
+	transformer<cpu> t;
+	t.run_grid(p, lon, lat, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 0.00001);
+	}
+
+	check_batch_matches_op(p, x, y);
+	check_batch_matches_op(projection<tmerc_r, latlong>(tr, latlong()), std_x, std_y);
+}
+
+BOOST_AUTO_TEST_SUITE(runtime_test)
+
+BOOST_AUTO_TEST_CASE(runtime_ellipsoid_constants)
+{
+	using namespace transform::cartographic;
+
+	typedef ellipsoids::WGS84::params wgs84params;
+
+	ellipsoids::runtime e(wgs84params::major_axis, wgs84params::inverse_flattening);
+
+	// copies, the checks take their arguments by reference
+	double ecc2 = wgs84params::ecc2;
+	double en[5] = {
+		wgs84params::en0, wgs84params::en1, wgs84params::en2,
+		wgs84params::en3, wgs84params::en4 };
+
+	BOOST_CHECK_CLOSE(e.ecc2, ecc2, 1e-6);
+	BOOST_CHECK_CLOSE(e.en[0], en[0], 1e-6);
+	BOOST_CHECK_CLOSE(e.en[1], en[1], 1e-6);
+	BOOST_CHECK_CLOSE(e.en[2], en[2], 1e-6);
+	BOOST_CHECK_CLOSE(e.en[3], en[3], 1e-6);
+	BOOST_CHECK_CLOSE(e.en[4], en[4], 1e-4);
+
+	BOOST_CHECK(ellipsoids::runtime(6370997.0, 0.0).spherical());
+	BOOST_CHECK(ellipsoids::runtime::of<ellipsoids::sphere>().spherical());
+}
+
+BOOST_AUTO_TEST_CASE(runtime_wgs84_matches_static)
+{
+	check_runtime_matches_static<transform::cartographic::ellipsoids::WGS84>();
+}
+
+BOOST_AUTO_TEST_CASE(runtime_sphere_matches_static)
+{
+	check_runtime_matches_static<transform::cartographic::ellipsoids::sphere>();
+}
+
+BOOST_AUTO_TEST_CASE(runtime_grid_matches_points)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::tmerc<ellipsoids::runtime, double>		tmerc_r;
+
+	// airy 1830, as used by the british national grid
+	check_runtime_grid_and_batch(tmerc_r(ellipsoids::runtime(6377563.396, 299.3249646),
+			tmerc_r::offset_t(400000.0, -100000.0), 49.0, -2.0, 0.9996012717),
+			-8.0, 2.0, 49.0, 61.0);
+}
+
+BOOST_AUTO_TEST_CASE(runtime_sphere_grid_matches_points)
+{
+	using namespace transform::cartographic;
+
+	typedef projections::tmerc<ellipsoids::runtime, double>		tmerc_r;
+
+	check_runtime_grid_and_batch(tmerc_r(ellipsoids::runtime(6370997.0, 0.0),
+			tmerc_r::offset_t(500000.0, 0.0), 10.0, 15.0, 0.9996),
+			5.0, 25.0, -30.0, 60.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
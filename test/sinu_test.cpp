@@ -0,0 +1,198 @@
+// sinu_test.cpp
+// sinusoidal projection tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(sinu_test)
+
+BOOST_AUTO_TEST_CASE(known_values)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::sinu<ellipsoids::WGS84, double>	sinu_type;
+
+	// from the PROJ test suite (GRS80, which is within a millimeter of WGS84 here)
+	sinu_type s(sinu_type::offset_t(0.0, 0.0), 0.0);
+
+	double x, y, lon, lat;
+	projection<latlong, sinu_type>(latlong(), s).op(2.0, 1.0, x, y);
+
+	BOOST_CHECK_SMALL(x - 222605.299539466, 1e-3);
+	BOOST_CHECK_SMALL(y - 110574.388554153, 1e-3);
+
+	projection<sinu_type, latlong>(s, latlong()).op(x, y, lon, lat);
+
+	BOOST_CHECK_SMALL(lon - 2.0, 1e-9);
+	BOOST_CHECK_SMALL(lat - 1.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(modis_tile_corner)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::sinu<ellipsoids::sphere, double>	sinu_type;
+
+	sinu_type s = projections::modis_sinu<double>();
+
+	// tiles are 1111950.5197 m squares, tile h18v04 starts on the central meridian at the
+	// 50 degree parallel
+	const double tile = 1111950.519667;
+
+	double lon, lat;
+	projection<sinu_type, latlong>(s, latlong()).op(0.0, 5 * tile, lon, lat);
+
+	BOOST_CHECK_SMALL(lon, 1e-9);
+	BOOST_CHECK_SMALL(lat - 50.0, 1e-6);
+
+	projection<sinu_type, latlong>(s, latlong()).op(tile, 5 * tile, lon, lat);
+
+	BOOST_CHECK_SMALL(lon - 10.0 / cos(50.0 * M_PI / 180.0), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(outside_the_world_is_masked)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::sinu<ellipsoids::WGS84, double>	sinu_type;
+
+	sinu_type s(sinu_type::offset_t(0.0, 0.0), 0.0);
+
+	// the corners of the bounding square of the world are off the outline, beyond the
+	// poles is off everything
+	std::vector<double> x = { 19000000.0, -19000000.0, 0.0, 100000.0 },
+		y = { 9000000.0, -9000000.0, 10500000.0, 5000000.0 };
+	std::vector<double> lon(x.size()), lat(x.size());
+
+	transformer<cpu> t;
+	t.run(projection<sinu_type, latlong>(s, latlong()), x, y, lon, lat);
+
+	for (size_t i = 0 ; i < 3 ; i ++) {
+		BOOST_CHECK(std::isinf(lon.at(i)));
+		BOOST_CHECK(std::isinf(lat.at(i)));
+	}
+
+	BOOST_CHECK(std::isfinite(lon.at(3)));
+	BOOST_CHECK(std::isfinite(lat.at(3)));
+}
+
+template<typename TEllipsoid>
+static void check_sinu_round_trip() {
+	typedef transform::cartographic::projections::sinu<TEllipsoid, double> sinu_type;
+
+	// recentred so every point stays within 180 degrees of the central meridian
+	std::vector<double> x, y;
+	gen_circle_points(x, y, 15.0, 0.0, 0.9 * 179.0, 89.0, 10000);
+
+	check_round_trip(sinu_type(typename sinu_type::offset_t(1000.0, -2000.0), 15.0), x, y);
+}
+
+BOOST_AUTO_TEST_CASE(sphere_round_trip)
+{
+	check_sinu_round_trip<transform::cartographic::ellipsoids::sphere>();
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_round_trip)
+{
+	check_sinu_round_trip<transform::cartographic::ellipsoids::WGS84>();
+}
+
+BOOST_AUTO_TEST_CASE(grid_matches_points)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::sinu<ellipsoids::sphere, double>	sinu_type;
+
+	sinu_type s = projections::modis_sinu<double>();
+
+	// a MODIS 1km tile in both directions
+	const size_t COLS = 240, ROWS = 200;
+	const double tile = 1111950.519667, cell = tile / 1200;
+
+	std::vector<double> gx(COLS), gy(ROWS);
+	for (size_t c = 0 ; c < COLS ; c ++) gx.at(c) = -tile + (c * 5 + 0.5) * cell;
+	for (size_t r = 0 ; r < ROWS ; r ++) gy.at(r) = 5 * tile - (r * 6 + 0.5) * cell;
+
+	std::vector<double> x, y;
+	for (size_t r = 0 ; r < ROWS ; r ++) {
+		for (size_t c = 0 ; c < COLS ; c ++) {
+			x.push_back(gx.at(c));
+			y.push_back(gy.at(r));
+		}
+	}
+
+	projection<sinu_type, latlong> inv(s, latlong());
+
+	std::vector<double> out_x(x.size()), out_y(x.size()),
+		std_x(x.size()), std_y(x.size());
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(inv, x, y, std_x, std_y);
+	t.run_grid(inv, gx, gy, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 1e-10);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 1e-10);
+	}
+
+	// and forward over the latlong box the tile covers
+	std::vector<double> lon(COLS), lat(ROWS);
+	for (size_t c = 0 ; c < COLS ; c ++) lon.at(c) = -15.0 + c * 0.1;
+	for (size_t r = 0 ; r < ROWS ; r ++) lat.at(r) = 50.0 - r * 0.05;
+
+	x.clear(); y.clear();
+	for (size_t r = 0 ; r < ROWS ; r ++) {
+		for (size_t c = 0 ; c < COLS ; c ++) {
+			x.push_back(lon.at(c));
+			y.push_back(lat.at(r));
+		}
+	}
+
+	projection<latlong, sinu_type> fwd(latlong(), s);
+
+	t.run(fwd, x, y, std_x, std_y);
+	t.run_grid(fwd, lon, lat, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10001;
+	gen_circle_points(x, y, 0.0, 0.0, 179.0, 89.0, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::sinu<ellipsoids::WGS84, double>	sinu_type;
+
+	projection<latlong, sinu_type> p(latlong(), sinu_type(sinu_type::offset_t(0.0, 0.0), 0.0));
+
+	check_batch_matches_op(p, x, y);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+// span_test.cpp
+// contiguous range detection, spans and staging other ranges
+//
+#include <boost/test/unit_test.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+
+#include "transform.hpp"
+
+#include <array>
+#include <deque>
+#include <list>
+
+using namespace transform;
+
+typedef transforms::projection<cartographic::projections::latlong,
+		cartographic::projections::tmerc<cartographic::ellipsoids::WGS84, double>> forward;
+
+static forward utm33() {
+	return forward(cartographic::projections::latlong(),
+			cartographic::projections::utm<cartographic::ellipsoids::WGS84, double>(33));
+}
+
+// more points than fit in one staging buffer
+static const size_t SIZE = backends::detail::staging_points * 2 + 123;
+
+static void gen_points(std::vector<double>& x, std::vector<double>& y) {
+	x.resize(SIZE);
+	y.resize(SIZE);
+
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		x.at(i) = 15.0 + 3.0 * sin(2 * M_PI * i / SIZE);
+		y.at(i) = 70.0 * cos(2 * M_PI * i / SIZE);
+	}
+}
+
+struct degrees_from_minutes {
+	typedef double result_type;
+	double operator()(double v) const { return v / 60.0; }
+};
+
+BOOST_AUTO_TEST_SUITE(span_test)
+
+BOOST_AUTO_TEST_CASE(contiguous_ranges_are_detected)
+{
+	static_assert(is_contiguous_range<std::vector<double>>::value, "vector");
+	static_assert(is_contiguous_range<const std::vector<double>>::value, "const vector");
+	static_assert(is_contiguous_range<std::array<double, 4>>::value, "array");
+	static_assert(is_contiguous_range<double[4]>::value, "C array");
+	static_assert(is_contiguous_range<span<const double>>::value, "span");
+	static_assert(is_contiguous_range<boost::iterator_range<std::vector<double>::iterator>>::value,
+			"slice of a vector");
+
+	static_assert(!is_contiguous_range<std::deque<double>>::value, "deque");
+	static_assert(!is_contiguous_range<std::list<double>>::value, "list");
+	static_assert(!is_contiguous_range<std::vector<bool>>::value, "vector<bool>");
+
+	std::vector<double> v = { 1.0, 2.0, 3.0 };
+	span<double> s = make_span(&v[0], v.size());
+
+	BOOST_CHECK_EQUAL(boost::size(s), 3);
+	BOOST_CHECK_EQUAL(s[2], 3.0);
+	BOOST_CHECK(span<double>().empty());
+}
+
+BOOST_AUTO_TEST_CASE(pointers_and_lengths_run_like_vectors)
+{
+	std::vector<double> x, y, std_x(SIZE), std_y(SIZE), out_x(SIZE), out_y(SIZE);
+	gen_points(x, y);
+
+	transformer<backends::cpu> tc;
+	tc.run(utm33(), x, y, std_x, std_y);
+
+	transformer<backends::multi_cpu<4>> t;
+	t.run(utm33(), &x[0], &y[0], SIZE, &out_x[0], &out_y[0]);
+
+	BOOST_CHECK(std_x == out_x);
+	BOOST_CHECK(std_y == out_y);
+}
+
+BOOST_AUTO_TEST_CASE(deques_are_staged_through_the_batch_kernels)
+{
+	std::vector<double> x, y, std_x(SIZE), std_y(SIZE);
+	gen_points(x, y);
+
+	transformer<backends::cpu> tc;
+	tc.run(utm33(), x, y, std_x, std_y);
+
+	std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()),
+		out_x(SIZE), out_y(SIZE);
+
+	transformer<backends::multi_cpu<4>> t;
+	t.run(utm33(), dx, dy, out_x, out_y);
+
+	BOOST_CHECK(std::equal(std_x.begin(), std_x.end(), out_x.begin()));
+	BOOST_CHECK(std::equal(std_y.begin(), std_y.end(), out_y.begin()));
+
+	// and in 3D
+	transforms::helmert<double> h(-81.07, -89.36, -115.75, 0.485, 0.024, 0.413, -0.54);
+
+	std::vector<double> z(x), std_z(SIZE);
+	tc.run(h, x, y, z, std_x, std_y, std_z);
+
+	std::deque<double> dz(z.begin(), z.end()), out_z(SIZE);
+	t.run(h, dx, dy, dz, out_x, out_y, out_z);
+
+	BOOST_CHECK(std::equal(std_x.begin(), std_x.end(), out_x.begin()));
+	BOOST_CHECK(std::equal(std_y.begin(), std_y.end(), out_y.begin()));
+	BOOST_CHECK(std::equal(std_z.begin(), std_z.end(), out_z.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(transformed_views_are_staged)
+{
+	std::vector<double> x, y, std_x(SIZE), std_y(SIZE), out_x(SIZE), out_y(SIZE);
+	gen_points(x, y);
+
+	transformer<backends::cpu> tc;
+	tc.run(utm33(), x, y, std_x, std_y);
+
+	std::vector<double> mx(SIZE), my(SIZE);
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		mx.at(i) = x.at(i) * 60.0;
+		my.at(i) = y.at(i) * 60.0;
+	}
+
+	auto vx = mx | boost::adaptors::transformed(degrees_from_minutes()),
+		 vy = my | boost::adaptors::transformed(degrees_from_minutes());
+
+	transformer<backends::multi_cpu<4>> t;
+	t.run(utm33(), vx, vy, out_x, out_y);
+
+	for (size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), 1e-9);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(grids_into_deques)
+{
+	std::vector<double> lon(300), lat(200);
+	for (size_t i = 0 ; i < lon.size() ; i ++)
+		lon.at(i) = 12.0 + 6.0 * i / lon.size();
+	for (size_t i = 0 ; i < lat.size() ; i ++)
+		lat.at(i) = -60.0 + 120.0 * i / lat.size();
+
+	std::vector<double> std_x(lon.size() * lat.size()), std_y(std_x.size());
+	std::deque<double> out_x(std_x.size()), out_y(std_x.size());
+
+	transformer<backends::multi_cpu<4>> t;
+	t.run_grid(utm33(), lon, lat, std_x, std_y);
+	t.run_grid(utm33(), lon, lat, out_x, out_y);
+
+	BOOST_CHECK(std::equal(std_x.begin(), std_x.end(), out_x.begin()));
+	BOOST_CHECK(std::equal(std_y.begin(), std_y.end(), out_y.begin()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
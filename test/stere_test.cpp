@@ -0,0 +1,195 @@
+// stere_test.cpp
+// polar stereographic tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+#include <deque>
+
+static void gen_polar_points(std::vector<double>& x, std::vector<double>& y,
+		double lat0, size_t count) {
+	x.resize(count);
+	y.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = 179.0 * sin(2 * M_PI * i / count);
+		y.at(i) = lat0 + 25.0 * (0.5 + 0.5 * cos(14 * M_PI * i / count));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(stere_test)
+
+// worked examples from the EPSG guidance note 7-2
+//
+BOOST_AUTO_TEST_CASE(epsg_variant_a)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::stere<ellipsoids::WGS84, double>	stere_type;
+
+	stere_type s(stere_type::offset_t(2000000.0, 2000000.0), 90.0, 90.0, 0.0, 0.994);
+
+	double x, y, lon, lat;
+	projection<latlong, stere_type>(latlong(), s).op(44.0, 73.0, x, y);
+
+	BOOST_CHECK_SMALL(x - 3320416.75, 0.01);
+	BOOST_CHECK_SMALL(y - 632668.43, 0.01);
+
+	projection<stere_type, latlong>(s, latlong()).op(x, y, lon, lat);
+
+	BOOST_CHECK_SMALL(lon - 44.0, 1e-9);
+	BOOST_CHECK_SMALL(lat - 73.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(epsg_variant_b)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::stere<ellipsoids::WGS84, double>	stere_type;
+
+	stere_type s(stere_type::offset_t(6000000.0, 6000000.0), -90.0, -71.0, 70.0);
+
+	double x, y, lon, lat;
+	projection<latlong, stere_type>(latlong(), s).op(120.0, -75.0, x, y);
+
+	BOOST_CHECK_SMALL(x - 7255380.79, 0.01);
+	BOOST_CHECK_SMALL(y - 7053389.56, 0.01);
+
+	projection<stere_type, latlong>(s, latlong()).op(x, y, lon, lat);
+
+	BOOST_CHECK_SMALL(lon - 120.0, 1e-9);
+	BOOST_CHECK_SMALL(lat + 75.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(non_polar_origin_throws)
+{
+	using namespace transform::cartographic;
+	typedef projections::stere<ellipsoids::WGS84, double> stere_type;
+
+	BOOST_CHECK_THROW(stere_type(stere_type::offset_t(0.0, 0.0), 45.0, 45.0, 0.0),
+			std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(round_trips)
+{
+	using namespace transform::cartographic;
+	typedef projections::stere<ellipsoids::WGS84, double>	wgs84_stere;
+	typedef projections::stere<ellipsoids::sphere, double>	sphere_stere;
+
+	std::vector<double> x, y;
+
+	gen_polar_points(x, y, 60.0, 10000);
+	check_round_trip(wgs84_stere(wgs84_stere::offset_t(0.0, 0.0), 90.0, 70.0, -45.0), x, y);
+	check_round_trip(sphere_stere(sphere_stere::offset_t(0.0, 0.0), 90.0, 90.0, 0.0, 0.994), x, y);
+
+	gen_polar_points(x, y, -85.0, 10000);
+	check_round_trip(wgs84_stere(wgs84_stere::offset_t(0.0, 0.0), -90.0, -71.0, 0.0), x, y);
+}
+
+BOOST_AUTO_TEST_CASE(batch_and_grid_match_per_point)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::stere<ellipsoids::WGS84, double>	stere_type;
+
+	// a sea ice style grid around the south pole
+	stere_type s(stere_type::offset_t(0.0, 0.0), -90.0, -70.0, 0.0);
+	projection<latlong, stere_type> p(latlong(), s);
+
+	const size_t COLS = 360, ROWS = 90;
+
+	std::vector<double> lon(COLS), lat(ROWS);
+	for (size_t c = 0 ; c < COLS ; c ++) lon.at(c) = -179.5 + c;
+	for (size_t r = 0 ; r < ROWS ; r ++) lat.at(r) = -50.0 - r * 0.5;
+
+	std::vector<double> x, y;
+	for (size_t r = 0 ; r < ROWS ; r ++) {
+		for (size_t c = 0 ; c < COLS ; c ++) {
+			x.push_back(lon.at(c));
+			y.push_back(lat.at(r));
+		}
+	}
+
+	// vectors go straight to the batch and grid kernels and deques through staging buffers,
+	// all are checked against the transform visited point by point
+	std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()),
+		deque_x(x.size()), deque_y(x.size());
+	std::vector<double> std_x(x.size()), std_y(x.size()), out_x(x.size()), out_y(x.size()),
+		grid_x(x.size()), grid_y(x.size());
+
+	for (size_t i = 0, il = x.size() ; i < il ; i ++)
+		p.op(x.at(i), y.at(i), std_x.at(i), std_y.at(i));
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, dx, dy, deque_x, deque_y);
+	t.run(p, x, y, out_x, out_y);
+	t.run_grid(p, lon, lat, grid_x, grid_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(std_x.at(i) - out_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - out_y.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_x.at(i) - deque_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - deque_y.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_x.at(i) - grid_x.at(i), 1e-6);
+		BOOST_CHECK_SMALL(std_y.at(i) - grid_y.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(warp_latlong_to_polar)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::stere<ellipsoids::WGS84, double>	stere_type;
+
+	stere_type s(stere_type::offset_t(0.0, 0.0), 90.0, 70.0, -45.0);
+
+	// a global latlong raster whose values are its latitude, which survives resampling
+	// anywhere away from the wrap around
+	const size_t SRC_W = 720, SRC_H = 360, DST_SIZE = 200;
+
+	raster::geo_transform src_gt(-180.0, 90.0, 0.5, -0.5),
+		dst_gt(-2500000.0, 2500000.0, 25000.0, -25000.0);
+
+	std::vector<float> src_data(SRC_W * SRC_H), dst_data(DST_SIZE * DST_SIZE);
+	for (size_t r = 0 ; r < SRC_H ; r ++)
+		for (size_t c = 0 ; c < SRC_W ; c ++)
+			src_data.at(r * SRC_W + c) = static_cast<float>(src_gt.origin_y + (r + 0.5) * src_gt.pixel_height);
+
+	raster::image<const float> src(&src_data[0], SRC_W, SRC_H, src_gt);
+	raster::image<float> dst(&dst_data[0], DST_SIZE, DST_SIZE, dst_gt);
+
+	warper<full_concurrency_multi_cpu> w(64);
+	w.run(projection<stere_type, latlong>(s, latlong()), src, dst,
+			raster::resampling::bilinear, -9999.0f);
+
+	projection<stere_type, latlong> inv(s, latlong());
+	for (size_t r = 0 ; r < DST_SIZE ; r ++) {
+		for (size_t c = 0 ; c < DST_SIZE ; c ++) {
+			double lon, lat;
+			inv.op(dst_gt.origin_x + (c + 0.5) * dst_gt.pixel_width,
+					dst_gt.origin_y + (r + 0.5) * dst_gt.pixel_height, lon, lat);
+
+			// pixel centres in the source stop half a pixel short of the poles
+			if (lat < 89.75)
+				BOOST_CHECK_SMALL(dst_data.at(r * DST_SIZE + c) - lat, 1e-3);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
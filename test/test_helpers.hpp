@@ -0,0 +1,237 @@
+// test_helpers.hpp
+// point generators, synthetic grids and checks shared by the test suites
+//
+
+#ifndef __transform_test_helpers_hpp__
+#define __transform_test_helpers_hpp__
+
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// count points on an ellipse around lon0, lat0 with the given radii in degrees
+inline void gen_circle_points(std::vector<double>& x, std::vector<double>& y,
+		double lon0, double lat0, double lon_radius, double lat_radius, size_t count) {
+	x.resize(count);
+	y.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = lon0 + lon_radius * sin(2 * M_PI * i / count);
+		y.at(i) = lat0 + lat_radius * cos(2 * M_PI * i / count);
+	}
+}
+
+// the same with heights going z_cycles times around z0 +/- z_amplitude
+inline void gen_circle_height_points(std::vector<double>& x, std::vector<double>& y,
+		std::vector<double>& z, double lon_radius, double lat_radius,
+		double z0, double z_amplitude, unsigned z_cycles, size_t count) {
+	gen_circle_points(x, y, 0.0, 0.0, lon_radius, lat_radius, count);
+	z.resize(count);
+
+	for (size_t i = 0 ; i < count ; i ++)
+		z.at(i) = z0 + z_amplitude * sin(2 * M_PI * z_cycles * i / count);
+}
+
+// project lon, lat with p and back, longitudes are compared modulo 360 since inverses
+// return them within 180 degrees of Greenwich
+template<typename TProjection>
+void check_round_trip(const TProjection& p,
+		const std::vector<double>& lon, const std::vector<double>& lat, double tolerance = 1e-9) {
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong latlong;
+
+	const size_t SIZE = lon.size();
+	std::vector<double> px(SIZE), py(SIZE), back_x(SIZE), back_y(SIZE);
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(projection<latlong, TProjection>(latlong(), p), lon, lat, px, py);
+	t.run(projection<TProjection, latlong>(p, latlong()), px, py, back_x, back_y);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_SMALL(remainder(lon.at(i) - back_x.at(i), 360.0), tolerance);
+		BOOST_CHECK_SMALL(lat.at(i) - back_y.at(i), tolerance);
+	}
+}
+
+// vectors go straight to the batch kernels and deques through staging buffers, both are
+// checked against the transform visited point by point.  tolerance is in percent.
+template<typename TTransform>
+void check_batch_matches_op(const TTransform& p,
+		const std::vector<double>& x, const std::vector<double>& y, double tolerance = 1e-10) {
+	using namespace transform::backends;
+
+	const size_t SIZE = x.size();
+	std::vector<double> out_x(SIZE), out_y(SIZE), std_x(SIZE), std_y(SIZE);
+	std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()),
+		deque_x(SIZE), deque_y(SIZE);
+
+	for (size_t i = 0 ; i < SIZE ; i ++)
+		p.op(x.at(i), y.at(i), std_x.at(i), std_y.at(i));
+
+	transform::transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, out_x, out_y);
+	t.run(p, dx, dy, deque_x, deque_y);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_x.at(i), deque_x.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_y.at(i), deque_y.at(i), tolerance);
+	}
+}
+
+template<typename TTransform>
+void check_batch_matches_op(const TTransform& p, const std::vector<double>& x,
+		const std::vector<double>& y, const std::vector<double>& z, double tolerance = 1e-10) {
+	using namespace transform::backends;
+
+	const size_t SIZE = x.size();
+	std::vector<double> out_x(SIZE), out_y(SIZE), out_z(SIZE), std_x(SIZE), std_y(SIZE), std_z(SIZE);
+	std::deque<double> dx(x.begin(), x.end()), dy(y.begin(), y.end()), dz(z.begin(), z.end()),
+		deque_x(SIZE), deque_y(SIZE), deque_z(SIZE);
+
+	for (size_t i = 0 ; i < SIZE ; i ++)
+		p.op(x.at(i), y.at(i), z.at(i), std_x.at(i), std_y.at(i), std_z.at(i));
+
+	transform::transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, z, out_x, out_y, out_z);
+	t.run(p, dx, dy, dz, deque_x, deque_y, deque_z);
+
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		BOOST_CHECK_CLOSE(std_x.at(i), out_x.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_y.at(i), out_y.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_z.at(i), out_z.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_x.at(i), deque_x.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_y.at(i), deque_y.at(i), tolerance);
+		BOOST_CHECK_CLOSE(std_z.at(i), deque_z.at(i), tolerance);
+	}
+}
+
+// shift fields (arc seconds, longitudes positive west as in NTv2) which are linear, so
+// bilinear interpolation reproduces them up to float storage
+inline double root_lat_shift(double lat_s, double lon_w) { return 1.5 + 1e-5 * lat_s - 2e-5 * lon_w; }
+inline double root_lon_shift(double lat_s, double lon_w) { return -2.0 + 3e-5 * lat_s + 1e-5 * lon_w; }
+inline double child_offset() { return 0.25; }
+
+inline double geoid(double lon, double lat) { return 40.0 + 0.5 * lon - 0.25 * lat; }
+
+// writes values in either byte order
+struct grid_writer {
+	std::vector<unsigned char> bytes;
+	bool big_endian;
+
+	grid_writer(bool big) : big_endian(big) { }
+
+	void raw(uint64_t v, size_t size) {
+		for (size_t i = 0 ; i < size ; i ++) {
+			size_t shift = big_endian ? (size - 1 - i) * 8 : i * 8;
+			bytes.push_back(static_cast<unsigned char>((v >> shift) & 0xff));
+		}
+	}
+
+	void i32(uint32_t v) { raw(v, 4); raw(0, 4); }
+	void f32(float v) { uint32_t u; std::memcpy(&u, &v, 4); raw(u, 4); }
+	void f64(double v) { uint64_t u; std::memcpy(&u, &v, 8); raw(u, 8); }
+
+	void key(const std::string& k) {
+		std::string s = k + std::string(8 - k.size(), ' ');
+		bytes.insert(bytes.end(), s.begin(), s.end());
+	}
+
+	void text(const std::string& k, const std::string& v) { key(k); key(v); }
+
+	void save(const std::string& path) const {
+		std::ofstream f(path.c_str(), std::ios::binary);
+		f.write(reinterpret_cast<const char *>(&bytes[0]), bytes.size());
+	}
+};
+
+inline void add_subgrid(grid_writer& w, const std::string& name, const std::string& parent,
+		double s_lat, double n_lat, double e_lon, double w_lon, double inc, double offset) {
+	size_t rows = static_cast<size_t>((n_lat - s_lat) / inc + 0.5) + 1,
+		   cols = static_cast<size_t>((w_lon - e_lon) / inc + 0.5) + 1;
+
+	w.text("SUB_NAME", name);
+	w.text("PARENT", parent);
+	w.text("CREATED", "");
+	w.text("UPDATED", "");
+	w.key("S_LAT"); w.f64(s_lat);
+	w.key("N_LAT"); w.f64(n_lat);
+	w.key("E_LONG"); w.f64(e_lon);
+	w.key("W_LONG"); w.f64(w_lon);
+	w.key("LAT_INC"); w.f64(inc);
+	w.key("LONG_INC"); w.f64(inc);
+	w.key("GS_COUNT"); w.i32(static_cast<uint32_t>(rows * cols));
+
+	for (size_t r = 0 ; r < rows ; r ++) {
+		for (size_t c = 0 ; c < cols ; c ++) {
+			double lat_s = s_lat + r * inc, lon_w = e_lon + c * inc;
+
+			w.f32(static_cast<float>(root_lat_shift(lat_s, lon_w) + offset));
+			w.f32(static_cast<float>(root_lon_shift(lat_s, lon_w) + offset));
+			w.f32(0.0f);
+			w.f32(0.0f);
+		}
+	}
+}
+
+// a root grid over 10W - 10E, 40N - 50N at half a degree, with a tenth of a degree child
+// over 0 - 2E, 44N - 46N
+inline std::string write_ntv2(const std::string& path, bool big_endian) {
+	grid_writer w(big_endian);
+
+	w.key("NUM_OREC"); w.i32(11);
+	w.key("NUM_SREC"); w.i32(11);
+	w.key("NUM_FILE"); w.i32(2);
+	w.text("GS_TYPE", "SECONDS");
+	w.text("VERSION", "NTv2.0");
+	w.text("SYSTEM_F", "TEST_F");
+	w.text("SYSTEM_T", "TEST_T");
+	w.key("MAJOR_F"); w.f64(6378388.0);
+	w.key("MINOR_F"); w.f64(6356911.946);
+	w.key("MAJOR_T"); w.f64(6378137.0);
+	w.key("MINOR_T"); w.f64(6356752.314);
+
+	add_subgrid(w, "ROOT", "NONE", 40 * 3600., 50 * 3600., -10 * 3600., 10 * 3600., 1800., 0.0);
+	add_subgrid(w, "CHILD", "ROOT", 44 * 3600., 46 * 3600., -2 * 3600., 0., 360., child_offset());
+
+	w.key("END");
+	w.raw(0, 8);
+
+	w.save(path);
+	return path;
+}
+
+// 20W - 20E, 30N - 60N at a quarter of a degree, without data south of 32N
+inline std::string write_gtx(const std::string& path) {
+	grid_writer w(true);
+
+	const size_t rows = 121, cols = 161;
+
+	w.f64(30.0); w.f64(-20.0); w.f64(0.25); w.f64(0.25);
+	w.raw(rows, 4); w.raw(cols, 4);
+
+	for (size_t r = 0 ; r < rows ; r ++) {
+		for (size_t c = 0 ; c < cols ; c ++) {
+			double lat = 30.0 + r * 0.25, lon = -20.0 + c * 0.25;
+			w.f32(lat < 32.0 ? -88.8888f : static_cast<float>(geoid(lon, lat)));
+		}
+	}
+
+	w.save(path);
+	return path;
+}
+
+#endif // __transform_test_helpers_hpp__
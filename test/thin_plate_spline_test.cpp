@@ -0,0 +1,165 @@
+// thin_plate_spline_test.cpp
+// thin-plate spline transform tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+// a wobbly pixel to world mapping for control points to sample
+static void rubber_sheet(double x, double y, double& xo, double& yo) {
+	xo = 440720.0 + 60.0 * x + 0.5 * y + 40.0 * sin(x / 300.0) * cos(y / 250.0);
+	yo = 3751320.0 + 0.25 * x - 60.0 * y + 25.0 * cos(x / 400.0 + y / 350.0);
+}
+
+// control points on a jittered grid over a 2000 x 1500 image
+static void gen_controls(std::vector<double>& sx, std::vector<double>& sy,
+		std::vector<double>& dx, std::vector<double>& dy, size_t side) {
+	for (size_t r = 0 ; r < side ; r ++) {
+		for (size_t c = 0 ; c < side ; c ++) {
+			double x = 2000.0 * (c + 0.3 * sin(7.0 * r + c)) / (side - 1),
+				   y = 1500.0 * (r + 0.3 * cos(5.0 * c + r)) / (side - 1), xo, yo;
+			rubber_sheet(x, y, xo, yo);
+
+			sx.push_back(x);
+			sy.push_back(y);
+			dx.push_back(xo);
+			dy.push_back(yo);
+		}
+	}
+}
+
+// pixel centres of a raster, row by row, step pixels apart
+static void gen_raster(std::vector<double>& x, std::vector<double>& y,
+		size_t cols, size_t rows, double step) {
+	for (size_t r = 0 ; r < rows ; r ++) {
+		for (size_t c = 0 ; c < cols ; c ++) {
+			x.push_back((c + 0.5) * step);
+			y.push_back((r + 0.5) * step);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(thin_plate_spline_test)
+
+BOOST_AUTO_TEST_CASE(passes_through_control_points)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_controls(sx, sy, dx, dy, 12);
+
+	thin_plate_spline<double> tps(sx, sy, dx, dy);
+
+	std::vector<double> out_x(sx.size()), out_y(sx.size());
+
+	transformer<cpu> t;
+	t.run(tps, sx, sy, out_x, out_y);
+
+	for (size_t i = 0 ; i < sx.size() ; i ++) {
+		BOOST_CHECK_SMALL(out_x.at(i) - dx.at(i), 1e-6);
+		BOOST_CHECK_SMALL(out_y.at(i) - dy.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(reproduces_affine_mappings)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	affine<double> gt(440720.0, 60.0, 0.5, 3751320.0, 0.25, -60.0);
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_controls(sx, sy, dx, dy, 5);
+
+	transformer<cpu> t;
+	t.run(gt, sx, sy, dx, dy);
+
+	// an affine mapping has no bending energy, so the spline is exactly that mapping
+	thin_plate_spline<double> tps(sx, sy, dx, dy);
+
+	std::vector<double> x, y;
+	gen_raster(x, y, 40, 30, 50.0);
+
+	std::vector<double> px(x.size()), py(x.size()), ax(x.size()), ay(x.size());
+	t.run(tps, x, y, px, py);
+	t.run(gt, x, y, ax, ay);
+
+	for (size_t i = 0 ; i < x.size() ; i ++) {
+		BOOST_CHECK_SMALL(px.at(i) - ax.at(i), 1e-6);
+		BOOST_CHECK_SMALL(py.at(i) - ay.at(i), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(tiled_evaluation_within_error_bound)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_controls(sx, sy, dx, dy, 30);
+
+	const double max_error = 0.01;
+	thin_plate_spline<double> exact(sx, sy, dx, dy),
+		fast(sx, sy, dx, dy, max_error);
+
+	// every pixel of a corner of the image, the dense case tiling is for
+	std::vector<double> x, y;
+	gen_raster(x, y, 300, 200, 1.0);
+
+	std::vector<double> ex(x.size()), ey(x.size()), fx(x.size()), fy(x.size());
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(exact, x, y, ex, ey);
+	t.run(fast, x, y, fx, fy);
+
+	double worst = 0.;
+	for (size_t i = 0 ; i < x.size() ; i ++)
+		worst = std::max(worst, std::abs(ex.at(i) - fx.at(i)) + std::abs(ey.at(i) - fy.at(i)));
+
+	BOOST_CHECK(worst <= max_error);
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	using namespace transform::transforms;
+
+	std::vector<double> sx, sy, dx, dy;
+	gen_controls(sx, sy, dx, dy, 10);
+
+	thin_plate_spline<double> tps(sx, sy, dx, dy, 0., 1e-3);
+
+	std::vector<double> x, y;
+	gen_raster(x, y, 101, 99, 20.0);
+
+	check_batch_matches_op(tps, x, y);
+}
+
+BOOST_AUTO_TEST_CASE(bad_control_points_throw)
+{
+	using namespace transform::transforms;
+
+	std::vector<double> sx = { 0.0, 1.0, 2.0, 3.0 }, sy = { 0.0, 1.0, 2.0, 3.0 },
+		dx = { 0.0, 1.0, 2.0, 3.0 }, dy = { 5.0, 6.0, 7.0, 8.0 };
+
+	// collinear
+	BOOST_CHECK_THROW(thin_plate_spline<double>(sx, sy, dx, dy), std::invalid_argument);
+
+	// duplicated
+	sx = { 0.0, 1.0, 0.0, 0.0 };
+	sy = { 0.0, 0.0, 1.0, 0.0 };
+	BOOST_CHECK_THROW(thin_plate_spline<double>(sx, sy, dx, dy), std::invalid_argument);
+
+	// too few and mismatched
+	std::vector<double> two = { 0.0, 1.0 };
+	BOOST_CHECK_THROW(thin_plate_spline<double>(two, two, two, two), std::invalid_argument);
+
+	dy.pop_back();
+	BOOST_CHECK_THROW(thin_plate_spline<double>(sx, sy, dx, dy), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
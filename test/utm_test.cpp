@@ -0,0 +1,154 @@
+// utm_test.cpp
+// tmerc parameters and zone bucketed UTM tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+#include <cstdlib>
+#include <limits>
+
+static void gen_global_points(std::vector<double>& x, std::vector<double>& y,
+		size_t count) {
+	x.resize(count);
+	y.resize(count);
+
+	std::srand(42);
+	for (size_t i = 0 ; i < count ; i ++) {
+		x.at(i) = -180.0 + 360.0 * std::rand() / RAND_MAX;
+		y.at(i) = -80.0 + 164.0 * std::rand() / RAND_MAX;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(utm_test)
+
+BOOST_AUTO_TEST_CASE(utm_zones)
+{
+	using transform::cartographic::projections::utm_zone;
+
+	BOOST_CHECK_EQUAL(utm_zone(-180.0, 0.0), 1);
+	BOOST_CHECK_EQUAL(utm_zone(-177.0, 0.0), 1);
+	BOOST_CHECK_EQUAL(utm_zone(-174.0, 0.0), 2);
+	BOOST_CHECK_EQUAL(utm_zone(0.0, 0.0), 31);
+	BOOST_CHECK_EQUAL(utm_zone(179.9, 0.0), 60);
+	BOOST_CHECK_EQUAL(utm_zone(180.0, 0.0), 60);
+
+	// norway and svalbard
+	BOOST_CHECK_EQUAL(utm_zone(4.0, 60.0), 32);
+	BOOST_CHECK_EQUAL(utm_zone(4.0, 50.0), 31);
+	BOOST_CHECK_EQUAL(utm_zone(10.0, 78.0), 33);
+	BOOST_CHECK_EQUAL(utm_zone(40.0, 78.0), 37);
+
+	// no zone
+	BOOST_CHECK_EQUAL(utm_zone(180.5, 0.0), 0);
+	BOOST_CHECK_EQUAL(utm_zone(-1e300, 0.0), 0);
+	BOOST_CHECK_EQUAL(utm_zone(std::numeric_limits<double>::quiet_NaN(), 0.0), 0);
+	BOOST_CHECK_EQUAL(utm_zone(HUGE_VAL, 0.0), 0);
+	BOOST_CHECK_EQUAL(utm_zone(10.0, std::numeric_limits<double>::quiet_NaN()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(wgs84_tmerc_round_trips_with_origin)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	tmerc;
+
+	tmerc tm(tmerc::offset_t(400000.0, -100000.0), 49.0, -2.0, 0.9996012717);
+
+	std::vector<double> x, y;
+	for (double lon = -6.0 ; lon <= 2.0 ; lon += 0.5) {
+		for (double lat = 49.0 ; lat <= 61.0 ; lat += 0.5) {
+			x.push_back(lon);
+			y.push_back(lat);
+		}
+	}
+
+	std::vector<double> px(x.size()), py(x.size()), out_x(x.size()), out_y(x.size());
+
+	transformer<cpu> t;
+	t.run(projection<latlong, tmerc>(latlong(), tm), x, y, px, py);
+	t.run(projection<tmerc, latlong>(tm, latlong()), px, py, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_SMALL(x.at(i) - out_x.at(i), 1e-8);
+		BOOST_CHECK_SMALL(y.at(i) - out_y.at(i), 1e-8);
+	}
+
+	// the origin maps onto the false easting and northing
+	std::vector<double> ox(1, -2.0), oy(1, 49.0), rx(1), ry(1);
+	t.run(projection<latlong, tmerc>(latlong(), tm), ox, oy, rx, ry);
+
+	BOOST_CHECK_SMALL(rx.at(0) - 400000.0, 1e-6);
+	BOOST_CHECK_SMALL(ry.at(0) + 100000.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(zone_bucketed_matches_per_zone)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							latlong;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	tmerc;
+
+	const size_t SIZE = 10000;
+
+	std::vector<double> x, y;
+	gen_global_points(x, y, SIZE);
+
+	std::vector<double> out_x(SIZE), out_y(SIZE);
+	std::vector<int> zones(SIZE);
+
+	utm_transformer<full_concurrency_multi_cpu> ut;
+	ut.run<ellipsoids::WGS84>(x, y, out_x, out_y, zones);
+
+	transformer<cpu> t;
+	for(size_t i = 0 ; i < SIZE ; i ++) {
+		int zone = projections::utm_zone(x.at(i), y.at(i));
+		bool south = y.at(i) < 0.0;
+
+		BOOST_CHECK_EQUAL(zones.at(i), south ? -zone : zone);
+
+		std::vector<double> px(1, x.at(i)), py(1, y.at(i)), std_x(1), std_y(1);
+		t.run(projection<latlong, tmerc>(latlong(),
+					projections::utm<ellipsoids::WGS84, double>(zone, south)),
+				px, py, std_x, std_y);
+
+		BOOST_CHECK_CLOSE(std_x.at(0), out_x.at(i), 0.00001);
+		BOOST_CHECK_CLOSE(std_y.at(0), out_y.at(i), 0.00001);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(points_without_a_zone_come_out_infinite)
+{
+	using namespace transform;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+
+	std::vector<double> x = { 15.0, nan, 1e300, 15.0, -200.0, -75.0 },
+		y = { 45.0, 45.0, 45.0, nan, -10.0, -10.0 };
+	std::vector<double> out_x(x.size()), out_y(x.size());
+	std::vector<int> zones(x.size());
+
+	utm_transformer<cpu> ut;
+	ut.run<ellipsoids::WGS84>(x, y, out_x, out_y, zones);
+
+	for (size_t i = 1 ; i < 5 ; i ++) {
+		BOOST_CHECK_EQUAL(zones.at(i), 0);
+		BOOST_CHECK_EQUAL(out_x.at(i), HUGE_VAL);
+		BOOST_CHECK_EQUAL(out_y.at(i), HUGE_VAL);
+	}
+
+	BOOST_CHECK_EQUAL(zones.at(0), 33);
+	BOOST_CHECK_EQUAL(zones.at(5), -18);
+	BOOST_CHECK(std::isfinite(out_x.at(0)) && std::isfinite(out_x.at(5)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
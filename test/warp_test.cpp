@@ -0,0 +1,148 @@
+// warp_test.cpp
+// raster warp tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+
+// a latlong raster whose values are a linear function of the location, which bilinear
+// resampling reproduces exactly
+static double latlong_value(double lon, double lat) {
+	return 10.0 * lon + lat;
+}
+
+static void gen_latlong_image(std::vector<float>& data,
+		size_t width, size_t height, const transform::raster::geo_transform& gt) {
+	data.resize(width * height);
+
+	for (size_t r = 0 ; r < height ; r ++) {
+		for (size_t c = 0 ; c < width ; c ++) {
+			double lon = gt.origin_x + (c + 0.5) * gt.pixel_width,
+				   lat = gt.origin_y + (r + 0.5) * gt.pixel_height;
+
+			data.at(r * width + c) = static_cast<float>(latlong_value(lon, lat));
+		}
+	}
+}
+
+template<typename TBackend>
+static void warp_to_tmerc(transform::raster::resampling method, double max_error,
+		std::vector<float>& out, std::vector<double>& lon, std::vector<double>& lat) {
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong							projection_to;
+	typedef projections::tmerc<ellipsoids::WGS84, double>	projection_from;
+
+	const size_t SRC_SIZE = 400, DST_SIZE = 300;
+
+	raster::geo_transform src_gt(-2.0, 42.0, 0.01, -0.01),
+		dst_gt(-150000.0, 4650000.0, 1000.0, -1000.0);
+
+	std::vector<float> src_data;
+	gen_latlong_image(src_data, SRC_SIZE, SRC_SIZE, src_gt);
+
+	out.assign(DST_SIZE * DST_SIZE, 0.0f);
+
+	raster::image<const float> src(&src_data[0], SRC_SIZE, SRC_SIZE, src_gt);
+	raster::image<float> dst(&out[0], DST_SIZE, DST_SIZE, dst_gt);
+
+	projection<projection_from, projection_to> p(
+			projection_from(projection_from::offset_t(0.0, 0.0)),
+			projection_to());
+
+	warper<TBackend> w(64, max_error);
+	w.run(p, src, dst, method, -9999.0f);
+
+	// where each destination pixel centre should have come from
+	std::vector<double> x(out.size()), y(out.size());
+	for (size_t r = 0 ; r < DST_SIZE ; r ++) {
+		for (size_t c = 0 ; c < DST_SIZE ; c ++) {
+			x.at(r * DST_SIZE + c) = dst_gt.origin_x + (c + 0.5) * dst_gt.pixel_width;
+			y.at(r * DST_SIZE + c) = dst_gt.origin_y + (r + 0.5) * dst_gt.pixel_height;
+		}
+	}
+
+	lon.resize(out.size());
+	lat.resize(out.size());
+
+	transformer<cpu> t;
+	t.run(p, x, y, lon, lat);
+}
+
+// pixel centres of the source cover lon [-1.995, 1.995], lat [38.005, 41.995]
+static bool inside_source(double lon, double lat) {
+	return lon > -1.99 && lon < 1.99 && lat > 38.01 && lat < 41.99;
+}
+
+static bool outside_source(double lon, double lat) {
+	return lon < -2.0 || lon > 2.0 || lat < 38.0 || lat > 42.0;
+}
+
+BOOST_AUTO_TEST_SUITE(warp_test)
+
+BOOST_AUTO_TEST_CASE(bilinear_warp_to_tmerc)
+{
+	using namespace transform::backends;
+
+	std::vector<float> out;
+	std::vector<double> lon, lat;
+
+	warp_to_tmerc<full_concurrency_multi_cpu>(
+			transform::raster::resampling::bilinear, 0.0, out, lon, lat);
+
+	size_t checked = 0;
+	for (size_t i = 0, il = out.size() ; i < il ; i ++) {
+		if (inside_source(lon.at(i), lat.at(i))) {
+			BOOST_CHECK_CLOSE(latlong_value(lon.at(i), lat.at(i)), out.at(i), 0.001);
+			checked ++;
+		}
+		else if (outside_source(lon.at(i), lat.at(i))) {
+			BOOST_CHECK_EQUAL(out.at(i), -9999.0f);
+		}
+	}
+
+	BOOST_CHECK_GT(checked, out.size() / 2);
+}
+
+BOOST_AUTO_TEST_CASE(nearest_warp_to_tmerc)
+{
+	using namespace transform::backends;
+
+	std::vector<float> out;
+	std::vector<double> lon, lat;
+
+	warp_to_tmerc<cpu>(
+			transform::raster::resampling::nearest, 0.0, out, lon, lat);
+
+	for (size_t i = 0, il = out.size() ; i < il ; i ++) {
+		if (inside_source(lon.at(i), lat.at(i))) {
+			// at most half a pixel off in each direction
+			BOOST_CHECK_LE(std::abs(latlong_value(lon.at(i), lat.at(i)) - out.at(i)),
+					10.0 * 0.005 + 0.005 + 1e-4);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(approximate_warp_to_tmerc)
+{
+	using namespace transform::backends;
+
+	std::vector<float> exact, approx;
+	std::vector<double> lon, lat;
+
+	warp_to_tmerc<full_concurrency_multi_cpu>(
+			transform::raster::resampling::bilinear, 0.0, exact, lon, lat);
+	warp_to_tmerc<full_concurrency_multi_cpu>(
+			transform::raster::resampling::bilinear, 1e-5, approx, lon, lat);
+
+	for (size_t i = 0, il = exact.size() ; i < il ; i ++) {
+		if (inside_source(lon.at(i), lat.at(i))) {
+			BOOST_CHECK_CLOSE(exact.at(i), approx.at(i), 0.001);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
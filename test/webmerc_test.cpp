@@ -0,0 +1,140 @@
+// webmerc_test.cpp
+// web mercator tests
+//
+#include <boost/test/unit_test.hpp>
+
+#include "transform.hpp"
+#include "test_helpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(webmerc_test)
+
+BOOST_AUTO_TEST_CASE(known_values)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	latlong;
+	typedef projections::webmerc	webmerc;
+
+	// the corners of the web map square, the origin and 45 degrees north
+	std::vector<double> x = { 180.0, -180.0, 0.0, 0.0 },
+		y = { 85.051128779806589, -85.051128779806589, 0.0, 45.0 };
+	std::vector<double> out_x(x.size()), out_y(x.size());
+
+	transformer<cpu> t;
+	t.run(projection<latlong, webmerc>(latlong(), webmerc()), x, y, out_x, out_y);
+
+	BOOST_CHECK_CLOSE(out_x.at(0), 20037508.342789244, 1e-9);
+	BOOST_CHECK_CLOSE(out_y.at(0), 20037508.342789244, 1e-9);
+	BOOST_CHECK_CLOSE(out_x.at(1), -20037508.342789244, 1e-9);
+	BOOST_CHECK_CLOSE(out_y.at(1), -20037508.342789244, 1e-9);
+	BOOST_CHECK_SMALL(out_x.at(2), 1e-9);
+	BOOST_CHECK_SMALL(out_y.at(2), 1e-9);
+	BOOST_CHECK_CLOSE(out_y.at(3), 5621521.486192066, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+	std::vector<double> x, y;
+	gen_circle_points(x, y, 0.0, 0.0, 179.0, 85.0, 10000);
+
+	check_round_trip(transform::cartographic::projections::webmerc(), x, y);
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_per_point)
+{
+	std::vector<double> x, y;
+
+	const size_t SIZE = 10001;
+	gen_circle_points(x, y, 0.0, 0.0, 179.0, 85.0, SIZE);
+
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	latlong;
+	typedef projections::webmerc	webmerc;
+
+	projection<latlong, webmerc> p = projection<latlong, webmerc>(latlong(), webmerc());
+
+	check_batch_matches_op(p, x, y);
+}
+
+BOOST_AUTO_TEST_CASE(grid_matches_points)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::backends;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	latlong;
+	typedef projections::webmerc	webmerc;
+
+	const size_t COLS = 300, ROWS = 200;
+
+	std::vector<double> lon(COLS), lat(ROWS);
+	for (size_t c = 0 ; c < COLS ; c ++) lon.at(c) = -179.5 + c * 1.2;
+	for (size_t r = 0 ; r < ROWS ; r ++) lat.at(r) = 84.0 - r * 0.84;
+
+	// and the poles, where both coordinates are masked
+	lat.front() = 90.0;
+	lat.back() = -90.0;
+
+	std::vector<double> x, y;
+	for (size_t r = 0 ; r < ROWS ; r ++) {
+		for (size_t c = 0 ; c < COLS ; c ++) {
+			x.push_back(lon.at(c));
+			y.push_back(lat.at(r));
+		}
+	}
+
+	projection<latlong, webmerc> p = projection<latlong, webmerc>(latlong(), webmerc());
+
+	std::vector<double> out_x(x.size()), out_y(x.size()),
+		std_x(x.size()), std_y(x.size());
+
+	transformer<full_concurrency_multi_cpu> t;
+	t.run(p, x, y, std_x, std_y);
+	t.run_grid(p, lon, lat, out_x, out_y);
+
+	for(size_t i = 0, il = x.size() ; i < il ; i ++) {
+		BOOST_CHECK_EQUAL(std_x.at(i), out_x.at(i));
+		BOOST_CHECK_EQUAL(std_y.at(i), out_y.at(i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(poles_and_wrapped_longitudes)
+{
+	using namespace transform;
+	using namespace transform::transforms;
+	using namespace transform::cartographic;
+
+	typedef projections::latlong	latlong;
+	typedef projections::webmerc	webmerc;
+
+	projection<latlong, webmerc> p = projection<latlong, webmerc>(latlong(), webmerc());
+	projection<webmerc, latlong> q = projection<webmerc, latlong>(webmerc(), latlong());
+
+	const double lats[] = { 90.0, -90.0, 91.0 };
+	for (double lat : lats) {
+		double x, y;
+		p.op(10.0, lat, x, y);
+
+		BOOST_CHECK_EQUAL(x, HUGE_VAL);
+		BOOST_CHECK_EQUAL(y, HUGE_VAL);
+	}
+
+	// x past the antimeridian comes back as a longitude in [-180, 180]
+	const double half = 20037508.342789244;
+
+	double lon, lat;
+	q.op(half + half / 18.0, 0.0, lon, lat);
+
+	BOOST_CHECK_CLOSE(lon, -170.0, 1e-9);
+	BOOST_CHECK_SMALL(lat, 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()